@@ -15,21 +15,34 @@ const MODULES_DIR = './modules';
 // Module loading order (critical for dependencies)
 const MODULE_ORDER = [
   'config.js', // Configuration must be loaded first
+  'modules/utils/Logger.js',
   'modules/utils/PerformanceProfiler.js',
+  'modules/utils/MatPool.js',
   'modules/utils/DebugExporter.js',
+  'modules/cache/VocabularyCodec.js',
+  'modules/cache/AlbumContentCache.js',
   'modules/cache/CacheManager.js',
   'modules/utils/AlbumManager.js',
   'modules/utils/ProgressManager.js',
   'modules/database/DatabaseLoader.js',
   'modules/database/VocabularyBuilder.js',
+  'modules/workers/VocabularyWorkerPool.js',
+  'modules/database/FlatVocabularyTree.js',
   'modules/database/VocabularyTreeQuery.js',
+  'modules/database/ZipArchiveReader.js',
   'modules/database/ZipDatabaseLoader.js',
   'modules/ui/UIManager.js',
   'modules/ui/OfflineManager.js',
   'modules/camera/CameraManager.js',
+  'modules/camera/FrameScheduler.js',
+  'modules/reference/ReferenceCache.js',
   'modules/reference/ReferenceImageManager.js',
+  'modules/detection/BatchedMatcher.js',
   'modules/detection/FeatureDetector.js',
   'modules/tracking/OpticalFlowTracker.js',
+  'modules/core/TrackingPipeline.js',
+  'modules/core/QualityGovernor.js',
+  'modules/workers/VisionWorkerClient.js',
   'modules/visualization/Visualizer.js',
   'modules/rendering/VideoManager.js',
   'modules/rendering/VideoARRenderer.js',
@@ -38,6 +51,33 @@ const MODULE_ORDER = [
   'modules/core/ImageTracker.js'
 ];
 
+// Vision worker bundle (runs detection/tracking off the main thread)
+const WORKER_MODULE_ORDER = [
+  'config.js',
+  'modules/utils/Logger.js',
+  'modules/utils/PerformanceProfiler.js',
+  'modules/utils/MatPool.js',
+  'modules/database/FlatVocabularyTree.js',
+  'modules/database/VocabularyTreeQuery.js',
+  'modules/reference/ReferenceCache.js',
+  'modules/reference/ReferenceImageManager.js',
+  'modules/detection/BatchedMatcher.js',
+  'modules/detection/FeatureDetector.js',
+  'modules/tracking/OpticalFlowTracker.js',
+  'modules/core/TrackingPipeline.js',
+  'modules/workers/VisionWorkerClient.js', // Spawns the background detection worker
+  'modules/workers/VisionWorker.js' // Worker entry point must be last
+];
+const WORKER_BUNDLE_PATH = 'modules/workers/VisionWorker.js';
+
+// Vocabulary build pool worker (feature extraction + k-means assignment)
+const VOCABULARY_WORKER_MODULE_ORDER = [
+  'config.js',
+  'modules/database/VocabularyBuilder.js',
+  'modules/workers/VocabularyWorker.js' // Worker entry point must be last
+];
+const VOCABULARY_WORKER_BUNDLE_PATH = 'modules/workers/VocabularyWorker.js';
+
 // Ultra-performance obfuscation options
 const ULTRA_OBFUSCATION_OPTIONS = {
   // Core settings
@@ -95,17 +135,183 @@ function optimizeCode(content) {
     .trim();
 }
 
+/**
+ * Remove debug-level logging from production bundles
+ *
+ * Drops `if (Logger.debugEnabled) { ... }` blocks (the log and the statistics
+ * that only feed it) and bare `Logger.debug(...);` statements. Braces and
+ * parens are matched with a scanner that skips strings, template literals,
+ * comments and regex literals, so only whole statements are removed.
+ *
+ * A statement whose removal would change the code around it fails the
+ * build instead: a guarded block followed by `else`, or either form used as
+ * the body of an `else` or of a braceless if/for/while.
+ */
+function stripDebugLogging(content, file = 'bundle') {
+  const patterns = [
+    { re: /if\s*\(\s*Logger\.debugEnabled\s*\)\s*\{/g, open: '{', close: '}' },
+    { re: /Logger\.debug\s*\(/g, open: '(', close: ')' }
+  ];
+
+  for (const { re, open, close } of patterns) {
+    let result = '';
+    let cursor = 0; // Copied up to here
+    let scanned = 0; // Scanned for literals up to here
+    let match;
+    re.lastIndex = 0;
+
+    while ((match = re.exec(content)) !== null) {
+      // Skip matches inside strings / comments
+      while (scanned < match.index) {
+        const skip = skipLiteral(content, scanned);
+        scanned = skip > scanned ? skip : scanned + 1;
+      }
+      if (scanned > match.index) continue;
+
+      const end = findClosing(content, match.index + match[0].length, open, close);
+      if (end < 0) break;
+
+      let stop = end + 1;
+      if (open === '(') {
+        // Bare statement only: must be followed by `;`
+        const rest = content.slice(stop).match(/^\s*;/);
+        if (!rest) continue;
+        stop += rest[0].length;
+      }
+
+      // Removing the body of an if/else, or an if with an else branch,
+      // would leave a dangling `else` or hand the next statement to the branch
+      const before = content.slice(Math.max(0, match.index - 16), match.index);
+      const followedByElse = open === '{' && /^else\b/.test(content.slice(skipSpace(content, stop)));
+      if (/(?:\belse|\))\s*$/.test(before) || followedByElse) {
+        const line = content.slice(0, match.index).split('\n').length;
+        throw new Error(`${file}:${line}: cannot strip ${match[0].trim()} here - ` +
+          'debug logging must be a statement of its own, without else branches');
+      }
+
+      result += content.slice(cursor, match.index);
+      cursor = stop;
+      scanned = stop;
+      re.lastIndex = stop;
+    }
+
+    content = result + content.slice(cursor);
+  }
+
+  return content;
+}
+
+/**
+ * Index of the first character from `i` on that is not whitespace or a
+ * comment
+ * @private
+ */
+function skipSpace(content, i) {
+  while (i < content.length) {
+    if (/\s/.test(content[i])) {
+      i++;
+    } else if (content[i] === '/' && (content[i + 1] === '/' || content[i + 1] === '*')) {
+      i = skipLiteral(content, i);
+    } else {
+      break;
+    }
+  }
+  return i;
+}
+
+/**
+ * Index of the bracket closing one opened just before `start`, or -1
+ * @private
+ */
+function findClosing(content, start, open, close) {
+  let depth = 1;
+  let i = start;
+  while (i < content.length) {
+    const skip = skipLiteral(content, i);
+    if (skip > i) {
+      i = skip;
+      continue;
+    }
+    const c = content[i];
+    if (c === open) depth++;
+    else if (c === close && --depth === 0) return i;
+    i++;
+  }
+  return -1;
+}
+
+/**
+ * End of the string, template, comment or regex literal starting at `i`,
+ * or `i` if none starts there
+ * @private
+ */
+function skipLiteral(content, i) {
+  const c = content[i];
+  const next = content[i + 1];
+
+  if (c === '/' && next === '/') {
+    const end = content.indexOf('\n', i);
+    return end < 0 ? content.length : end;
+  }
+  if (c === '/' && next === '*') {
+    const end = content.indexOf('*/', i + 2);
+    return end < 0 ? content.length : end + 2;
+  }
+  if (c === '"' || c === "'") {
+    let j = i + 1;
+    while (j < content.length && content[j] !== c && content[j] !== '\n') {
+      j += content[j] === '\\' ? 2 : 1;
+    }
+    return j + 1;
+  }
+  if (c === '`') {
+    let j = i + 1;
+    while (j < content.length && content[j] !== '`') {
+      if (content[j] === '\\') {
+        j += 2;
+      } else if (content[j] === '$' && content[j + 1] === '{') {
+        j = findClosing(content, j + 2, '{', '}') + 1;
+        if (j === 0) return content.length;
+      } else {
+        j++;
+      }
+    }
+    return j + 1;
+  }
+  if (c === '/') {
+    // Regex literal if the previous token cannot end an expression
+    let k = i - 1;
+    while (k >= 0 && /\s/.test(content[k])) k--;
+    if (k < 0 || /[(,=:[!&|?{};+\-*%<>~^]/.test(content[k])) {
+      let j = i + 1;
+      let inClass = false;
+      while (j < content.length && content[j] !== '\n') {
+        const d = content[j];
+        if (d === '\\') {
+          j += 2;
+          continue;
+        }
+        if (d === '[') inClass = true;
+        else if (d === ']') inClass = false;
+        else if (d === '/' && !inClass) return j + 1;
+        j++;
+      }
+    }
+  }
+  return i;
+}
+
 /**
  * Read and concatenate all modules with optimizations
  */
-async function bundleModules() {
+async function bundleModules(moduleOrder = MODULE_ORDER) {
   console.log('Bundling modules with ultra-optimization...');
   
   let bundleContent = '';
   const moduleContents = [];
   
   // Read all modules in order
-  for (const modulePath of MODULE_ORDER) {
+  for (const modulePath of moduleOrder) {
     const fullPath = path.join(SOURCE_DIR, modulePath);
     
     if (await fs.pathExists(fullPath)) {
@@ -113,6 +319,7 @@ async function bundleModules() {
       let content = await fs.readFile(fullPath, 'utf8');
       
       // Apply code optimizations
+      content = stripDebugLogging(content, modulePath);
       content = optimizeCode(content);
       
       moduleContents.push({
@@ -176,6 +383,12 @@ async function copyStaticFiles() {
     console.log('Copied and optimized: styles.css');
   }
 
+  // Service worker must sit at the site root to control the page
+  if (await fs.pathExists('./sw.js')) {
+    await fs.copy('./sw.js', path.join(BUILD_DIR, 'sw.js'));
+    console.log('Copied: sw.js');
+  }
+
   // Copy JSON files
   if (await fs.pathExists('./target_database.json')) {
     await fs.copy('./target_database.json',
@@ -257,6 +470,27 @@ async function build() {
     const sizeKB = Math.round(obfuscatedBundle.length / 1024);
     console.log(`Created: webar-bundle.js (${sizeKB}KB)`);
 
+    // Bundle the workers (dependencies inlined, so they skip importScripts)
+    const workerBundles = [
+      { name: 'vision worker', modules: WORKER_MODULE_ORDER, output: WORKER_BUNDLE_PATH },
+      { name: 'vocabulary worker', modules: VOCABULARY_WORKER_MODULE_ORDER, output: VOCABULARY_WORKER_BUNDLE_PATH }
+    ];
+    for (const { name, modules, output } of workerBundles) {
+      console.log(`\nBundling ${name}...`);
+      const workerBundle = await bundleModules(modules);
+      let obfuscatedWorker;
+      try {
+        obfuscatedWorker = JavaScriptObfuscator.obfuscate(workerBundle, ULTRA_OBFUSCATION_OPTIONS).getObfuscatedCode();
+      } catch (error) {
+        console.error('Worker obfuscation failed:', error.message);
+        obfuscatedWorker = workerBundle;
+      }
+      const workerPath = path.join(BUILD_DIR, output);
+      await fs.ensureDir(path.dirname(workerPath));
+      await fs.writeFile(workerPath, obfuscatedWorker);
+      console.log(`Created: ${output} (${Math.round(obfuscatedWorker.length / 1024)}KB)`);
+    }
+
     // Copy and optimize static files
     console.log('\nCopying and optimizing static files...');
     await copyStaticFiles();
@@ -15,6 +15,7 @@ const AppConfig = {
     size: 512
   },
   targetPreprocessing: {
+    maxDimension: 1280, // Target photos are decoded at most this large (longer side)
     useCLAHE: true,
     useBlur: true,
     blurKernelSize: 3,
@@ -32,7 +33,19 @@ const AppConfig = {
     ratioThreshold: 0.75,
     distanceThresholdMultiplier: 3,
     minMatchesForHomography: 4,
-    detectionInterval: 30
+    detectionInterval: 30,
+    // Frame keypoints: 0 keeps ORB's native strongest-N; N > 0 detects
+    // keypointOversample times more and spreads the budget over an N x N grid
+    keypointGrid: 0,
+    keypointOversample: 1.5,
+    // Quality-driven re-detection of a tracked target searches only its
+    // predicted quad grown by roiMargin, with at least roiMinFeatures
+    roiRedetection: true,
+    roiMargin: 0.2,
+    roiMinFeatures: 1000,
+    // Run detection in a background worker while optical flow keeps tracking;
+    // results are propagated to the current frame before they replace corners
+    pipelined: true
   },
   opticalFlow: {
     winSize: { width: 21, height: 21 },
@@ -56,7 +69,10 @@ const AppConfig = {
     minInliersStrict: 25,
     maxFlowMagnitude: 150,
     featureRefreshInterval: 10,
-    spatialGridSize: 4
+    minPersistentPoints: 40, // Re-seed flow points below this many inliers
+    spatialGridSize: 4,
+    multiTarget: true, // Keep tracking every detected target, not just the video one
+    maxTrackedTargets: 3 // Targets held for optical flow in multi-target mode
   },
   geometry: {
     maxScaleChange: 0.5,
@@ -85,7 +101,52 @@ const AppConfig = {
     switchHysteresis: 1.3
   },
   frameProcessing: {
-    maxDimension: 720
+    maxDimension: 720,
+    videoFrameCallback: true // Process once per camera frame (requestVideoFrameCallback), else per animation frame
+  },
+  opencv: {
+    threads: 0, // Threaded builds: OpenCV threads (0 = one per core, minus one for the page)
+    workerThreads: true // Let the vision worker load the threads+SIMD build when isolated
+  },
+  logging: {
+    level: 'info' // 'debug' turns on per-frame detection logs (override with ?log=debug)
+  },
+  profiler: {
+    traceCapacity: 16384, // Span events kept for the per-frame trace / Chrome trace export
+    userTiming: false // Mirror spans into performance.measure (DevTools Performance panel)
+  },
+  governor: {
+    enabled: true, // Adapt the tiers below to hold frameBudgetMs
+    frameBudgetMs: 33, // Tracker frame time to hold (~30 fps)
+    upshiftRatio: 0.6, // Step up only while cost stays below this share of the budget
+    downshiftWindows: 2, // Consecutive over-budget windows (30 frames each) before stepping down
+    upshiftWindows: 4, // Consecutive under-budget windows before stepping up
+    initialTier: -1, // -1 = pick from navigator.hardwareConcurrency
+    tiers: [
+      { name: 'high', maxDimension: 720, maxFeatures: 2000, pyramidLevels: 12, detectionInterval: 30 },
+      { name: 'medium', maxDimension: 640, maxFeatures: 1500, pyramidLevels: 10, detectionInterval: 30 },
+      { name: 'low', maxDimension: 480, maxFeatures: 1000, pyramidLevels: 8, detectionInterval: 45 },
+      { name: 'minimal', maxDimension: 360, maxFeatures: 600, pyramidLevels: 6, detectionInterval: 60 }
+    ]
+  },
+  worker: {
+    enabled: true,
+    scriptUrl: 'modules/workers/VisionWorker.js',
+    vocabularyScriptUrl: 'modules/workers/VocabularyWorker.js',
+    vocabularyPoolSize: 0, // 0 = one per spare core, up to 4
+    initTimeout: 30000
+  },
+  rendering: {
+    singlePassComposite: true, // Camera + warped video in one shader pass (ARRenderer)
+    decoupledRender: true, // Render on its own frame loop, predicting corners between tracker updates
+    maxPredictionMs: 60 // Longest extrapolation past the last tracker update
+  },
+  video: {
+    prefetchCount: 2, // Likeliest targets (vocabulary similarity, recent sightings) kept pre-buffered
+    prebufferSeconds: 2, // Buffered from the start before a prefetch counts as done
+    decodedBudgetMB: 96, // Estimated decoded frames + texture of all loaded videos
+    likelihoodHalfLifeMs: 4000, // How fast a similarity score or sighting fades
+    minLikelihood: 0.05 // Paused videos below this are released after cleanupDelay
   },
   camera: {
     defaultWidth: 1920,
@@ -93,12 +154,24 @@ const AppConfig = {
     maxReadyAttempts: 50,
     readyCheckInterval: 100
   },
+  album: {
+    streaming: true, // Index the zip with range reads; videos load on first detection
+    cacheInBackground: true, // Still read a streamed album whole into the album cache for offline use
+    contentCacheMB: 512, // Extracted albums in Cache Storage; least recently opened are evicted
+    videoRetryDelay: 5000, // ms before a deferred video whose read failed is tried again
+    serviceWorker: true // sw.js serves cached videos with Range responses (streams instead of blob URLs)
+  },
+  reference: {
+    residentBudgetMB: 8 // WASM heap for target descriptor Mats; least recently matched are evicted
+  },
   database: {
     version: '1.0.0',
+    warmStartTargetMs: 50, // Cache read + decode + import budget on a warm start
     getConfigSignature() {
       const criticalParams = {
         orb: AppConfig.orb,
         teblid: AppConfig.teblid,
+        targetMaxDimension: AppConfig.targetPreprocessing.maxDimension,
         vocabulary: {
           branchingFactor: AppConfig.vocabulary.branchingFactor,
           levels: AppConfig.vocabulary.levels,
@@ -122,7 +195,13 @@ const AppConfig = {
     levels: 2,
     maxFeaturesPerTarget: 500,
     weightingScheme: 'bm25',
-    minScoreGap: 0.05
+    minScoreGap: 0.05,
+    parallelBuild: true, // Build vocabulary on a VocabularyWorkerPool
+    parallelMinDescriptors: 4000, // Smaller k-means nodes stay on the calling thread
+    incremental: true, // Add changed album targets to the cached tree instead of rebuilding
+    driftThreshold: 1.1, // Re-cluster when new descriptors sit this much farther from their words
+    maxIncrementalFraction: 0.5, // ...or when this share of targets was added incrementally
+    driftSampleSize: 5000 // Descriptors sampled per drift measurement
   }
 };
 
@@ -37,6 +37,20 @@ export class CustomExperimentConfigs {
     }
   };
 
+  /**
+   * How debug-custom.html runs the search in parallel mode
+   * (DebugExperimentRunner.runParallelExperiments / ExperimentScheduler)
+   */
+  static search = {
+    workers: 0, // 0 = one per core minus one, up to 8
+    visualizeTop: 5, // Results redrawn with composites on the main thread
+    halving: {
+      eta: 3, // Keep the best third at every rung
+      minViews: 1, // Frame views every config is scored on
+      maxViews: 9 // Views the final rung's survivors are scored on
+    }
+  };
+
   /**
    * Flatten nested objects in search space to key-value pairs
    */
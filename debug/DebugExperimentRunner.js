@@ -3,9 +3,16 @@
  * Orchestrates detection experiments with different parameter configurations
  * Reuses existing modules: VocabularyBuilder for preprocessing,
  * FeatureDetector for matching
+ *
+ * Extracted features are cached by extraction parameters (FeatureCache),
+ * so configs that only change matching reuse them. runParallelExperiments
+ * spreads a sweep over workers (ExperimentScheduler); evaluate() is the
+ * DOM-free part both paths share.
  */
 
 import { DebugVisualizer } from './DebugVisualizer.js';
+import { ExperimentScheduler } from './ExperimentScheduler.js';
+import { FeatureCache } from './FeatureCache.js';
 
 export class DebugExperimentRunner {
   constructor() {
@@ -13,6 +20,10 @@ export class DebugExperimentRunner {
     this.targetImage = null;
     this.frameImage = null;
     this.progressCallback = null;
+    this.featureCache = new FeatureCache();
+    this.frameViews = new Map(); // view index -> frame Mat (0 is frameImage)
+    this.scheduler = null;
+    this.cancelled = false;
   }
 
   /**
@@ -45,6 +56,7 @@ export class DebugExperimentRunner {
 
     this.frameImage = await this._loadImageFromUrl(frameUrl);
     this._reportProgress(2, 2, 'Frame image loaded');
+    this.clearCaches();
 
     console.log('Images loaded successfully');
     console.log(`Target: ${this.targetImage.cols}x${this.targetImage.rows}`);
@@ -356,6 +368,150 @@ export class DebugExperimentRunner {
     }
   }
 
+  /**
+   * Frame view used to score a config: 0 is the frame itself, the others
+   * are deterministic rotations, scalings, brightness shifts and blurs of it
+   * @param {cv.Mat} frameImage - Input frame (RGBA)
+   * @param {number} index - View index
+   * @returns {cv.Mat} New Mat (caller deletes)
+   */
+  static createFrameView(frameImage, index) {
+    if (index === 0) {
+      return frameImage.clone();
+    }
+
+    const angle = ((index * 37) % 31) - 15; // -15..15 degrees
+    const scale = 0.8 + ((index * 13) % 9) * 0.05; // 0.8..1.2
+    const brightness = (((index * 7) % 5) - 2) * 15;
+
+    const center = new cv.Point(frameImage.cols / 2, frameImage.rows / 2);
+    const rotation = cv.getRotationMatrix2D(center, angle, scale);
+    const view = new cv.Mat();
+    cv.warpAffine(frameImage, view, rotation,
+                  new cv.Size(frameImage.cols, frameImage.rows),
+                  cv.INTER_LINEAR, cv.BORDER_REPLICATE, new cv.Scalar());
+    rotation.delete();
+
+    view.convertTo(view, -1, 1, brightness);
+    if (index % 3 === 0) {
+      cv.GaussianBlur(view, view, new cv.Size(5, 5), 1.2);
+    }
+    return view;
+  }
+
+  /**
+   * Frame view Mat, created on first use
+   * @param {number} index - View index
+   * @returns {cv.Mat}
+   */
+  _frameView(index) {
+    if (index === 0) {
+      return this.frameImage;
+    }
+    if (!this.frameViews.has(index)) {
+      this.frameViews.set(index,
+        DebugExperimentRunner.createFrameView(this.frameImage, index));
+    }
+    return this.frameViews.get(index);
+  }
+
+  /**
+   * Scale, preprocess and extract features of one image, as a config does
+   * @param {cv.Mat} imageMat - Input image (RGBA)
+   * @param {Object} config - Experiment configuration
+   * @param {string} role - 'target' (targetScale) or 'frame' (frameScale)
+   * @returns {Object} { image, keypoints, descriptors, extractMs }
+   */
+  _prepareFeatures(imageMat, config, role) {
+    const startTime = performance.now();
+    const scale = role === 'target' ? config.targetScale : config.frameScale;
+
+    let scaled;
+    if (scale) {
+      scaled = this._applyScale(imageMat, scale);
+    } else if (config.maxDimension) {
+      scaled = this._scaleImage(imageMat, config.maxDimension);
+    } else {
+      scaled = imageMat.clone();
+    }
+
+    let image;
+    try {
+      image = this._preprocessImage(scaled, config.preprocessing);
+    } finally {
+      scaled.delete();
+    }
+
+    try {
+      const features = this._extractFeatures(image, config.brisk,
+                                             config.maxFeatures);
+      return { image, ...features, extractMs: performance.now() - startTime };
+    } catch (error) {
+      image.delete();
+      throw error;
+    }
+  }
+
+  /**
+   * Detect the target in one frame view (no DOM access, runs in workers)
+   * @param {Object} config - Experiment configuration
+   * @param {number} view - Frame view index (see createFrameView)
+   * @returns {Object} { metrics, success, corners, target, frame, matchResult };
+   *   target and frame belong to the cache, the caller deletes matchResult.matches
+   */
+  evaluate(config, view = 0) {
+    const target = this.featureCache.get(
+      FeatureCache.key(config, 'target'),
+      () => this._prepareFeatures(this.targetImage, config, 'target'));
+    const frame = this.featureCache.get(
+      FeatureCache.key(config, 'frame', view),
+      () => this._prepareFeatures(this._frameView(view), config, 'frame'));
+
+    const matchStart = performance.now();
+    const metrics = {
+      targetSize: `${target.image.cols}x${target.image.rows}`,
+      frameSize: `${frame.image.cols}x${frame.image.rows}`,
+      targetKeypoints: target.keypoints.size(),
+      frameKeypoints: frame.keypoints.size()
+    };
+
+    // Match features
+    const matchResult = this._matchFeatures(target.descriptors,
+      frame.descriptors, config.matching);
+
+    metrics.rawMatches = matchResult.matches.size();
+    metrics.goodMatches = matchResult.goodMatches.length;
+    metrics.ratioThreshold = config.matching.ratioThreshold;
+
+    let success = false;
+    let corners = null;
+
+    // Check if we have enough good matches
+    if (matchResult.goodMatches.length >= config.matching.minGoodMatches) {
+      // Compute homography
+      const homographyResult = this._computeHomography(
+        target.keypoints,
+        frame.keypoints,
+        matchResult.matches,
+        matchResult.goodMatches,
+        target.image.cols,
+        target.image.rows,
+        config.matching.ransacThreshold
+      );
+
+      success = homographyResult.success;
+      corners = homographyResult.corners;
+    }
+
+    metrics.success = success;
+
+    // Full cost of the config, whether or not its features were cached
+    metrics.processingTime = target.extractMs + frame.extractMs +
+                             (performance.now() - matchStart);
+
+    return { metrics, success, corners, target, frame, matchResult };
+  }
+
   /**
    * Run a single experiment
    * @param {Object} config - Experiment configuration
@@ -372,79 +528,19 @@ export class DebugExperimentRunner {
     };
 
     try {
-      // Scale images
-      let targetScaled, frameScaled;
-      if (config.targetScale) {
-        targetScaled = this._applyScale(this.targetImage, config.targetScale);
-      } else if (config.maxDimension) {
-        targetScaled = this._scaleImage(this.targetImage, config.maxDimension);
-      } else {
-        targetScaled = this.targetImage.clone();
-      }
+      const evaluation = this.evaluate(config, 0);
+      const { target, frame, matchResult } = evaluation;
 
-      if (config.frameScale) {
-        frameScaled = this._applyScale(this.frameImage, config.frameScale);
-      } else if (config.maxDimension) {
-        frameScaled = this._scaleImage(this.frameImage, config.maxDimension);
-      } else {
-        frameScaled = this.frameImage.clone();
-      }
-
-      result.metrics.targetSize = `${targetScaled.cols}x${targetScaled.rows}`;
-      result.metrics.frameSize = `${frameScaled.cols}x${frameScaled.rows}`;
-
-      // Preprocess images
-      const targetPreprocessed = this._preprocessImage(targetScaled,
-                                                       config.preprocessing);
-      const framePreprocessed = this._preprocessImage(frameScaled,
-                                                      config.preprocessing);
-
-      // Extract features
-      const targetFeatures = this._extractFeatures(targetPreprocessed,
-        config.brisk, config.maxFeatures);
-      const frameFeatures = this._extractFeatures(framePreprocessed,
-        config.brisk, config.maxFeatures);
-
-      result.metrics.targetKeypoints = targetFeatures.keypoints.size();
-      result.metrics.frameKeypoints = frameFeatures.keypoints.size();
-
-      // Match features
-      const matchResult = this._matchFeatures(targetFeatures.descriptors,
-        frameFeatures.descriptors, config.matching);
-
-      result.metrics.rawMatches = matchResult.matches.size();
-      result.metrics.goodMatches = matchResult.goodMatches.length;
-      result.metrics.ratioThreshold = config.matching.ratioThreshold;
-
-      // Check if we have enough good matches
-      if (matchResult.goodMatches.length >= config.matching.minGoodMatches) {
-        // Compute homography
-        const homographyResult = this._computeHomography(
-          targetFeatures.keypoints,
-          frameFeatures.keypoints,
-          matchResult.matches,
-          matchResult.goodMatches,
-          targetPreprocessed.cols,
-          targetPreprocessed.rows,
-          config.matching.ransacThreshold
-        );
-
-        result.success = homographyResult.success;
-        result.corners = homographyResult.corners;
-      } else {
-        result.success = false;
-        result.corners = null;
-      }
-
-      result.metrics.success = result.success;
-      result.metrics.processingTime = performance.now() - startTime;
+      result.metrics = evaluation.metrics;
+      result.success = evaluation.success;
+      result.corners = evaluation.corners;
 
       // Generate visualizations
       result.visualizations.composite = DebugVisualizer.createComposite({
-        targetMat: targetPreprocessed,
-        frameMat: framePreprocessed,
-        targetKps: targetFeatures.keypoints,
-        frameKps: frameFeatures.keypoints,
+        targetMat: target.image,
+        frameMat: frame.image,
+        targetKps: target.keypoints,
+        frameKps: frame.keypoints,
         matches: matchResult.matches,
         goodMatches: matchResult.goodMatches,
         corners: result.corners,
@@ -452,15 +548,7 @@ export class DebugExperimentRunner {
         metrics: result.metrics
       });
 
-      // Cleanup
-      targetScaled.delete();
-      frameScaled.delete();
-      targetPreprocessed.delete();
-      framePreprocessed.delete();
-      targetFeatures.keypoints.delete();
-      targetFeatures.descriptors.delete();
-      frameFeatures.keypoints.delete();
-      frameFeatures.descriptors.delete();
+      // Cleanup (features stay in the cache)
       matchResult.matches.delete();
 
     } catch (error) {
@@ -479,9 +567,11 @@ export class DebugExperimentRunner {
    */
   async runAllExperiments(configs) {
     this.results = [];
+    this.cancelled = false;
     const total = configs.length;
 
     for (let i = 0; i < configs.length; i++) {
+      if (this.cancelled) break;
       const config = configs[i];
       this._reportProgress(i, total,
         `Running experiment ${i + 1}/${total}: ${config.id}`);
@@ -494,10 +584,73 @@ export class DebugExperimentRunner {
                   `Good matches=${result.metrics.goodMatches}`);
     }
 
+    this.clearCaches();
     this._reportProgress(total, total, 'All experiments completed');
     return this.results;
   }
 
+  /**
+   * Run experiments concurrently on a worker pool, optionally pruning
+   * losing configs by successive halving over frame views
+   * @param {Array} configs - Array of experiment configurations
+   * @param {Object} options - ExperimentScheduler options ({workers, halving,
+   *   opencvUrl}) plus visualizeTop: results redrawn here with composites
+   * @returns {Promise<Array>} Array of results (metrics averaged over views)
+   */
+  async runParallelExperiments(configs, options = {}) {
+    this.results = [];
+    this.cancelled = false;
+
+    const scheduler = new ExperimentScheduler(options);
+    scheduler.setProgressCallback(this.progressCallback);
+    this.scheduler = scheduler;
+
+    try {
+      this._reportProgress(0, configs.length,
+        `Starting ${scheduler.workerCount} experiment workers...`);
+      await scheduler.start(this.targetImage, this.frameImage);
+      this.results = await scheduler.run(configs);
+    } finally {
+      scheduler.terminate();
+      this.scheduler = null;
+    }
+
+    // Workers have no DOM: draw composites for the best results only
+    const visualizeTop = options.visualizeTop !== undefined ? options.visualizeTop : 5;
+    for (const result of this.getTopResults(visualizeTop)) {
+      if (this.cancelled) break;
+      if (result.error) continue;
+      const rerun = await this.runExperiment(result.config);
+      result.visualizations = rerun.visualizations;
+    }
+
+    this.clearCaches();
+    const total = this.results.length;
+    this._reportProgress(total, total, 'All experiments completed');
+    return this.results;
+  }
+
+  /**
+   * Stop after the experiments already running
+   */
+  cancel() {
+    this.cancelled = true;
+    if (this.scheduler) {
+      this.scheduler.cancel();
+    }
+  }
+
+  /**
+   * Free cached features and frame views
+   */
+  clearCaches() {
+    this.featureCache.clear();
+    for (const view of this.frameViews.values()) {
+      view.delete();
+    }
+    this.frameViews.clear();
+  }
+
   /**
    * Get results sorted by good matches (descending)
    * @returns {Array} Sorted results
@@ -0,0 +1,310 @@
+/**
+ * Experiment Scheduler
+ * Runs experiment configs concurrently on a pool of ExperimentWorker.js
+ * workers, with optional successive halving:
+ *
+ *   rung 0: every config is scored on minViews frame views
+ *   rung r: the best 1/eta configs get eta times more views, the rest are
+ *           pruned, until maxViews
+ *
+ * Views are the frame and deterministic perturbations of it
+ * (DebugExperimentRunner.createFrameView), so later rungs measure
+ * robustness, not just one lucky frame. A config's score is its success
+ * rate over its views, then its mean good matches.
+ *
+ * Every worker keeps a FeatureCache; configs are routed to the worker that
+ * already holds their target features, so configs differing only in
+ * matching parameters reuse one extraction.
+ */
+
+import { FeatureCache } from './FeatureCache.js';
+
+export class ExperimentScheduler {
+  static OPENCV_URL = 'https://docs.opencv.org/4.5.2/opencv.js';
+
+  /**
+   * @param {Object} options
+   * @param {number} options.workers - Pool size (0 = cores - 1, up to 8)
+   * @param {Object} options.halving - { eta, minViews, maxViews }; maxViews 1 disables it
+   * @param {string} options.opencvUrl - OpenCV.js the workers import
+   * @param {number} options.cacheSize - FeatureCache entries per worker
+   */
+  constructor(options = {}) {
+    this.workerCount = options.workers || ExperimentScheduler.defaultWorkers();
+    this.halving = { eta: 3, minViews: 1, maxViews: 1, ...options.halving };
+    this.opencvUrl = options.opencvUrl || ExperimentScheduler.OPENCV_URL;
+    this.cacheSize = options.cacheSize || 24;
+    this.slots = [];
+    this.nextId = 1;
+    this.cancelled = false;
+    this.progressCallback = null;
+  }
+
+  static defaultWorkers() {
+    const cores = (typeof navigator !== 'undefined' && navigator.hardwareConcurrency) || 2;
+    return Math.max(1, Math.min(8, cores - 1));
+  }
+
+  /**
+   * Views evaluated at each rung
+   * @returns {Array<number>}
+   */
+  static rungBudgets({ eta, minViews, maxViews }) {
+    const last = Math.max(1, maxViews);
+    const budgets = [];
+    let views = Math.max(1, Math.min(minViews, last));
+    while (eta > 1 && views < last) {
+      budgets.push(views);
+      views = Math.ceil(views * eta);
+    }
+    budgets.push(last);
+    return budgets;
+  }
+
+  setProgressCallback(callback) {
+    this.progressCallback = callback;
+  }
+
+  _reportProgress(current, total, message) {
+    if (this.progressCallback) {
+      this.progressCallback(current, total, message);
+    }
+  }
+
+  /**
+   * Spawn the workers and hand them the images
+   * @param {cv.Mat} targetImage - RGBA target
+   * @param {cv.Mat} frameImage - RGBA frame
+   */
+  async start(targetImage, frameImage) {
+    const toImageData = (mat) => ({
+      width: mat.cols,
+      height: mat.rows,
+      data: new Uint8ClampedArray(mat.data)
+    });
+    const init = {
+      type: 'init',
+      opencvUrl: this.opencvUrl,
+      cacheSize: this.cacheSize,
+      target: toImageData(targetImage),
+      frame: toImageData(frameImage)
+    };
+
+    for (let i = 0; i < this.workerCount; i++) {
+      const worker = new Worker(new URL('./ExperimentWorker.js', import.meta.url));
+      const slot = { worker, pending: new Map(), keys: new Set() };
+      worker.onmessage = (event) => this._onMessage(slot, event.data);
+      worker.onerror = (event) => {
+        const error = new Error(event.message || 'Experiment worker failed');
+        for (const { reject } of slot.pending.values()) reject(error);
+        slot.pending.clear();
+      };
+      this.slots.push(slot);
+    }
+
+    await Promise.all(this.slots.map(slot => this._request(slot, init)));
+  }
+
+  /**
+   * @private
+   */
+  _request(slot, message) {
+    const id = this.nextId++;
+    return new Promise((resolve, reject) => {
+      slot.pending.set(id, { resolve, reject });
+      slot.worker.postMessage({ ...message, id });
+    });
+  }
+
+  /**
+   * @private
+   */
+  _onMessage(slot, message) {
+    const pending = slot.pending.get(message.id);
+    if (!pending) return;
+    slot.pending.delete(message.id);
+
+    if (message.type === 'error') {
+      pending.reject(new Error(message.message));
+    } else {
+      pending.resolve(message.views || null);
+    }
+  }
+
+  /**
+   * Evaluate configs, pruning by successive halving
+   * @param {Array} configs - Experiment configurations
+   * @returns {Promise<Array>} Results in config order (runner result shape)
+   */
+  async run(configs) {
+    this.cancelled = false;
+    const { eta } = this.halving;
+    const budgets = ExperimentScheduler.rungBudgets(this.halving);
+
+    const entries = configs.map(config => ({
+      config,
+      targetKey: FeatureCache.key(config, 'target'),
+      views: [],
+      rung: 0,
+      pruned: false
+    }));
+
+    // Evaluations planned across all rungs, for progress
+    let total = 0;
+    let survivors = entries.length;
+    budgets.forEach((budget, r) => {
+      total += survivors * (budget - (r > 0 ? budgets[r - 1] : 0));
+      survivors = Math.max(1, Math.ceil(survivors / eta));
+    });
+
+    let done = 0;
+    let alive = entries;
+    for (let r = 0; r < budgets.length && alive.length > 0 && !this.cancelled; r++) {
+      const budget = budgets[r];
+      const tasks = alive.map(entry => ({ entry, from: entry.views.length, to: budget }));
+
+      await this._dispatch(tasks, (task, views) => {
+        task.entry.views.push(...views);
+        task.entry.rung = r;
+        done += views.length;
+        this._reportProgress(done, total,
+          `Rung ${r + 1}/${budgets.length} (${budget} views): ${task.entry.config.id}`);
+      });
+
+      alive.sort(ExperimentScheduler.compare);
+      if (r < budgets.length - 1) {
+        const keep = Math.max(1, Math.ceil(alive.length / eta));
+        alive.slice(keep).forEach(entry => { entry.pruned = true; });
+        alive = alive.slice(0, keep);
+      }
+    }
+
+    return entries
+      .filter(entry => entry.views.length > 0)
+      .map(entry => ExperimentScheduler.toResult(entry));
+  }
+
+  /**
+   * Run tasks on the pool; a free worker takes a task whose target features
+   * it already holds, else the next one
+   * @private
+   */
+  _dispatch(tasks, onResult) {
+    const queue = tasks.slice().sort((a, b) =>
+      a.entry.targetKey < b.entry.targetKey ? -1 : a.entry.targetKey > b.entry.targetKey ? 1 : 0
+    );
+    const keyLimit = Math.max(1, Math.floor(this.cacheSize / 4));
+
+    return new Promise(resolve => {
+      let running = 0;
+
+      const next = (slot) => {
+        if (this.cancelled) queue.length = 0;
+        if (queue.length === 0) {
+          if (running === 0) resolve();
+          return;
+        }
+
+        let index = queue.findIndex(task => slot.keys.has(task.entry.targetKey));
+        if (index < 0) index = 0;
+        const [task] = queue.splice(index, 1);
+
+        // Approximate the worker's cache contents
+        slot.keys.delete(task.entry.targetKey);
+        slot.keys.add(task.entry.targetKey);
+        if (slot.keys.size > keyLimit) {
+          slot.keys.delete(slot.keys.values().next().value);
+        }
+
+        running++;
+        this._request(slot, {
+          type: 'evaluate',
+          config: task.entry.config,
+          from: task.from,
+          to: task.to
+        })
+          .then(views => onResult(task, views))
+          .catch(error => {
+            const failed = [];
+            for (let v = task.from; v < task.to; v++) {
+              failed.push({ success: false, corners: null, metrics: {}, error: error.message });
+            }
+            onResult(task, failed);
+          })
+          .finally(() => {
+            running--;
+            next(slot);
+          });
+      };
+
+      this.slots.forEach(next);
+    });
+  }
+
+  static successRate(entry) {
+    if (entry.views.length === 0) return 0;
+    return entry.views.filter(view => view.success).length / entry.views.length;
+  }
+
+  static meanMetric(entry, key) {
+    if (entry.views.length === 0) return 0;
+    return entry.views.reduce((sum, view) => sum + (view.metrics[key] || 0), 0) /
+           entry.views.length;
+  }
+
+  /**
+   * Best first: success rate, then mean good matches
+   */
+  static compare(a, b) {
+    return ExperimentScheduler.successRate(b) - ExperimentScheduler.successRate(a) ||
+           ExperimentScheduler.meanMetric(b, 'goodMatches') -
+           ExperimentScheduler.meanMetric(a, 'goodMatches');
+  }
+
+  /**
+   * Runner result of an entry; counts are averaged over its views, sizes
+   * and corners come from the unperturbed frame
+   */
+  static toResult(entry) {
+    const first = entry.views[0];
+    const successRate = ExperimentScheduler.successRate(entry);
+    const metrics = {
+      ...first.metrics,
+      rawMatches: Math.round(ExperimentScheduler.meanMetric(entry, 'rawMatches')),
+      goodMatches: Math.round(ExperimentScheduler.meanMetric(entry, 'goodMatches')),
+      processingTime: ExperimentScheduler.meanMetric(entry, 'processingTime'),
+      success: successRate >= 0.5,
+      successRate,
+      views: entry.views.length,
+      rung: entry.rung,
+      pruned: entry.pruned
+    };
+    const failed = entry.views.find(view => view.error);
+
+    return {
+      config: entry.config,
+      metrics,
+      success: metrics.success,
+      error: failed ? failed.error : null,
+      corners: first.corners,
+      visualizations: {}
+    };
+  }
+
+  /**
+   * Stop dispatching; evaluations already running finish
+   */
+  cancel() {
+    this.cancelled = true;
+  }
+
+  terminate() {
+    for (const slot of this.slots) {
+      slot.worker.terminate();
+      for (const { reject } of slot.pending.values()) {
+        reject(new Error('Experiment scheduler terminated'));
+      }
+    }
+    this.slots = [];
+  }
+}
@@ -0,0 +1,86 @@
+/**
+ * Experiment Worker
+ * Evaluates experiment configs for ExperimentScheduler off the main thread.
+ * Classic worker: OpenCV.js is loaded with importScripts, then the runner
+ * module with a dynamic import. Features stay in the runner's FeatureCache
+ * between configs.
+ *
+ * Messages:
+ *   {type: 'init', id, opencvUrl, cacheSize, target, frame}  -> {type: 'ready', id}
+ *   {type: 'evaluate', id, config, from, to}                 -> {type: 'result', id, views}
+ *   failures                                                 -> {type: 'error', id, message}
+ */
+
+let runner = null;
+
+/**
+ * Wait for the OpenCV runtime (module object or promise, depending on version)
+ */
+async function openCvReady() {
+  if (typeof cv.then === 'function') {
+    self.cv = await cv;
+  } else if (!cv.Mat) {
+    await new Promise(resolve => {
+      cv.onRuntimeInitialized = resolve;
+    });
+  }
+}
+
+async function init(message) {
+  importScripts(message.opencvUrl);
+  await openCvReady();
+
+  const { DebugExperimentRunner } = await import('./DebugExperimentRunner.js');
+  const { FeatureCache } = await import('./FeatureCache.js');
+
+  runner = new DebugExperimentRunner();
+  runner.featureCache = new FeatureCache(message.cacheSize);
+  runner.targetImage = cv.matFromImageData(message.target);
+  runner.frameImage = cv.matFromImageData(message.frame);
+}
+
+/**
+ * Score one config on frame views [from, to)
+ */
+function evaluate(message) {
+  const views = [];
+  for (let view = message.from; view < message.to; view++) {
+    try {
+      const evaluation = runner.evaluate(message.config, view);
+      evaluation.matchResult.matches.delete();
+      views.push({
+        success: evaluation.success,
+        corners: evaluation.corners,
+        metrics: evaluation.metrics
+      });
+    } catch (error) {
+      views.push({
+        success: false,
+        corners: null,
+        metrics: {},
+        error: error.message || String(error)
+      });
+    }
+  }
+  return views;
+}
+
+self.onmessage = async (event) => {
+  const message = event.data;
+  try {
+    switch (message.type) {
+      case 'init':
+        await init(message);
+        self.postMessage({ type: 'ready', id: message.id });
+        break;
+      case 'evaluate':
+        self.postMessage({ type: 'result', id: message.id, views: evaluate(message) });
+        break;
+      default:
+        throw new Error(`Unknown message type: ${message.type}`);
+    }
+  } catch (error) {
+    console.error('[ExperimentWorker] Failed:', error);
+    self.postMessage({ type: 'error', id: message.id, message: error.message || String(error) });
+  }
+};
@@ -0,0 +1,79 @@
+/**
+ * Feature Cache
+ * Keeps preprocessed images and their features keyed by the parameters
+ * that produced them, so experiment configs that differ only in matching
+ * parameters reuse one extraction. Least recently used entries are freed
+ * when the cache is full.
+ */
+
+export class FeatureCache {
+  /**
+   * @param {number} capacity - Entries kept (each holds a Mat, keypoints and descriptors)
+   */
+  constructor(capacity = 24) {
+    this.capacity = Math.max(3, capacity);
+    this.entries = new Map();
+    this.hits = 0;
+    this.misses = 0;
+  }
+
+  /**
+   * Cache key of the extraction a config performs for the target or the frame
+   * @param {Object} config - Experiment configuration
+   * @param {string} role - 'target' or 'frame'
+   * @param {number} view - Frame view index (frames only)
+   * @returns {string}
+   */
+  static key(config, role, view = 0) {
+    const scale = role === 'target' ? config.targetScale : config.frameScale;
+    return JSON.stringify([
+      role,
+      role === 'frame' ? view : 0,
+      scale || null,
+      scale ? null : config.maxDimension || null,
+      config.preprocessing,
+      config.brisk,
+      config.maxFeatures
+    ]);
+  }
+
+  /**
+   * Cached entry, or the one create() returns
+   * @param {string} key
+   * @param {Function} create - () => {image, keypoints, descriptors, extractMs}
+   * @returns {Object}
+   */
+  get(key, create) {
+    let entry = this.entries.get(key);
+    if (entry) {
+      this.hits++;
+      this.entries.delete(key); // Re-inserted as most recent
+    } else {
+      this.misses++;
+      entry = create();
+      while (this.entries.size >= this.capacity) {
+        const [oldestKey, oldest] = this.entries.entries().next().value;
+        this.entries.delete(oldestKey);
+        FeatureCache.release(oldest);
+      }
+    }
+    this.entries.set(key, entry);
+    return entry;
+  }
+
+  /**
+   * Free every entry
+   */
+  clear() {
+    for (const entry of this.entries.values()) {
+      FeatureCache.release(entry);
+    }
+    this.entries.clear();
+  }
+
+  static release(entry) {
+    entry.image.delete();
+    entry.keypoints.delete();
+    entry.descriptors.delete();
+  }
+}
@@ -0,0 +1,172 @@
+/**
+ * OpenCV build benchmark (node)
+ *
+ * Runs the tracker's OpenCV stages on the same seeded frame set with each
+ * build in opencv_builds/ and prints per-stage medians and the speedup
+ * against the simd build. Each build runs in its own process so pthread
+ * pools do not overlap.
+ *
+ *   node debug/benchmark-builds.js [frames]
+ *
+ * Threaded speedups depend on the cores the machine exposes; the core
+ * count is printed with the results.
+ */
+
+const { execFileSync } = require('child_process');
+const os = require('os');
+const path = require('path');
+
+const BUILDS = ['wasm', 'simd', 'threadsSimd'];
+const BUILDS_DIR = path.join(__dirname, '..', 'opencv_builds');
+
+async function loadBuild(name) {
+  let cv = require(path.join(BUILDS_DIR, name, 'opencv.js'));
+  if (typeof cv === 'function') cv = await cv();
+  else if (cv && typeof cv.then === 'function') cv = await cv;
+  return cv;
+}
+
+/**
+ * Seeded blurred-noise texture (deterministic across builds)
+ */
+function texture(cv, seed, width, height) {
+  const noise = new cv.Mat(height, width, cv.CV_8UC1);
+  let x = seed;
+  for (let i = 0; i < noise.data.length; i++) {
+    x = (x * 1103515245 + 12345) & 0x7fffffff;
+    noise.data[i] = x >> 23;
+  }
+  const blurred = new cv.Mat();
+  cv.GaussianBlur(noise, blurred, new cv.Size(5, 5), 1.5);
+  noise.delete();
+  return blurred;
+}
+
+function median(values) {
+  const sorted = values.slice().sort((a, b) => a - b);
+  return sorted[Math.floor(sorted.length / 2)];
+}
+
+/**
+ * Child process: time each stage on every frame of the set
+ */
+async function runStages(buildName, frameCount) {
+  const cv = await loadBuild(buildName);
+  const orb = new cv.ORB(1000, 1.2, 8, 31, 0, 2, 0, 31, 20);
+  const teblid = new cv.xfeatures2d_TEBLID(1.0, cv.TEBLID_SIZE_256_BITS);
+  const matcher = new cv.BFMatcher(cv.NORM_HAMMING, false);
+  const criteria = new cv.TermCriteria(cv.TERM_CRITERIA_EPS | cv.TERM_CRITERIA_COUNT, 30, 0.01);
+
+  // Five targets stacked, as BatchedMatcher matches them
+  const references = new cv.MatVector();
+  for (let t = 0; t < 5; t++) {
+    const image = texture(cv, 100 + t, 480, 360);
+    const keypoints = new cv.KeyPointVector();
+    const descriptors = new cv.Mat();
+    orb.detect(image, keypoints);
+    teblid.compute(image, keypoints, descriptors);
+    references.push_back(descriptors);
+    image.delete();
+    keypoints.delete();
+    descriptors.delete();
+  }
+  const stacked = new cv.Mat();
+  cv.vconcat(references, stacked);
+  references.delete();
+
+  // Frame set: one scene under a slowly changing warp
+  const scene = texture(cv, 7, 640, 480);
+  const frames = [];
+  for (let i = 0; i < frameCount; i++) {
+    const angle = i * 0.01;
+    const warp = cv.matFromArray(2, 3, cv.CV_64F, [
+      Math.cos(angle), Math.sin(angle), 4 + i, -Math.sin(angle), Math.cos(angle), 3 + i
+    ]);
+    const frame = new cv.Mat();
+    cv.warpAffine(scene, frame, warp, new cv.Size(640, 480));
+    warp.delete();
+    frames.push(frame);
+  }
+
+  const stages = {
+    blur: [], orb_detect: [], teblid_compute: [], knn_5_targets: [], good_features: [], optical_flow: []
+  };
+  const time = (stage, run) => {
+    const start = performance.now();
+    run();
+    stages[stage].push(performance.now() - start);
+  };
+
+  for (let i = 1; i < frames.length; i++) {
+    const frame = frames[i];
+    const keypoints = new cv.KeyPointVector();
+    const descriptors = new cv.Mat();
+    const blurred = new cv.Mat();
+    const corners = new cv.Mat();
+    const next = new cv.Mat();
+    const status = new cv.Mat();
+    const error = new cv.Mat();
+    const knn = new cv.DMatchVectorVector();
+
+    time('blur', () => cv.GaussianBlur(frame, blurred, new cv.Size(5, 5), 1.2));
+    time('orb_detect', () => orb.detect(frame, keypoints));
+    time('teblid_compute', () => teblid.compute(frame, keypoints, descriptors));
+    time('knn_5_targets', () => matcher.knnMatch(stacked, descriptors, knn, 2));
+    time('good_features', () => cv.goodFeaturesToTrack(frames[i - 1], corners, 200, 0.01, 7));
+    time('optical_flow', () => cv.calcOpticalFlowPyrLK(
+      frames[i - 1], frame, corners, next, status, error, new cv.Size(21, 21), 3, criteria
+    ));
+
+    [keypoints, descriptors, blurred, corners, next, status, error, knn].forEach(m => m.delete());
+  }
+
+  const result = {};
+  for (const stage in stages) {
+    result[stage] = median(stages[stage]);
+  }
+  return result;
+}
+
+function runParent(frameCount) {
+  const results = {};
+  for (const build of BUILDS) {
+    try {
+      const output = execFileSync(process.execPath, [__filename, '--child', build, String(frameCount)], {
+        encoding: 'utf8',
+        stdio: ['ignore', 'pipe', 'ignore'],
+        timeout: 600000
+      });
+      results[build] = JSON.parse(output.trim().split('\n').pop());
+    } catch (error) {
+      console.warn(`${build}: failed (${error.message.split('\n')[0]})`);
+    }
+  }
+
+  const stages = Object.keys(results.simd || Object.values(results)[0] || {});
+  console.log(`OpenCV builds, ${frameCount} frames, ${os.cpus().length} core(s) (median ms, speedup vs simd)\n`);
+  console.log(['stage'.padEnd(16), ...BUILDS.map(b => b.padStart(18))].join(''));
+  for (const stage of stages) {
+    const baseline = results.simd ? results.simd[stage] : null;
+    const cells = BUILDS.map(build => {
+      if (!results[build]) return '-'.padStart(18);
+      const value = results[build][stage];
+      const speedup = baseline ? ` (${(baseline / value).toFixed(2)}x)` : '';
+      return `${value.toFixed(2)}${speedup}`.padStart(18);
+    });
+    console.log([stage.padEnd(16), ...cells].join(''));
+  }
+}
+
+if (process.argv[2] === '--child') {
+  runStages(process.argv[3], parseInt(process.argv[4], 10))
+    .then(result => {
+      console.log(JSON.stringify(result));
+      process.exit(0); // pthread pools keep the process alive
+    })
+    .catch(error => {
+      console.error(error);
+      process.exit(1);
+    });
+} else {
+  runParent(parseInt(process.argv[2], 10) || 30);
+}
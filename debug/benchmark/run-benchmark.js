@@ -0,0 +1,571 @@
+/**
+ * Offline tracking benchmark (node)
+ *
+ * Replays frame sequences with ground-truth corners through the real
+ * TrackingPipeline (FeatureDetector, OpticalFlowTracker and the vocabulary
+ * query, loaded from modules/ exactly as the vision worker loads them) and
+ * reports per-stage p50/p95 latency, recall, corner RMSE and heap growth for
+ * each OpenCV build, compared against baseline.json.
+ *
+ *   node debug/benchmark/run-benchmark.js [options]
+ *
+ *   --builds wasm,simd,threadsSimd  Builds to run (default: all three)
+ *   --sequences <dir>               Recorded sequences (default: debug/benchmark/sequences)
+ *   --repeat <n>                    Measured passes per sequence after the warmup pass (default: 3)
+ *   --check                         Exit 1 when a metric regresses against the baseline
+ *   --update-baseline               Store these results as the new baseline
+ *   --write-synthetic <dir>         Write the built-in synthetic clip in the sequence format and exit
+ *   --verbose                       Keep the modules' console output
+ *
+ * The built-in synthetic clip always runs; recorded sequences are added when
+ * present (see sequences.js for the format). Each build runs in its own
+ * process with --expose-gc so heap figures are taken after a full GC.
+ */
+
+const { execFileSync } = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const vm = require('vm');
+const sequences = require('./sequences');
+
+const ROOT = path.join(__dirname, '..', '..');
+const BUILDS = ['wasm', 'simd', 'threadsSimd'];
+const BASELINE_FILE = path.join(__dirname, 'baseline.json');
+const DEFAULT_SEQUENCES = path.join(__dirname, 'sequences');
+
+// Same scripts, in the same order, as the vision worker imports
+const APP_MODULES = [
+  'config.js',
+  'modules/utils/Logger.js',
+  'modules/utils/PerformanceProfiler.js',
+  'modules/utils/MatPool.js',
+  'modules/database/FlatVocabularyTree.js',
+  'modules/database/VocabularyTreeQuery.js',
+  'modules/database/VocabularyBuilder.js',
+  'modules/reference/ReferenceCache.js',
+  'modules/reference/ReferenceImageManager.js',
+  'modules/detection/BatchedMatcher.js',
+  'modules/detection/FeatureDetector.js',
+  'modules/tracking/OpticalFlowTracker.js',
+  'modules/core/TrackingPipeline.js'
+];
+
+// Spans compared against the baseline; the rest are reported only
+const CHECKED_SPANS = ['frame_total', 'detection_total', 'optical_flow_tracking'];
+
+const TOLERANCE = {
+  // Relative increase per statistic. p95 of frame_total sits on the few
+  // detection frames of a pass and swings by a third between runs; p50 and
+  // mean are stable and catch real regressions, p95 only gross ones
+  latency: { p50: 0.15, mean: 0.15, p95: 0.5 },
+  recall: 0.02, // Absolute drop
+  rmse: 1.0, // Pixels
+  heapMB: 8 // Growth over the measured passes
+};
+
+function parseArgs(argv) {
+  const options = {
+    builds: BUILDS,
+    sequences: DEFAULT_SEQUENCES,
+    repeat: 3,
+    check: false,
+    updateBaseline: false,
+    writeSynthetic: null,
+    verbose: false
+  };
+  for (let i = 0; i < argv.length; i++) {
+    switch (argv[i]) {
+      case '--builds': options.builds = argv[++i].split(','); break;
+      case '--sequences': options.sequences = path.resolve(argv[++i]); break;
+      case '--repeat': options.repeat = Math.max(1, parseInt(argv[++i], 10) || 1); break;
+      case '--check': options.check = true; break;
+      case '--update-baseline': options.updateBaseline = true; break;
+      case '--write-synthetic': options.writeSynthetic = path.resolve(argv[++i]); break;
+      case '--verbose': options.verbose = true; break;
+      default: throw new Error(`Unknown option: ${argv[i]}`);
+    }
+  }
+  return options;
+}
+
+async function loadBuild(name) {
+  let cv = require(path.join(ROOT, 'opencv_builds', name, 'opencv.js'));
+  if (typeof cv === 'function') cv = await cv();
+  else if (cv && typeof cv.then === 'function') cv = await cv;
+  return cv;
+}
+
+/**
+ * Load the app modules as classic scripts into this realm, the way
+ * importScripts does in the worker (no window, no DOM). A separate vm
+ * context would give the modules foreign globals and typed arrays and slow
+ * their JS hot loops down by more than an order of magnitude
+ * @returns {Object} The classes the benchmark drives
+ */
+function loadApp(cv, verbose) {
+  globalThis.cv = cv;
+  if (!verbose) {
+    // The child reports through process.stdout, so the console can be muted
+    const quiet = () => {};
+    Object.assign(console, { log: quiet, info: quiet, debug: quiet, warn: quiet });
+  }
+  for (const file of APP_MODULES) {
+    vm.runInThisContext(fs.readFileSync(path.join(ROOT, file), 'utf8'), { filename: file });
+  }
+  return vm.runInThisContext(`({
+    AppConfig, PerformanceProfiler, VocabularyBuilder, VocabularyTreeQuery,
+    ReferenceImageManager, FeatureDetector, OpticalFlowTracker, TrackingPipeline
+  })`);
+}
+
+/**
+ * Build the album the way ZipDatabaseLoader does and load it like the
+ * vision worker (runtime targets plus vocabulary query)
+ */
+async function buildTargets(app, sequence, detector) {
+  const { AppConfig, VocabularyBuilder, VocabularyTreeQuery, ReferenceImageManager } = app;
+  const builder = new VocabularyBuilder({
+    branchingFactor: AppConfig.vocabulary.branchingFactor,
+    levels: AppConfig.vocabulary.levels,
+    maxFeaturesPerTarget: AppConfig.vocabulary.maxFeaturesPerTarget
+  });
+  await builder.processTargets(sequence.targets.map(target => ({ imageMat: target.mat, targetId: target.id })));
+  const database = builder.exportDatabase();
+
+  const referenceManager = new ReferenceImageManager();
+  referenceManager.loadFromDatabase(database);
+
+  const vocabulary = database.vocabulary;
+  if (vocabulary?.words && vocabulary?.idf_weights) {
+    detector.setVocabularyQuery(new VocabularyTreeQuery(
+      vocabulary.words,
+      vocabulary.idf_weights,
+      vocabulary.flat_tree || vocabulary.tree || null,
+      vocabulary.inverted_index || null
+    ));
+  }
+  return referenceManager;
+}
+
+/**
+ * Video target selection of ImageTracker.selectBestTarget without the
+ * wall-clock switch delay: keep the current target unless another one is
+ * switchHysteresis times closer to the centre
+ */
+function selectActiveTarget(app, state, results, width, height) {
+  const valid = results.filter(r => r.success && r.corners);
+  if (valid.length === 0) {
+    state.activeVideoTarget = null;
+    return;
+  }
+
+  const distance = (result) => {
+    const c = result.corners;
+    const x = (c[0].x + c[1].x + c[2].x + c[3].x) / 4 - width / 2;
+    const y = (c[0].y + c[1].y + c[2].y + c[3].y) / 4 - height / 2;
+    return Math.sqrt(x * x + y * y);
+  };
+  const closest = valid.reduce((best, r) => distance(r) < distance(best) ? r : best);
+  const current = valid.find(r => r.targetId === state.activeVideoTarget);
+  if (current && distance(current) < distance(closest) * app.AppConfig.targetSwitching.switchHysteresis) {
+    return;
+  }
+  state.activeVideoTarget = closest.targetId;
+}
+
+function percentile(sorted, p) {
+  return sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+}
+
+function median(values) {
+  const sorted = values.slice().sort((a, b) => a - b);
+  const mid = sorted.length >> 1;
+  return sorted.length % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+}
+
+function round(value, digits = 2) {
+  const scale = Math.pow(10, digits);
+  return Math.round(value * scale) / scale;
+}
+
+/**
+ * Wasm heap in use: address of a fresh probe allocation (dlmalloc hands out
+ * the lowest fitting chunk, so leaked blocks push it up) and the size of
+ * the linear memory
+ */
+function wasmHeap(cv) {
+  const probe = cv._malloc(4 << 20);
+  cv._free(probe);
+  const mat = new cv.Mat(1, 1, cv.CV_8UC1);
+  const memory = mat.data.buffer.byteLength;
+  mat.delete();
+  return { top: probe, memory };
+}
+
+function collectHeap(cv) {
+  if (typeof global.gc === 'function') global.gc();
+  return { wasm: wasmHeap(cv), js: process.memoryUsage().heapUsed };
+}
+
+/**
+ * Time a fixed OpenCV workload (blur, corners, pyramidal flow on a VGA
+ * frame) to measure how fast the machine is right now. Shared CI hosts
+ * drift by 20% and more between runs; latency is compared relative to this
+ * figure so the drift cancels out
+ * @returns {number} ms
+ */
+function calibrate(cv) {
+  const width = 640;
+  const height = 480;
+  const src = new cv.Mat(height, width, cv.CV_8UC1);
+  const data = src.data;
+  for (let i = 0; i < data.length; i++) {
+    data[i] = ((i * 2654435761) >>> 24) ^ ((i % width) >> 3);
+  }
+  const blurred = new cv.Mat();
+  const corners = new cv.Mat();
+  const next = new cv.Mat();
+  const status = new cv.Mat();
+  const err = new cv.Mat();
+  const size = new cv.Size(21, 21);
+  const criteria = new cv.TermCriteria(cv.TERM_CRITERIA_EPS | cv.TERM_CRITERIA_COUNT, 30, 0.01);
+
+  const rounds = [];
+  for (let round = 0; round < 5; round++) {
+    const start = performance.now();
+    for (let i = 0; i < 4; i++) {
+      cv.GaussianBlur(src, blurred, new cv.Size(9, 9), 0);
+      cv.goodFeaturesToTrack(blurred, corners, 300, 0.005, 10);
+      cv.calcOpticalFlowPyrLK(src, blurred, corners, next, status, err, size, 4, criteria);
+    }
+    rounds.push(performance.now() - start);
+  }
+
+  [src, blurred, corners, next, status, err].forEach(mat => mat.delete());
+  return median(rounds);
+}
+
+/**
+ * Child process: replay every sequence on one build
+ */
+async function runBuild(buildName, options) {
+  const cv = await loadBuild(buildName);
+  const app = loadApp(cv, options.verbose);
+  const { AppConfig, PerformanceProfiler, FeatureDetector, OpticalFlowTracker, TrackingPipeline } = app;
+
+  const list = [sequences.syntheticSequence(cv)];
+  for (const dir of sequences.findSequences(options.sequences)) {
+    list.push(sequences.loadSequence(cv, dir));
+  }
+
+  const report = {};
+  for (const sequence of list) {
+    // Worker-local state, as VisionWorker.createPipeline sets it up
+    const state = {
+      isTracking: true,
+      frameCount: 0,
+      detectionInterval: AppConfig.detection.detectionInterval,
+      useOpticalFlow: true,
+      maxFeatures: AppConfig.orb.nfeatures,
+      pyramidLevels: AppConfig.orb.nlevels,
+      trackedTargets: new Map(),
+      activeVideoTarget: null
+    };
+    const profiler = new PerformanceProfiler({ traceCapacity: 0 });
+    const detector = new FeatureDetector(state, profiler, null);
+    const opticalFlow = new OpticalFlowTracker(state);
+    const pipeline = new TrackingPipeline(state, detector, opticalFlow, profiler);
+
+    const setupStart = performance.now();
+    const referenceManager = await buildTargets(app, sequence, detector);
+    const setupMs = performance.now() - setupStart;
+    const targets = referenceManager.getTargets();
+
+    const accuracy = { frames: 0, gtFrames: 0, recalled: 0, falsePositives: 0, squaredError: 0, corners: 0 };
+    const durations = new Map();
+    const calibrations = [];
+    let heapBefore = null;
+
+    // Pass 0 warms up caches, pools and the JIT and is not measured
+    for (let pass = 0; pass <= options.repeat; pass++) {
+      pipeline.reset();
+      state.activeVideoTarget = null;
+      if (pass === 1) heapBefore = collectHeap(cv);
+      if (pass > 0) profiler.beginSamples();
+
+      for (let i = 0; i < sequence.frameCount; i++) {
+        const frame = sequence.frame(i);
+        profiler.startTimer(PerformanceProfiler.Span.FRAME_TOTAL);
+        const results = pipeline.processFrame(frame, targets);
+        referenceManager.trimReferenceCache();
+        profiler.endTimer(PerformanceProfiler.Span.FRAME_TOTAL);
+        selectActiveTarget(app, state, results, frame.cols, frame.rows);
+        frame.delete();
+
+        if (pass > 0) scoreFrame(accuracy, results, sequence.corners(i));
+      }
+
+      if (pass > 0) {
+        calibrations.push(calibrate(cv));
+        const passDurations = new Map();
+        for (const [label, , duration] of profiler.takeSamples().spans) {
+          if (!passDurations.has(label)) passDurations.set(label, []);
+          passDurations.get(label).push(duration);
+        }
+        for (const [label, values] of passDurations) {
+          if (!durations.has(label)) durations.set(label, []);
+          durations.get(label).push(values);
+        }
+      }
+    }
+    const heapAfter = collectHeap(cv);
+
+    // Statistics per pass, then the median over passes, so one noisy pass
+    // cannot move the result
+    const latency = {};
+    for (const [label, passes] of durations) {
+      const stats = passes.map(values => {
+        const sorted = values.sort((a, b) => a - b);
+        return {
+          p50: percentile(sorted, 0.5),
+          p95: percentile(sorted, 0.95),
+          mean: sorted.reduce((sum, value) => sum + value, 0) / sorted.length
+        };
+      });
+      latency[label] = {
+        p50: round(median(stats.map(stat => stat.p50))),
+        p95: round(median(stats.map(stat => stat.p95))),
+        mean: round(median(stats.map(stat => stat.mean))),
+        count: passes.reduce((sum, values) => sum + values.length, 0)
+      };
+    }
+
+    report[sequence.name] = {
+      frames: sequence.frameCount,
+      passes: options.repeat,
+      targets: targets.length,
+      setupMs: round(setupMs, 1),
+      calibrationMs: round(median(calibrations)),
+      latency,
+      accuracy: {
+        recall: accuracy.gtFrames ? round(accuracy.recalled / accuracy.gtFrames, 4) : null,
+        falsePositives: accuracy.falsePositives,
+        rmse: accuracy.corners ? round(Math.sqrt(accuracy.squaredError / accuracy.corners)) : null,
+        gtFrames: accuracy.gtFrames
+      },
+      heap: {
+        wasmGrowthMB: round((heapAfter.wasm.top - heapBefore.wasm.top) / 1048576),
+        wasmMemoryMB: round(heapAfter.wasm.memory / 1048576, 1),
+        jsGrowthMB: round((heapAfter.js - heapBefore.js) / 1048576)
+      }
+    };
+
+    sequence.release();
+  }
+
+  return {
+    build: buildName,
+    sequences: report
+  };
+}
+
+/**
+ * Recall counts frames where a visible target was reported; false positives
+ * are reported targets that are not in the frame; RMSE is over the corners
+ * of correctly reported targets
+ */
+function scoreFrame(accuracy, results, truth) {
+  accuracy.frames++;
+  const visible = Object.keys(truth);
+  if (visible.length > 0) accuracy.gtFrames++;
+
+  let recalled = false;
+  for (const result of results) {
+    if (!result.success || !result.corners) continue;
+    const quad = truth[result.targetId];
+    if (!quad) {
+      accuracy.falsePositives++;
+      continue;
+    }
+    recalled = true;
+    for (let c = 0; c < 4; c++) {
+      const dx = result.corners[c].x - quad[c][0];
+      const dy = result.corners[c].y - quad[c][1];
+      accuracy.squaredError += dx * dx + dy * dy;
+      accuracy.corners++;
+    }
+  }
+  if (recalled) accuracy.recalled++;
+}
+
+/**
+ * Regressions of one build/sequence result against its baseline entry
+ * @returns {Array<string>}
+ */
+function compare(result, baseline) {
+  const regressions = [];
+
+  // Machine speed now relative to when the baseline was recorded
+  const speed = result.calibrationMs && baseline.calibrationMs
+    ? result.calibrationMs / baseline.calibrationMs
+    : 1;
+  for (const span of CHECKED_SPANS) {
+    const now = result.latency[span];
+    const then = baseline.latency[span];
+    if (!now || !then) continue;
+    for (const stat of Object.keys(TOLERANCE.latency)) {
+      if (now[stat] === undefined || then[stat] === undefined) continue;
+      if (now[stat] > then[stat] * speed * (1 + TOLERANCE.latency[stat])) {
+        regressions.push(`${span} ${stat} ${then[stat]} -> ${now[stat]} ms (machine speed x${round(speed)})`);
+      }
+    }
+  }
+
+  const a = result.accuracy;
+  const b = baseline.accuracy;
+  if (b.recall !== null && (a.recall === null || a.recall < b.recall - TOLERANCE.recall)) {
+    regressions.push(`recall ${b.recall} -> ${a.recall}`);
+  }
+  if (b.rmse !== null && a.rmse !== null && a.rmse > b.rmse + TOLERANCE.rmse) {
+    regressions.push(`rmse ${b.rmse} -> ${a.rmse} px`);
+  }
+  if (a.falsePositives > b.falsePositives) {
+    regressions.push(`false positives ${b.falsePositives} -> ${a.falsePositives}`);
+  }
+  for (const key of ['wasmGrowthMB', 'jsGrowthMB']) {
+    if (result.heap[key] > Math.max(0, baseline.heap[key]) + TOLERANCE.heapMB) {
+      regressions.push(`${key} ${baseline.heap[key]} -> ${result.heap[key]}`);
+    }
+  }
+  return regressions;
+}
+
+function machine() {
+  const cpus = os.cpus();
+  return { cpu: cpus.length ? cpus[0].model : 'unknown', cores: cpus.length, node: process.version, platform: process.platform };
+}
+
+function printResults(results) {
+  const names = [...new Set(Object.values(results).flatMap(r => Object.keys(r.sequences)))];
+  const cell = (value, width = 12) => String(value === null || value === undefined ? '-' : value).padStart(width);
+
+  for (const name of names) {
+    const builds = Object.keys(results).filter(build => results[build].sequences[name]);
+    const first = results[builds[0]].sequences[name];
+    console.log(`\n${name}: ${first.frames} frames x ${first.passes} passes, ${first.targets} targets`);
+
+    console.log(['ms (p50 / p95 / mean)'.padEnd(32), ...builds.map(build => cell(build, 22))].join(''));
+    const labels = [...new Set(builds.flatMap(build => Object.keys(results[build].sequences[name].latency)))];
+    for (const label of labels) {
+      const cells = builds.map(build => {
+        const span = results[build].sequences[name].latency[label];
+        const mean = span && span.mean !== undefined ? ` / ${span.mean.toFixed(1)}` : '';
+        return cell(span ? `${span.p50.toFixed(1)} / ${span.p95.toFixed(1)}${mean}` : '-', 22);
+      });
+      console.log([label.padEnd(32), ...cells].join(''));
+    }
+
+    const rows = [
+      ['recall', r => r.accuracy.recall],
+      ['false positives', r => r.accuracy.falsePositives],
+      ['corner rmse (px)', r => r.accuracy.rmse],
+      ['wasm heap growth (MB)', r => r.heap.wasmGrowthMB],
+      ['wasm memory (MB)', r => r.heap.wasmMemoryMB],
+      ['js heap growth (MB)', r => r.heap.jsGrowthMB],
+      ['album build (ms)', r => r.setupMs],
+      ['calibration (ms)', r => r.calibrationMs]
+    ];
+    for (const [label, read] of rows) {
+      console.log([label.padEnd(32), ...builds.map(build => cell(read(results[build].sequences[name]), 22))].join(''));
+    }
+  }
+}
+
+function runParent(options) {
+  const results = {};
+  for (const build of options.builds) {
+    if (!fs.existsSync(path.join(ROOT, 'opencv_builds', build, 'opencv.js'))) {
+      console.warn(`${build}: not built, skipped`);
+      continue;
+    }
+    const args = ['--expose-gc', __filename, '--child', build, JSON.stringify(options)];
+    try {
+      const output = execFileSync(process.execPath, args, {
+        encoding: 'utf8',
+        stdio: ['ignore', 'pipe', 'inherit'],
+        timeout: 1800000,
+        maxBuffer: 64 << 20
+      });
+      results[build] = JSON.parse(output.trim().split('\n').pop());
+    } catch (error) {
+      console.warn(`${build}: failed (${error.message.split('\n')[0]})`);
+    }
+  }
+
+  const host = machine();
+  console.log(`Tracking benchmark, ${host.cores} core(s), ${host.cpu}, node ${host.node}`);
+  printResults(results);
+
+  const baseline = fs.existsSync(BASELINE_FILE) ? JSON.parse(fs.readFileSync(BASELINE_FILE, 'utf8')) : null;
+  let regressions = 0;
+  if (baseline) {
+    if (baseline.machine.cpu !== host.cpu || baseline.machine.cores !== host.cores) {
+      console.log(`\nBaseline was recorded on ${baseline.machine.cores} core(s), ${baseline.machine.cpu}; ` +
+        'latency comparisons are only indicative');
+    }
+    console.log(`\nAgainst baseline (${baseline.updated}):`);
+    for (const build of Object.keys(results)) {
+      for (const [name, result] of Object.entries(results[build].sequences)) {
+        const entry = baseline.results[build]?.[name];
+        if (!entry) continue;
+        const found = compare(result, entry);
+        regressions += found.length;
+        console.log(`  ${build} / ${name}: ${found.length ? found.join(', ') : 'ok'}`);
+      }
+    }
+  }
+
+  if (options.updateBaseline) {
+    const stored = baseline && !options.builds.every(build => results[build]) ? baseline.results : {};
+    for (const build of Object.keys(results)) {
+      stored[build] = results[build].sequences;
+    }
+    fs.writeFileSync(BASELINE_FILE, JSON.stringify({
+      updated: new Date().toISOString().slice(0, 10),
+      machine: host,
+      tolerance: TOLERANCE,
+      results: stored
+    }, null, 2) + '\n');
+    console.log(`\n✓ Baseline written to ${path.relative(ROOT, BASELINE_FILE)}`);
+  } else if (options.check && (regressions > 0 || Object.keys(results).length === 0)) {
+    process.exit(1);
+  }
+}
+
+async function writeSynthetic(dir) {
+  const cv = await loadBuild('simd');
+  const sequence = sequences.syntheticSequence(cv);
+  sequences.writeSequence(sequence, dir);
+  sequence.release();
+  console.log(`✓ Wrote ${sequence.frameCount} frames to ${dir}`);
+}
+
+if (process.argv[2] === '--child') {
+  runBuild(process.argv[3], JSON.parse(process.argv[4]))
+    .then(result => {
+      process.stdout.write(JSON.stringify(result) + '\n');
+      process.exit(0); // pthread pools keep the process alive
+    })
+    .catch(error => {
+      console.error(error);
+      process.exit(1);
+    });
+} else {
+  const options = parseArgs(process.argv.slice(2));
+  if (options.writeSynthetic) {
+    writeSynthetic(options.writeSynthetic).then(() => process.exit(0));
+  } else {
+    runParent(options);
+  }
+}
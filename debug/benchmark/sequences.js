@@ -0,0 +1,275 @@
+/**
+ * Benchmark sequences: on-disk format, PGM I/O and the built-in synthetic clip
+ *
+ * A sequence is a directory with a sequence.json:
+ *
+ *   {
+ *     "name": "desk-handheld",
+ *     "width": 640, "height": 480,
+ *     "targets": [{"id": "poster", "image": "targets/poster.pgm"}],
+ *     "frames": [
+ *       {"image": "frames/00001.pgm", "corners": {"poster": [[x, y], [x, y], [x, y], [x, y]]}},
+ *       ...
+ *     ]
+ *   }
+ *
+ * Images are 8-bit binary PGM (P5) at processing resolution. Corners are
+ * in frame pixels, ordered like FeatureDetector's output (top-left,
+ * top-right, bottom-right, bottom-left of the target image); a target
+ * missing from a frame's corners is not visible in it. Reports and the
+ * baseline key sequences by directory name.
+ */
+
+const fs = require('fs');
+const path = require('path');
+
+/**
+ * Parse a binary PGM (P5, maxval <= 255)
+ * @param {Buffer} buffer
+ * @returns {Object} {width, height, data: Uint8Array}
+ */
+function parsePGM(buffer) {
+  let offset = 0;
+  const token = () => {
+    for (;;) {
+      while (offset < buffer.length && /\s/.test(String.fromCharCode(buffer[offset]))) offset++;
+      if (buffer[offset] !== 0x23) break; // '#' comment
+      while (offset < buffer.length && buffer[offset] !== 0x0a) offset++;
+    }
+    const start = offset;
+    while (offset < buffer.length && !/\s/.test(String.fromCharCode(buffer[offset]))) offset++;
+    return buffer.toString('ascii', start, offset);
+  };
+
+  if (token() !== 'P5') throw new Error('Not a binary PGM (P5)');
+  const width = parseInt(token(), 10);
+  const height = parseInt(token(), 10);
+  const maxval = parseInt(token(), 10);
+  if (maxval > 255) throw new Error('16-bit PGM is not supported');
+  offset++; // single whitespace before the raster
+
+  if (buffer.length - offset < width * height) throw new Error('Truncated PGM');
+  return { width, height, data: new Uint8Array(buffer.buffer, buffer.byteOffset + offset, width * height) };
+}
+
+/**
+ * @param {string} file
+ * @param {cv.Mat} mat - CV_8UC1
+ */
+function writePGM(file, mat) {
+  fs.mkdirSync(path.dirname(file), { recursive: true });
+  const header = Buffer.from(`P5\n${mat.cols} ${mat.rows}\n255\n`, 'ascii');
+  fs.writeFileSync(file, Buffer.concat([header, Buffer.from(mat.data)]));
+}
+
+function readGray(cv, file) {
+  const image = parsePGM(fs.readFileSync(file));
+  const mat = new cv.Mat(image.height, image.width, cv.CV_8UC1);
+  mat.data.set(image.data);
+  return mat;
+}
+
+/**
+ * Load a sequence directory; frames are decoded lazily by frame(i)
+ * @returns {Object} {name, width, height, targets: [{id, mat}], frameCount,
+ *   frame(i) -> cv.Mat (caller deletes), corners(i) -> {id: [[x, y] x4]}, release()}
+ */
+function loadSequence(cv, dir) {
+  const spec = JSON.parse(fs.readFileSync(path.join(dir, 'sequence.json'), 'utf8'));
+  const targets = spec.targets.map(target => ({
+    id: target.id,
+    mat: readGray(cv, path.join(dir, target.image))
+  }));
+
+  return {
+    name: path.basename(dir), // Unique key in reports and the baseline
+    width: spec.width,
+    height: spec.height,
+    targets,
+    frameCount: spec.frames.length,
+    frame: (i) => readGray(cv, path.join(dir, spec.frames[i].image)),
+    corners: (i) => spec.frames[i].corners || {},
+    release: () => targets.forEach(target => target.mat.delete())
+  };
+}
+
+/**
+ * Every sequence directory under root (those holding a sequence.json)
+ * @returns {Array<string>}
+ */
+function findSequences(root) {
+  if (!fs.existsSync(root)) return [];
+  return fs.readdirSync(root)
+    .map(name => path.join(root, name))
+    .filter(dir => fs.existsSync(path.join(dir, 'sequence.json')))
+    .sort();
+}
+
+/**
+ * Per-pixel hash noise (mulberry32 of seed and index); unlike an LCG
+ * stream, different seeds give unrelated images
+ */
+function hashByte(seed, i) {
+  let t = (Math.imul(seed, 0x9e3779b1) + Math.imul(i, 0x85ebca6b)) | 0;
+  t = Math.imul(t ^ (t >>> 15), t | 1);
+  t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+  return ((t ^ (t >>> 14)) >>> 0) >>> 24;
+}
+
+/**
+ * Textured image with structure at several scales, so ORB finds corners
+ * across pyramid levels
+ */
+function texture(cv, seed, width, height) {
+  const result = new cv.Mat(height, width, cv.CV_8UC1, new cv.Scalar(0));
+  let weight = 0.5;
+  for (const cell of [32, 8, 2]) {
+    const coarse = new cv.Mat(Math.ceil(height / cell), Math.ceil(width / cell), cv.CV_8UC1);
+    for (let i = 0; i < coarse.data.length; i++) {
+      coarse.data[i] = hashByte(seed + cell, i);
+    }
+    const layer = new cv.Mat();
+    cv.resize(coarse, layer, new cv.Size(width, height), 0, 0, cell > 2 ? cv.INTER_CUBIC : cv.INTER_NEAREST);
+    cv.addWeighted(result, 1, layer, weight, 0, result);
+    coarse.delete();
+    layer.delete();
+    weight *= 0.6;
+  }
+  cv.GaussianBlur(result, result, new cv.Size(3, 3), 0.8);
+  return result;
+}
+
+/**
+ * Corners of a target at time t along a smooth handheld-like path
+ */
+function pathCorners(t, motion, width, height) {
+  const { cx, cy, ax, ay, scale, size } = motion;
+  const s = scale * (1 + 0.2 * Math.sin(t * 0.021 + motion.phase));
+  const angle = 0.35 * Math.sin(t * 0.017 + motion.phase);
+  const keystone = 0.12 * Math.sin(t * 0.013 + motion.phase);
+  const centerX = cx * width + ax * Math.sin(t * 0.043 + motion.phase);
+  const centerY = cy * height + ay * Math.sin(t * 0.031 + motion.phase);
+  const w2 = size[0] * s / 2;
+  const h2 = size[1] * s / 2;
+  const local = [[-w2 * (1 - keystone), -h2], [w2 * (1 - keystone), -h2],
+    [w2 * (1 + keystone), h2], [-w2 * (1 + keystone), h2]];
+  const cos = Math.cos(angle);
+  const sin = Math.sin(angle);
+  return local.map(([x, y]) => [centerX + x * cos - y * sin, centerY + x * sin + y * cos]);
+}
+
+const SYNTHETIC_TARGETS = [
+  {
+    id: 'synthetic-a', seed: 1101, size: [320, 240], visible: [8, 110],
+    motion: { cx: 0.45, cy: 0.5, ax: 90, ay: 40, scale: 0.9, phase: 0 }
+  },
+  {
+    id: 'synthetic-b', seed: 2203, size: [240, 320], visible: [70, 150],
+    motion: { cx: 0.72, cy: 0.48, ax: 40, ay: 30, scale: 0.7, phase: 1.7 }
+  }
+];
+
+/**
+ * Deterministic built-in clip: two textured targets composited onto a
+ * drifting background with per-frame sensor noise. Target A enters after a
+ * few empty frames, B overlaps it for a while, then A leaves; the last
+ * frames have no targets at all.
+ * @returns {Object} Same shape as loadSequence()
+ */
+function syntheticSequence(cv, options = {}) {
+  const width = options.width || 640;
+  const height = options.height || 480;
+  const frameCount = options.frames || 165;
+
+  const targets = SYNTHETIC_TARGETS.map(spec => ({
+    id: spec.id,
+    spec,
+    mat: texture(cv, spec.seed, spec.size[0], spec.size[1])
+  }));
+  const background = texture(cv, 77, width + 64, height + 64);
+  cv.addWeighted(background, 0.6, background, 0, 50, background); // lower contrast than the targets
+
+  const corners = (i) => {
+    const result = {};
+    for (const target of targets) {
+      const [from, to] = target.spec.visible;
+      if (i >= from && i < to) {
+        result[target.id] = pathCorners(i, { ...target.spec.motion, size: target.spec.size }, width, height);
+      }
+    }
+    return result;
+  };
+
+  const frame = (i) => {
+    // Background drifts like a slowly panning camera
+    const shift = cv.matFromArray(2, 3, cv.CV_64F, [
+      1, 0, -32 + 20 * Math.sin(i * 0.05), 0, 1, -32 + 14 * Math.sin(i * 0.037)
+    ]);
+    const out = new cv.Mat();
+    cv.warpAffine(background, out, shift, new cv.Size(width, height));
+    shift.delete();
+
+    const visible = corners(i);
+    for (const target of targets) {
+      const quad = visible[target.id];
+      if (!quad) continue;
+      const [w, h] = target.spec.size;
+      const src = cv.matFromArray(4, 1, cv.CV_32FC2, [0, 0, w, 0, w, h, 0, h]);
+      const dst = cv.matFromArray(4, 1, cv.CV_32FC2, quad.flat());
+      const homography = cv.getPerspectiveTransform(src, dst);
+      cv.warpPerspective(target.mat, out, homography, new cv.Size(width, height),
+        cv.INTER_LINEAR, cv.BORDER_TRANSPARENT, new cv.Scalar());
+      [src, dst, homography].forEach(m => m.delete());
+    }
+
+    // Sensor noise, different every frame
+    const data = out.data;
+    for (let p = 0; p < data.length; p++) {
+      const value = data[p] + ((hashByte(9000 + i, p) - 128) >> 4);
+      data[p] = value < 0 ? 0 : value > 255 ? 255 : value;
+    }
+    return out;
+  };
+
+  return {
+    name: 'synthetic',
+    width,
+    height,
+    targets: targets.map(({ id, mat }) => ({ id, mat })),
+    frameCount,
+    frame,
+    corners,
+    release: () => {
+      targets.forEach(target => target.mat.delete());
+      background.delete();
+    }
+  };
+}
+
+/**
+ * Write a sequence in the on-disk format (e.g. to inspect the synthetic clip)
+ */
+function writeSequence(sequence, dir) {
+  const spec = {
+    name: sequence.name,
+    width: sequence.width,
+    height: sequence.height,
+    targets: sequence.targets.map(target => ({ id: target.id, image: `targets/${target.id}.pgm` })),
+    frames: []
+  };
+  for (const target of sequence.targets) {
+    writePGM(path.join(dir, 'targets', `${target.id}.pgm`), target.mat);
+  }
+  for (let i = 0; i < sequence.frameCount; i++) {
+    const image = `frames/${String(i + 1).padStart(5, '0')}.pgm`;
+    const frame = sequence.frame(i);
+    writePGM(path.join(dir, image), frame);
+    frame.delete();
+    const round = (quad) => quad.map(([x, y]) => [Math.round(x * 100) / 100, Math.round(y * 100) / 100]);
+    const corners = Object.fromEntries(Object.entries(sequence.corners(i)).map(([id, quad]) => [id, round(quad)]));
+    spec.frames.push({ image, corners });
+  }
+  fs.writeFileSync(path.join(dir, 'sequence.json'), JSON.stringify(spec, null, 2) + '\n');
+}
+
+module.exports = { parsePGM, writePGM, loadSequence, findSequences, syntheticSequence, writeSequence };
@@ -7,20 +7,33 @@
 // Load all module scripts in order
 (function() {
     const scripts = [
+        './modules/utils/Logger.js',
         './modules/utils/PerformanceProfiler.js',
+        './modules/utils/MatPool.js',
         './modules/utils/DebugExporter.js',
+        './modules/cache/VocabularyCodec.js',
+        './modules/cache/AlbumContentCache.js',
         './modules/cache/CacheManager.js',
         './modules/utils/AlbumManager.js',
         './modules/utils/ProgressManager.js',
+        './modules/database/FlatVocabularyTree.js',
         './modules/database/VocabularyTreeQuery.js',
         './modules/database/VocabularyBuilder.js',
+        './modules/workers/VocabularyWorkerPool.js',
+        './modules/database/ZipArchiveReader.js',
         './modules/database/ZipDatabaseLoader.js',
         './modules/ui/UIManager.js',
         './modules/ui/OfflineManager.js',
         './modules/camera/CameraManager.js',
+        './modules/camera/FrameScheduler.js',
+        './modules/reference/ReferenceCache.js',
         './modules/reference/ReferenceImageManager.js',
+        './modules/detection/BatchedMatcher.js',
         './modules/detection/FeatureDetector.js',
         './modules/tracking/OpticalFlowTracker.js',
+        './modules/core/TrackingPipeline.js',
+        './modules/core/QualityGovernor.js',
+        './modules/workers/VisionWorkerClient.js',
         './modules/visualization/Visualizer.js',
         './modules/rendering/VideoManager.js',
         './modules/core/ViewportManager.js',
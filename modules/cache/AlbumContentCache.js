@@ -0,0 +1,401 @@
+/**
+ * AlbumContentCache - Extracted album files in Cache Storage
+ *
+ * Every album is one cache, "webar-album-<key>" (key = SHA-256 prefix of the
+ * album code), holding its photos, videos and encoded vocabulary tree as
+ * separate entries under album-cache/<key>/<name>. A cached album loads
+ * without downloading or unzipping anything, and sw.js answers the <video>
+ * element's Range requests for those URLs, so playback streams from disk
+ * instead of a blob URL over the whole file.
+ *
+ * The vocabulary entry is named after the config signature: a config change
+ * misses it, and storing the rebuilt tree replaces it. An index of album
+ * sizes and last use keeps the total under AppConfig.album.contentCacheMB by
+ * evicting the least recently opened albums. The index is written before an
+ * album's cache, so a store cut short (tab closed, quota error) is still in
+ * it, and the first open sweeps away album caches the index does not count.
+ */
+class AlbumContentCache {
+  /**
+   * @param {Object} options - {budgetMB, ttl, baseUrl}
+   */
+  constructor(options = {}) {
+    const config = (typeof AppConfig !== 'undefined' && AppConfig.album) || {};
+    this.budgetBytes = (options.budgetMB ?? config.contentCacheMB ?? 512) * 1048576;
+    this.ttl = options.ttl ?? 7 * 24 * 60 * 60 * 1000; // Same expiry as CacheManager
+    this.baseUrl = new URL(AlbumContentCache.PATH, options.baseUrl || self.location.href).href;
+    this.keys = new Map(); // albumCode -> Promise<key>
+    this.indexQueue = Promise.resolve(); // Serializes index read-modify-write
+    this.swept = null; // Promise of the one sweep() per instance
+  }
+
+  /**
+   * Cache Storage and SubtleCrypto need a secure context
+   * @returns {boolean}
+   */
+  static isSupported() {
+    return typeof caches !== 'undefined' && typeof crypto !== 'undefined' && !!crypto.subtle;
+  }
+
+  /**
+   * Whether sw.js controls this page, so entry URLs can be played directly
+   * @returns {boolean}
+   */
+  static isServed() {
+    return typeof navigator !== 'undefined' && !!navigator.serviceWorker &&
+      !!navigator.serviceWorker.controller;
+  }
+
+  /**
+   * @private
+   */
+  albumKey(albumCode) {
+    let key = this.keys.get(albumCode);
+    if (!key) {
+      key = crypto.subtle.digest('SHA-256', new TextEncoder().encode(albumCode)).then(digest =>
+        Array.from(new Uint8Array(digest).subarray(0, 8), b => b.toString(16).padStart(2, '0')).join('')
+      );
+      this.keys.set(albumCode, key);
+    }
+    return key;
+  }
+
+  /**
+   * @private
+   */
+  entryUrl(key, name) {
+    return `${this.baseUrl}${key}/${encodeURIComponent(name)}`;
+  }
+
+  /**
+   * @private
+   */
+  async openAlbumCache(key) {
+    if (!this.swept) {
+      this.swept = this.sweep().catch(error => console.warn('[AlbumCache] Sweep failed:', error));
+    }
+    await this.swept;
+    return caches.open(AlbumContentCache.CACHE_PREFIX + key);
+  }
+
+  /**
+   * Delete album caches the index does not account for: ones without an
+   * index entry, and ones whose storeEntries() is still pending after
+   * PENDING_TIMEOUT (cut short, so its files were never counted)
+   * @private
+   */
+  async sweep() {
+    const prefix = AlbumContentCache.CACHE_PREFIX;
+    const present = new Set((await caches.keys())
+      .filter(name => name.startsWith(prefix) && name !== AlbumContentCache.INDEX_CACHE)
+      .map(name => name.slice(prefix.length)));
+
+    const orphans = [];
+    await this.updateIndex(index => {
+      for (const key of present) {
+        if (!index[key]) orphans.push(key);
+      }
+      const now = Date.now();
+      for (const [key, entry] of Object.entries(index)) {
+        if (!entry.pending || now - entry.pending < AlbumContentCache.PENDING_TIMEOUT) continue;
+        delete index[key];
+        if (present.has(key)) orphans.push(key);
+      }
+    });
+
+    for (const key of orphans) {
+      await caches.delete(prefix + key);
+      console.log(`[AlbumCache] Removed incomplete album ${key}`);
+    }
+  }
+
+  /**
+   * A complete, unexpired cached album; marks it as most recently used
+   * @param {string} albumCode
+   * @returns {Promise<CachedAlbum|null>}
+   */
+  async getAlbum(albumCode) {
+    const key = await this.albumKey(albumCode);
+    if (!(await caches.has(AlbumContentCache.CACHE_PREFIX + key))) return null;
+
+    const cache = await this.openAlbumCache(key);
+    const response = await cache.match(this.entryUrl(key, AlbumContentCache.MANIFEST));
+    if (!response) return null;
+
+    const manifest = await response.json();
+    if (Date.now() - manifest.created > this.ttl) {
+      console.log(`[AlbumCache] Album ${key} expired`);
+      await this.deleteAlbum(albumCode);
+      return null;
+    }
+
+    await this.updateIndex(index => {
+      if (index[key]) index[key].lastUsed = Date.now();
+    });
+    console.log(`[AlbumCache] Album ${key} found (${manifest.entries.length} files)`);
+    return new CachedAlbum(this, key, cache, manifest.entries);
+  }
+
+  /**
+   * Mark the album pending in the index, write its files one at a time so
+   * at most one is in memory, then its manifest; evicts other albums beyond
+   * the budget
+   * @param {string} albumCode
+   * @param {Array<{name, type, read}>} entries - read() resolves to a Blob
+   */
+  async storeEntries(albumCode, entries) {
+    const key = await this.albumKey(albumCode);
+    // Before the cache exists, so a sweep in another tab never sees it unindexed
+    await this.updateIndex(index => {
+      AlbumContentCache.indexEntry(index, key).pending = Date.now();
+    });
+    const cache = await this.openAlbumCache(key);
+
+    const stored = [];
+    let bytes = 0;
+
+    for (const { name, type, read } of entries) {
+      const blob = await read();
+      await cache.put(this.entryUrl(key, name), AlbumContentCache.response(blob, type));
+      stored.push({ name, type: type || blob.type, size: blob.size });
+      bytes += blob.size;
+    }
+
+    const manifest = { created: Date.now(), entries: stored };
+    await cache.put(this.entryUrl(key, AlbumContentCache.MANIFEST),
+      AlbumContentCache.response(new Blob([JSON.stringify(manifest)]), 'application/json'));
+
+    await this.updateIndex(index => {
+      const entry = AlbumContentCache.indexEntry(index, key);
+      entry.contentBytes = bytes;
+      entry.lastUsed = Date.now();
+      delete entry.pending;
+    });
+    await this.evict(key);
+    console.log(`[AlbumCache] Album ${key} stored (${stored.length} files, ${(bytes / 1048576).toFixed(1)} MB)`);
+  }
+
+  /**
+   * Store one file of an album outside its manifest; a file with the same
+   * `group` (e.g. the vocabulary of another config) is replaced
+   * @param {string} albumCode
+   * @param {string} name
+   * @param {ArrayBuffer|Blob} data
+   * @param {Object} options - {type, group}
+   */
+  async storeFile(albumCode, name, data, options = {}) {
+    const key = await this.albumKey(albumCode);
+    const blob = data instanceof Blob ? data : new Blob([data]);
+    const group = options.group || name;
+
+    // Counted before the cache is opened and written, so an interrupted put
+    // is never unaccounted
+    let replaced = null;
+    await this.updateIndex(index => {
+      const entry = AlbumContentCache.indexEntry(index, key);
+      const previous = entry.files[group];
+      if (previous && previous.name !== name) replaced = previous.name;
+      entry.files[group] = { name, size: blob.size, created: Date.now() };
+      entry.lastUsed = Date.now();
+    });
+
+    const cache = await this.openAlbumCache(key);
+    await cache.put(this.entryUrl(key, name), AlbumContentCache.response(blob, options.type));
+    if (replaced) await cache.delete(this.entryUrl(key, replaced));
+    await this.evict(key);
+  }
+
+  /**
+   * @param {string} albumCode
+   * @param {string} name
+   * @returns {Promise<ArrayBuffer|null>} null when missing or expired
+   */
+  async readFile(albumCode, name) {
+    const key = await this.albumKey(albumCode);
+    const index = await this.readIndex();
+    const file = index[key] && Object.values(index[key].files).find(f => f.name === name);
+    if (!file || Date.now() - file.created > this.ttl) return null;
+
+    const cache = await this.openAlbumCache(key);
+    const response = await cache.match(this.entryUrl(key, name));
+    return response ? response.arrayBuffer() : null;
+  }
+
+  /**
+   * Remove one file stored with storeFile()
+   */
+  async deleteFile(albumCode, name) {
+    const key = await this.albumKey(albumCode);
+    const cache = await this.openAlbumCache(key);
+    await cache.delete(this.entryUrl(key, name));
+    await this.updateIndex(index => {
+      const entry = index[key];
+      if (!entry) return;
+      for (const [group, file] of Object.entries(entry.files)) {
+        if (file.name === name) delete entry.files[group];
+      }
+    });
+  }
+
+  async deleteAlbum(albumCode) {
+    const key = await this.albumKey(albumCode);
+    await caches.delete(AlbumContentCache.CACHE_PREFIX + key);
+    await this.updateIndex(index => {
+      delete index[key];
+    });
+  }
+
+  /**
+   * Drop least recently used albums (never `keepKey`) until within budget
+   * @private
+   */
+  async evict(keepKey) {
+    const evicted = [];
+    await this.updateIndex(index => {
+      let total = Object.values(index).reduce((sum, entry) => sum + AlbumContentCache.entryBytes(entry), 0);
+      const oldestFirst = Object.keys(index)
+        .filter(key => key !== keepKey)
+        .sort((a, b) => index[a].lastUsed - index[b].lastUsed);
+
+      for (const key of oldestFirst) {
+        if (total <= this.budgetBytes) break;
+        total -= AlbumContentCache.entryBytes(index[key]);
+        delete index[key];
+        evicted.push(key);
+      }
+    });
+
+    for (const key of evicted) {
+      await caches.delete(AlbumContentCache.CACHE_PREFIX + key);
+      console.log(`[AlbumCache] Evicted album ${key}`);
+    }
+  }
+
+  /**
+   * Remove every cached album
+   */
+  async clear() {
+    const names = await caches.keys();
+    await Promise.all(names
+      .filter(name => name.startsWith(AlbumContentCache.CACHE_PREFIX) || name === AlbumContentCache.INDEX_CACHE)
+      .map(name => caches.delete(name)));
+  }
+
+  /**
+   * @returns {Promise<Object>} {albums, vocabularies, bytes}
+   */
+  async getStats() {
+    const index = await this.readIndex();
+    const entries = Object.values(index);
+    return {
+      albums: entries.filter(entry => entry.contentBytes > 0).length,
+      vocabularies: entries.filter(entry => entry.files.vocabulary).length,
+      bytes: entries.reduce((sum, entry) => sum + AlbumContentCache.entryBytes(entry), 0)
+    };
+  }
+
+  /**
+   * @private
+   * @returns {Promise<Object>} key -> {lastUsed, contentBytes, files: {group: {name, size, created}},
+   *   pending} (pending: start time of an unfinished storeEntries())
+   */
+  async readIndex() {
+    const cache = await caches.open(AlbumContentCache.INDEX_CACHE);
+    const response = await cache.match(`${this.baseUrl}${AlbumContentCache.INDEX}`);
+    return response ? response.json() : {};
+  }
+
+  /**
+   * Read, modify and write the index, one update at a time
+   * @private
+   */
+  updateIndex(update) {
+    const run = this.indexQueue.then(async () => {
+      const index = await this.readIndex();
+      update(index);
+      const cache = await caches.open(AlbumContentCache.INDEX_CACHE);
+      await cache.put(`${this.baseUrl}${AlbumContentCache.INDEX}`,
+        AlbumContentCache.response(new Blob([JSON.stringify(index)]), 'application/json'));
+    });
+    this.indexQueue = run.catch(() => {});
+    return run;
+  }
+
+  static indexEntry(index, key) {
+    if (!index[key]) {
+      index[key] = { lastUsed: Date.now(), contentBytes: 0, files: {} };
+    }
+    return index[key];
+  }
+
+  static entryBytes(entry) {
+    return entry.contentBytes + Object.values(entry.files).reduce((sum, file) => sum + file.size, 0);
+  }
+
+  /**
+   * @private
+   */
+  static response(blob, type) {
+    return new Response(blob, {
+      headers: {
+        'Content-Type': type || blob.type || 'application/octet-stream',
+        'Content-Length': String(blob.size)
+      }
+    });
+  }
+}
+
+// sw.js relies on the same names to find entries
+AlbumContentCache.CACHE_PREFIX = 'webar-album-';
+AlbumContentCache.INDEX_CACHE = 'webar-album-index';
+AlbumContentCache.PATH = 'album-cache/';
+AlbumContentCache.MANIFEST = 'manifest.json';
+AlbumContentCache.INDEX = 'index.json';
+AlbumContentCache.PENDING_TIMEOUT = 15 * 60 * 1000; // A store still pending after this was cut short
+
+/**
+ * One cached album, as handed to ZipDatabaseLoader.loadFromZip()
+ */
+class CachedAlbum {
+  constructor(contentCache, key, cache, entries) {
+    this.contentCache = contentCache;
+    this.key = key;
+    this.cache = cache;
+    this.entries = entries; // [{name, type, size}]
+  }
+
+  /**
+   * URL of an entry; only fetchable while sw.js controls the page
+   * @param {string} name
+   * @returns {string}
+   */
+  url(name) {
+    return this.contentCache.entryUrl(this.key, name);
+  }
+
+  /**
+   * Whether videos can play from url() instead of a blob URL
+   * @returns {boolean}
+   */
+  get streamable() {
+    return AlbumContentCache.isServed();
+  }
+
+  /**
+   * @param {string} name
+   * @returns {Promise<Blob>} Backed by Cache Storage, not the JS heap
+   */
+  async read(name) {
+    const response = await this.cache.match(this.url(name));
+    if (!response) {
+      throw new Error(`Cached album entry missing: ${name}`);
+    }
+    return response.blob();
+  }
+}
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.AlbumContentCache = AlbumContentCache;
+  window.CachedAlbum = CachedAlbum;
+}
@@ -1,6 +1,10 @@
 /**
  * CacheManager - IndexedDB storage for albums, videos, and vocabulary trees
  * Handles persistent caching with TTL support
+ *
+ * Where Cache Storage is available, albums are kept extracted in
+ * AlbumContentCache (this.contentCache) and vocabulary trees go there too;
+ * the IndexedDB stores remain for insecure contexts and older entries.
  */
 
 class CacheManager {
@@ -9,6 +13,9 @@ class CacheManager {
     this.dbVersion = 1;
     this.db = null;
     this.cacheTTL = 7 * 24 * 60 * 60 * 1000; // 7 days in milliseconds
+    this.contentCache = typeof AlbumContentCache !== 'undefined' && AlbumContentCache.isSupported()
+      ? new AlbumContentCache({ ttl: this.cacheTTL })
+      : null;
 
     // Store names
     this.stores = {
@@ -270,8 +277,20 @@ class CacheManager {
 
   /**
    * Store vocabulary tree with version metadata
+   * The database is packed into one ArrayBuffer (VocabularyCodec) so the
+   * warm start is a single read with no per-descriptor rehydration
    */
   async storeVocabulary(albumCode, vocabularyData) {
+    const vocabularyBuffer = VocabularyCodec.encode(vocabularyData);
+
+    if (this.contentCache) {
+      await this.contentCache.storeFile(albumCode, this.vocabularyFileName(), vocabularyBuffer,
+        { type: 'application/octet-stream', group: 'vocabulary' });
+      console.log(`[Cache] Vocabulary for ${albumCode} stored in album cache (${this.formatSize(
+        vocabularyBuffer.byteLength)})`);
+      return;
+    }
+
     if (!this.db) await this.init();
 
     return new Promise((resolve, reject) => {
@@ -285,7 +304,9 @@ class CacheManager {
 
       const data = {
         albumCode,
-        vocabularyData,
+        vocabularyBuffer,
+        format: VocabularyCodec.FORMAT_VERSION,
+        size: vocabularyBuffer.byteLength,
         timestamp: Date.now(),
         // Store version metadata for quick validation
         version: {
@@ -297,7 +318,8 @@ class CacheManager {
       const request = store.put(data);
 
       request.onsuccess = () => {
-        console.log(`[Cache] Vocabulary for ${albumCode} stored (v${dbVersion})`);
+        console.log(`[Cache] Vocabulary for ${albumCode} stored (v${dbVersion}, ${this.formatSize(
+          vocabularyBuffer.byteLength)})`);
         resolve();
       };
 
@@ -310,8 +332,22 @@ class CacheManager {
 
   /**
    * Retrieve vocabulary tree with version validation
+   * @returns {Promise<Object|null>} Decoded database (typed-array views into
+   *   the stored buffer), or null when missing, expired or in an old format
    */
   async getVocabulary(albumCode) {
+    const readStart = performance.now();
+
+    if (this.contentCache) {
+      const buffer = await this.contentCache.readFile(albumCode, this.vocabularyFileName());
+      const vocabularyData = buffer ? VocabularyCodec.decode(buffer) : null;
+      if (vocabularyData) {
+        console.log(`[Cache] Vocabulary for ${albumCode} found in album cache (${this.formatSize(
+          buffer.byteLength)}, read in ${(performance.now() - readStart).toFixed(1)}ms)`);
+        return vocabularyData;
+      }
+    }
+
     if (!this.db) await this.init();
 
     return new Promise((resolve, reject) => {
@@ -338,16 +374,24 @@ class CacheManager {
           return;
         }
 
-        // Log version information (detailed validation happens in VocabularyBuilder)
-        if (result.version) {
-          const dbVersion = result.version.database_version;
-          const cacheAge = Math.floor(age / (24 * 60 * 60 * 1000));
-          console.log(`[Cache] Vocabulary for ${albumCode} found (v${dbVersion}, ${cacheAge} days old)`);
-        } else {
-          console.log(`[Cache] Vocabulary for ${albumCode} found (legacy, no version info)`);
+        // Object-shaped entries from before the binary format are rebuilt
+        const vocabularyData = result.vocabularyBuffer
+          ? VocabularyCodec.decode(result.vocabularyBuffer)
+          : null;
+        if (!vocabularyData) {
+          console.log(`[Cache] Vocabulary for ${albumCode} is in an old format, rebuilding`);
+          this.deleteVocabulary(albumCode);
+          resolve(null);
+          return;
         }
 
-        resolve(result.vocabularyData);
+        // Log version information (detailed validation happens in VocabularyBuilder)
+        const dbVersion = result.version?.database_version || 'unknown';
+        const cacheAge = Math.floor(age / (24 * 60 * 60 * 1000));
+        console.log(`[Cache] Vocabulary for ${albumCode} found (v${dbVersion}, ${cacheAge} days old,` +
+          ` ${this.formatSize(result.size)}, read in ${(performance.now() - readStart).toFixed(1)}ms)`);
+
+        resolve(vocabularyData);
       };
 
       request.onerror = () => {
@@ -361,6 +405,10 @@ class CacheManager {
    * Delete vocabulary from cache
    */
   async deleteVocabulary(albumCode) {
+    if (this.contentCache) {
+      await this.contentCache.deleteFile(albumCode, this.vocabularyFileName());
+    }
+
     if (!this.db) await this.init();
 
     return new Promise((resolve, reject) => {
@@ -381,6 +429,14 @@ class CacheManager {
     });
   }
 
+  /**
+   * Album cache entry of the vocabulary built with the current config
+   * @returns {string}
+   */
+  vocabularyFileName() {
+    return `vocabulary-${AppConfig.database.getConfigSignature()}.bin`;
+  }
+
   /**
    * Clean up expired cache entries across all stores
    */
@@ -495,6 +551,14 @@ class CacheManager {
         };
       });
 
+      if (this.contentCache) {
+        const content = await this.contentCache.getStats();
+        stats.albums.count += content.albums;
+        stats.albums.size += content.bytes;
+        stats.vocabulary.count += content.vocabularies;
+        stats.total += content.bytes;
+      }
+
       return stats;
     } catch (error) {
       console.error('[Cache] Failed to get cache stats:', error);
@@ -524,6 +588,15 @@ class CacheManager {
         console.error(`[Cache] Failed to clear ${storeName}:`, error);
       }
     }
+
+    if (this.contentCache) {
+      try {
+        await this.contentCache.clear();
+        console.log('[Cache] Cleared album cache');
+      } catch (error) {
+        console.error('[Cache] Failed to clear album cache:', error);
+      }
+    }
   }
 
   /**
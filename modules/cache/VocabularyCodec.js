@@ -0,0 +1,342 @@
+/**
+ * VocabularyCodec - Binary container for cached vocabulary databases
+ *
+ * One ArrayBuffer per album, read from IndexedDB in a single get():
+ *
+ *   [magic u32][format version u32][header bytes u32][pad u32]
+ *   [header JSON, UTF-8, padded to 8 bytes]
+ *   [sections, each 8-byte aligned]
+ *
+ * The header holds metadata, per-target scalars and a section table
+ * ({name, type, offset, length}). Sections are the flat vocabulary tree,
+ * vocabulary words, IDF, all target descriptors and keypoints back to back,
+ * the sparse BoW / BM25 vectors and the inverted index. decode() returns
+ * the VocabularyBuilder export shape with typed-array views into the buffer,
+ * so a target's descriptors go into a cv.Mat with one data.set().
+ */
+class VocabularyCodec {
+  /**
+   * Encode an exported database (VocabularyBuilder.exportDatabase)
+   * @param {Object} database
+   * @returns {ArrayBuffer}
+   */
+  static encode(database) {
+    const sections = [];
+    const add = (name, array) => {
+      sections.push({ name, array });
+    };
+
+    const vocabulary = database.vocabulary;
+    const descriptorBytes = database.metadata.descriptor_bytes;
+
+    // Vocabulary words and IDF
+    const words = new Uint8Array(vocabulary.words.length * descriptorBytes);
+    vocabulary.words.forEach((word, i) => words.set(word, i * descriptorBytes));
+    add('words', words);
+    add('idf', Float64Array.from(vocabulary.idf_weights));
+
+    // Flat tree node table
+    const tree = vocabulary.flat_tree;
+    if (tree) {
+      for (const field of VocabularyCodec.TREE_ARRAYS) {
+        add(`tree.${field}`, tree[field]);
+      }
+    }
+
+    // Targets: descriptors, keypoints and sparse vectors concatenated
+    const targets = database.targets;
+    const counts = targets.map(target => VocabularyCodec.countDescriptors(target, descriptorBytes));
+    const bowSizes = targets.map(target => Object.keys(target.bow || {}).length);
+    const weightedSizes = targets.map(target => Object.keys(target.bow_tfidf || {}).length);
+    const total = (sizes) => sizes.reduce((sum, size) => sum + size, 0);
+
+    const descriptors = new Uint8Array(total(counts) * descriptorBytes);
+    const keypoints = new Float32Array(total(counts) * 2);
+    const bowWords = new Int32Array(total(bowSizes));
+    const bowCounts = new Float64Array(total(bowSizes));
+    const weightedWords = new Int32Array(total(weightedSizes));
+    const weightedValues = new Float64Array(total(weightedSizes));
+
+    let descriptorOffset = 0;
+    let bowOffset = 0;
+    let weightedOffset = 0;
+
+    const targetHeaders = targets.map((target, t) => {
+      VocabularyCodec.writeDescriptors(target.descriptors, descriptors, descriptorOffset * descriptorBytes);
+      VocabularyCodec.writeKeypoints(target.keypoints, keypoints, descriptorOffset * 2);
+      VocabularyCodec.writeSparse(target.bow, bowWords, bowCounts, bowOffset);
+      VocabularyCodec.writeSparse(target.bow_tfidf, weightedWords, weightedValues, weightedOffset);
+
+      const header = {
+        id: target.id,
+        filename: target.filename,
+        num_features: target.num_features,
+        weighting_scheme: target.weighting_scheme,
+        fingerprint: target.fingerprint,
+        image_meta: target.image_meta,
+        count: counts[t],
+        bow: bowSizes[t],
+        weighted: weightedSizes[t]
+      };
+
+      descriptorOffset += counts[t];
+      bowOffset += bowSizes[t];
+      weightedOffset += weightedSizes[t];
+      return header;
+    });
+
+    add('descriptors', descriptors);
+    add('keypoints', keypoints);
+    add('bow.words', bowWords);
+    add('bow.counts', bowCounts);
+    add('weighted.words', weightedWords);
+    add('weighted.values', weightedValues);
+
+    // Inverted index (target ids are strings and live in the header)
+    const index = vocabulary.inverted_index;
+    if (index) {
+      add('index.target_norms', Float64Array.from(index.target_norms));
+      add('index.word_offsets', Int32Array.from(index.word_offsets));
+      add('index.posting_targets', Int32Array.from(index.posting_targets));
+      add('index.posting_weights', Float64Array.from(index.posting_weights));
+    }
+
+    // Lay out sections after the header
+    const header = {
+      metadata: database.metadata,
+      tree: tree ? {
+        descriptorBytes: tree.descriptorBytes,
+        descriptorWords: tree.descriptorWords,
+        nodeCount: tree.nodeCount,
+        wordCount: tree.wordCount
+      } : null,
+      index_target_ids: index ? index.target_ids : null,
+      targets: targetHeaders,
+      sections: []
+    };
+
+    // Offsets depend on the header length, which depends on the offsets:
+    // lay out relative to the section base, then fix the base once
+    let cursor = 0;
+    for (const { name, array } of sections) {
+      header.sections.push({
+        name,
+        type: VocabularyCodec.typeName(array),
+        offset: cursor,
+        length: array.length
+      });
+      cursor = VocabularyCodec.align(cursor + array.byteLength);
+    }
+
+    const headerBytes = new TextEncoder().encode(JSON.stringify(header));
+    const base = VocabularyCodec.align(VocabularyCodec.PREAMBLE_BYTES + headerBytes.length);
+    const buffer = new ArrayBuffer(base + cursor);
+
+    const preamble = new Uint32Array(buffer, 0, 4);
+    preamble[0] = VocabularyCodec.MAGIC;
+    preamble[1] = VocabularyCodec.FORMAT_VERSION;
+    preamble[2] = headerBytes.length;
+    new Uint8Array(buffer, VocabularyCodec.PREAMBLE_BYTES, headerBytes.length).set(headerBytes);
+
+    const bytes = new Uint8Array(buffer);
+    sections.forEach(({ array }, i) => {
+      bytes.set(
+        new Uint8Array(array.buffer, array.byteOffset, array.byteLength),
+        base + header.sections[i].offset
+      );
+    });
+
+    return buffer;
+  }
+
+  /**
+   * Decode a buffer produced by encode()
+   * @param {ArrayBuffer} buffer
+   * @returns {Object|null} Database in export shape, or null if the buffer
+   *   is not a vocabulary container of this format version
+   */
+  static decode(buffer) {
+    if (!(buffer instanceof ArrayBuffer) || buffer.byteLength < VocabularyCodec.PREAMBLE_BYTES) {
+      return null;
+    }
+
+    const preamble = new Uint32Array(buffer, 0, 4);
+    if (preamble[0] !== VocabularyCodec.MAGIC || preamble[1] !== VocabularyCodec.FORMAT_VERSION) {
+      return null;
+    }
+
+    const headerLength = preamble[2];
+    const header = JSON.parse(new TextDecoder().decode(
+      new Uint8Array(buffer, VocabularyCodec.PREAMBLE_BYTES, headerLength)
+    ));
+    const base = VocabularyCodec.align(VocabularyCodec.PREAMBLE_BYTES + headerLength);
+
+    // Zero-copy views; every section offset is aligned for its element type
+    const views = {};
+    for (const section of header.sections) {
+      const Type = VocabularyCodec.TYPES[section.type];
+      views[section.name] = new Type(buffer, base + section.offset, section.length);
+    }
+
+    const descriptorBytes = header.metadata.descriptor_bytes;
+    const wordsBlob = views.words;
+    const words = [];
+    for (let i = 0; i < wordsBlob.length / descriptorBytes; i++) {
+      words.push(wordsBlob.subarray(i * descriptorBytes, (i + 1) * descriptorBytes));
+    }
+
+    let flatTree = null;
+    if (header.tree) {
+      flatTree = { ...header.tree };
+      for (const field of VocabularyCodec.TREE_ARRAYS) {
+        flatTree[field] = views[`tree.${field}`];
+      }
+    }
+
+    let descriptorOffset = 0;
+    let bowOffset = 0;
+    let weightedOffset = 0;
+
+    const targets = header.targets.map(target => {
+      const decoded = {
+        id: target.id,
+        filename: target.filename,
+        num_features: target.num_features,
+        num_descriptors: target.count,
+        weighting_scheme: target.weighting_scheme,
+        fingerprint: target.fingerprint,
+        keypoints: views.keypoints.subarray(descriptorOffset * 2, (descriptorOffset + target.count) * 2),
+        descriptors: views.descriptors.subarray(
+          descriptorOffset * descriptorBytes,
+          (descriptorOffset + target.count) * descriptorBytes
+        ),
+        bow: VocabularyCodec.readSparse(views['bow.words'], views['bow.counts'], bowOffset, target.bow),
+        bow_tfidf: VocabularyCodec.readSparse(
+          views['weighted.words'], views['weighted.values'], weightedOffset, target.weighted
+        ),
+        image_meta: target.image_meta
+      };
+
+      descriptorOffset += target.count;
+      bowOffset += target.bow;
+      weightedOffset += target.weighted;
+      return decoded;
+    });
+
+    return {
+      metadata: header.metadata,
+      vocabulary: {
+        words,
+        idf_weights: views.idf,
+        flat_tree: flatTree,
+        inverted_index: header.index_target_ids ? {
+          target_ids: header.index_target_ids,
+          target_norms: views['index.target_norms'],
+          word_offsets: views['index.word_offsets'],
+          posting_targets: views['index.posting_targets'],
+          posting_weights: views['index.posting_weights']
+        } : null
+      },
+      targets
+    };
+  }
+
+  /**
+   * Descriptor rows of a target (flat Uint8Array or [[byte, ...], ...])
+   * @private
+   */
+  static countDescriptors(target, descriptorBytes) {
+    const descriptors = target.descriptors;
+    if (ArrayBuffer.isView(descriptors)) {
+      return descriptors.length / descriptorBytes;
+    }
+    return descriptors ? descriptors.length : 0;
+  }
+
+  /**
+   * @private
+   */
+  static writeDescriptors(descriptors, out, offset) {
+    if (ArrayBuffer.isView(descriptors)) {
+      out.set(descriptors, offset);
+      return;
+    }
+    for (const row of descriptors || []) {
+      out.set(row, offset);
+      offset += row.length;
+    }
+  }
+
+  /**
+   * Keypoints as flat [x0, y0, x1, y1, ...] or [[x, y], ...]
+   * @private
+   */
+  static writeKeypoints(keypoints, out, offset) {
+    if (ArrayBuffer.isView(keypoints)) {
+      out.set(keypoints, offset);
+      return;
+    }
+    for (const [x, y] of keypoints || []) {
+      out[offset++] = x;
+      out[offset++] = y;
+    }
+  }
+
+  /**
+   * Sparse {wordId: value} vector into parallel id / value arrays
+   * @private
+   */
+  static writeSparse(vector, ids, values, offset) {
+    for (const key in vector || {}) {
+      ids[offset] = Number(key);
+      values[offset] = vector[key];
+      offset++;
+    }
+  }
+
+  /**
+   * @private
+   */
+  static readSparse(ids, values, offset, length) {
+    const vector = {};
+    for (let i = offset; i < offset + length; i++) {
+      vector[ids[i]] = values[i];
+    }
+    return vector;
+  }
+
+  /**
+   * @private
+   */
+  static typeName(array) {
+    for (const name in VocabularyCodec.TYPES) {
+      if (array instanceof VocabularyCodec.TYPES[name]) return name;
+    }
+    throw new Error(`Unsupported section type: ${array && array.constructor.name}`);
+  }
+
+  /**
+   * @private
+   */
+  static align(offset) {
+    return (offset + 7) & ~7;
+  }
+}
+
+VocabularyCodec.MAGIC = 0x56524157; // 'WARV' little-endian
+VocabularyCodec.FORMAT_VERSION = 1;
+VocabularyCodec.PREAMBLE_BYTES = 16;
+VocabularyCodec.TREE_ARRAYS = [
+  'centerStart', 'centerCount', 'childStart', 'childCount', 'wordOffset', 'isLeaf', 'centers'
+];
+VocabularyCodec.TYPES = {
+  u8: Uint8Array,
+  i32: Int32Array,
+  f32: Float32Array,
+  f64: Float64Array
+};
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.VocabularyCodec = VocabularyCodec;
+}
@@ -170,32 +170,97 @@ class CameraManager {
                this.video.videoHeight > 0;
     }
 
+    /**
+     * Check that the video element has decoded dimensions
+     * @returns {boolean}
+     */
+    hasVideoFrame() {
+        return !!(this.video &&
+                  this.video.videoWidth > 0 &&
+                  this.video.videoHeight > 0);
+    }
+
+    /**
+     * Processing resolution for the current video, fitted within maxDimension
+     * @param {number} maxDimension
+     * @returns {{width: number, height: number}}
+     */
+    getProcessingSize(maxDimension) {
+        const videoWidth = this.video.videoWidth;
+        const videoHeight = this.video.videoHeight;
+
+        if (maxDimension && (videoWidth > maxDimension || videoHeight > maxDimension)) {
+            // Calculate scale factor to fit within maxDimension
+            const scaleFactor = Math.min(
+                maxDimension / videoWidth,
+                maxDimension / videoHeight
+            );
+            return {
+                width: Math.round(videoWidth * scaleFactor),
+                height: Math.round(videoHeight * scaleFactor)
+            };
+        }
+
+        // Use original video dimensions
+        return { width: videoWidth, height: videoHeight };
+    }
+
+    /**
+     * Set output canvas to match processing resolution for perfect alignment
+     */
+    syncOutputCanvas(width, height) {
+        if (this.canvas && (this.canvas.width !== width || this.canvas.height !== height)) {
+            this.canvas.width = width;
+            this.canvas.height = height;
+        }
+    }
+
+    /**
+     * Capture a transferable frame for the vision worker
+     * Prefers VideoFrame (GPU-backed handle, no pixel copy on the main thread)
+     * and falls back to a downscaled ImageBitmap.
+     * @param {number} maxDimension
+     * @returns {Promise<{source: VideoFrame|ImageBitmap, width: number, height: number}|null>}
+     */
+    async captureFrameSource(maxDimension) {
+        try {
+            if (!this.hasVideoFrame()) return null;
+
+            const { width, height } = this.getProcessingSize(maxDimension);
+            this.syncOutputCanvas(width, height);
+
+            if (typeof VideoFrame !== 'undefined') {
+                try {
+                    const source = new VideoFrame(this.video, {
+                        timestamp: Math.round(performance.now() * 1000)
+                    });
+                    return { source, width, height };
+                } catch (error) {
+                    // Some browsers reject VideoFrame from a media element - use ImageBitmap
+                }
+            }
+
+            const source = await createImageBitmap(this.video, {
+                resizeWidth: width,
+                resizeHeight: height,
+                resizeQuality: 'low'
+            });
+            return { source, width, height };
+        } catch (error) {
+            console.error("Error capturing transferable frame:", error);
+            return null;
+        }
+    }
+
     captureFrame(maxDimension) {
         try {
             // Verify video is ready
-            if (!this.video ||
-                !this.video.videoWidth ||
-                !this.video.videoHeight ||
-                this.video.videoWidth <= 0 ||
-                this.video.videoHeight <= 0) {
+            if (!this.hasVideoFrame()) {
                 return null;
             }
 
             // Calculate target dimensions (apply maxDimension before drawing)
-            let drawWidth, drawHeight;
-            if (maxDimension && (this.video.videoWidth > maxDimension || this.video.videoHeight > maxDimension)) {
-                // Calculate scale factor to fit within maxDimension
-                const scaleFactor = Math.min(
-                    maxDimension / this.video.videoWidth,
-                    maxDimension / this.video.videoHeight
-                );
-                drawWidth = Math.round(this.video.videoWidth * scaleFactor);
-                drawHeight = Math.round(this.video.videoHeight * scaleFactor);
-            } else {
-                // Use original video dimensions
-                drawWidth = this.video.videoWidth;
-                drawHeight = this.video.videoHeight;
-            }
+            const { width: drawWidth, height: drawHeight } = this.getProcessingSize(maxDimension);
 
             // Resize canvas to target dimensions (reuse same canvas)
             this.captureCanvas.width = drawWidth;
@@ -205,15 +270,14 @@ class CameraManager {
             // This is much faster than drawing Full HD then resizing with OpenCV
             this.captureContext.drawImage(this.video, 0, 0, drawWidth, drawHeight);
 
-            // Read the image data from the canvas into an OpenCV matrix
+            // Read the image data into a pooled RGBA Mat (release via MatPool)
             // No resize needed since we already drew at the correct size
-            let frame = cv.imread(this.captureCanvas);
+            const imageData = this.captureContext.getImageData(0, 0, drawWidth, drawHeight);
+            const frame = MatPool.shared().acquire(drawHeight, drawWidth, cv.CV_8UC4);
+            frame.data.set(imageData.data);
 
             // Set canvas to match processing resolution for perfect alignment
-            if (this.canvas.width !== frame.cols || this.canvas.height !== frame.rows) {
-                this.canvas.width = frame.cols;
-                this.canvas.height = frame.rows;
-            }
+            this.syncOutputCanvas(frame.cols, frame.rows);
 
             return frame;
         } catch (error) {
@@ -0,0 +1,207 @@
+/**
+ * FrameScheduler - Runs the processing step once per new camera frame
+ *
+ * requestAnimationFrame fires at display rate (often 120 Hz) while the camera
+ * delivers 30 fps, so a rAF loop either processes the same camera frame again
+ * or skips frames arbitrarily. requestVideoFrameCallback fires once for every
+ * frame the <video> element presents, with that frame's metadata. A frame
+ * that arrives while the previous one is still being processed is dropped,
+ * never queued: the next step always gets the newest frame.
+ *
+ * FPS, latency and drops come from the frame metadata: presentedFrames gaps
+ * count the camera frames that were never processed, mediaTime gives the
+ * camera rate, and captureTime (when the browser reports it) the age of a
+ * frame when its processing finishes. Without requestVideoFrameCallback the
+ * scheduler falls back to requestAnimationFrame, skipping ticks on which the
+ * video's currentTime did not advance.
+ */
+class FrameScheduler {
+  /**
+   * @param {HTMLVideoElement} video - Camera video element
+   * @param {Function} onFrame - (frame) => void|Promise, frame = {now, mediaTime,
+   *   presentedFrames, captureTime}; a returned promise keeps the scheduler
+   *   busy (new frames are dropped) until it settles
+   * @param {Object} options - {videoFrameCallback}
+   */
+  constructor(video, onFrame, options = {}) {
+    const config = (typeof AppConfig !== 'undefined' && AppConfig.frameProcessing) || {};
+    this.video = video;
+    this.onFrame = onFrame;
+    this.useVideoFrames = (options.videoFrameCallback ?? config.videoFrameCallback ?? true) &&
+                          FrameScheduler.isSupported(video);
+
+    this.running = false;
+    this.busy = false;
+    this.handle = null;
+    this.lastMediaTime = null; // Frame the rAF fallback last processed
+    this.last = null; // {now, mediaTime, presentedFrames} of the last processed frame
+
+    this.stats = FrameScheduler.emptyStats();
+  }
+
+  /**
+   * @param {HTMLVideoElement} video
+   * @returns {boolean}
+   */
+  static isSupported(video) {
+    return !!video && typeof video.requestVideoFrameCallback === 'function';
+  }
+
+  static emptyStats() {
+    return {
+      processed: 0,
+      dropped: 0, // Camera frames presented but never processed
+      processedFps: 0,
+      cameraFps: 0,
+      latencyMs: 0
+    };
+  }
+
+  /**
+   * Start scheduling frames (no-op while running)
+   */
+  start() {
+    if (this.running) return;
+
+    this.running = true;
+    this.last = null;
+    this.lastMediaTime = null;
+    this.stats = FrameScheduler.emptyStats();
+    this.request();
+  }
+
+  /**
+   * Stop scheduling; a step in progress still completes
+   */
+  stop() {
+    if (!this.running) return;
+
+    this.running = false;
+    if (this.handle !== null) {
+      if (this.useVideoFrames) {
+        this.video.cancelVideoFrameCallback(this.handle);
+      } else {
+        cancelAnimationFrame(this.handle);
+      }
+      this.handle = null;
+    }
+  }
+
+  /**
+   * @private
+   */
+  request() {
+    this.handle = this.useVideoFrames
+      ? this.video.requestVideoFrameCallback((now, metadata) => this.tick(now, metadata))
+      : requestAnimationFrame(now => this.tick(now, null));
+  }
+
+  /**
+   * @private
+   */
+  tick(now, metadata) {
+    this.handle = null;
+    if (!this.running) return;
+
+    // Register for the next frame first, so none is missed while this one runs
+    this.request();
+
+    let frame;
+    if (metadata) {
+      frame = {
+        now,
+        mediaTime: metadata.mediaTime,
+        presentedFrames: metadata.presentedFrames,
+        captureTime: metadata.captureTime ?? null
+      };
+    } else {
+      // rAF fallback: only a frame whose media time moved is a new one
+      const mediaTime = this.video.currentTime;
+      if (mediaTime === this.lastMediaTime) return;
+      frame = { now, mediaTime, presentedFrames: null, captureTime: null };
+    }
+
+    // Still processing the previous frame: drop this one, the gap in
+    // presentedFrames counts it
+    if (this.busy) return;
+
+    this.lastMediaTime = frame.mediaTime;
+    this.noteFrame(frame);
+
+    let pending;
+    this.busy = true;
+    try {
+      pending = this.onFrame(frame);
+    } catch (error) {
+      console.error('[FrameScheduler] Frame step failed:', error);
+    }
+
+    if (pending && typeof pending.then === 'function') {
+      pending
+        .catch(error => console.error('[FrameScheduler] Frame step failed:', error))
+        .finally(() => this.finishFrame(frame));
+    } else {
+      this.finishFrame(frame);
+    }
+  }
+
+  /**
+   * Rates from the interval to the previously processed frame
+   * @private
+   */
+  noteFrame(frame) {
+    const stats = this.stats;
+    const last = this.last;
+    this.last = frame;
+    if (!last) return;
+
+    const ema = (previous, value) => previous ? previous * 0.75 + value * 0.25 : value;
+
+    const elapsedMs = frame.now - last.now;
+    if (elapsedMs > 0) {
+      stats.processedFps = ema(stats.processedFps, 1000 / elapsedMs);
+    }
+
+    if (frame.presentedFrames !== null && last.presentedFrames !== null) {
+      const presented = frame.presentedFrames - last.presentedFrames;
+      if (presented > 1) stats.dropped += presented - 1;
+
+      const mediaElapsed = frame.mediaTime - last.mediaTime;
+      if (presented > 0 && mediaElapsed > 0) {
+        stats.cameraFps = ema(stats.cameraFps, presented / mediaElapsed);
+      }
+    }
+  }
+
+  /**
+   * @private
+   */
+  finishFrame(frame) {
+    this.busy = false;
+    this.stats.processed++;
+
+    // Age of the frame when its results are ready: from capture when the
+    // browser reports it, else from presentation
+    const latency = performance.now() - (frame.captureTime ?? frame.now);
+    if (latency >= 0) {
+      this.stats.latencyMs = this.stats.latencyMs
+        ? this.stats.latencyMs * 0.75 + latency * 0.25
+        : latency;
+    }
+  }
+
+  /**
+   * @returns {Object} {processed, dropped, processedFps, cameraFps, latencyMs, mode}
+   */
+  getStats() {
+    return {
+      ...this.stats,
+      mode: this.useVideoFrames ? 'videoFrame' : 'animationFrame'
+    };
+  }
+}
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.FrameScheduler = FrameScheduler;
+}
@@ -30,7 +30,8 @@ class ImageTracker {
             featurePoints: null, // Feature points used in optical flow tracking
             flowStatus: null, // Status of optical flow tracking points
             maxFeatures: AppConfig.orb.nfeatures,
-            trackedTargets: new Map(), // Map of targetId -> {corners, lastFrame, featurePoints}
+            pyramidLevels: AppConfig.orb.nlevels,
+            trackedTargets: new Map(), // Map of targetId -> {corners, keyframe, lastFrame} (keyframe shared per frame)
 
             // Single-video mode with center-priority selection
             activeVideoTarget: null, // Currently playing video target ID
@@ -41,6 +42,12 @@ class ImageTracker {
         // Initialize profiler
         this.profiler = new PerformanceProfiler();
 
+        // Quality governor steps the processing settings to hold a frame budget
+        this.governor = AppConfig.governor.enabled ? new QualityGovernor(this.profiler) : null;
+        if (this.governor) {
+            Object.assign(this.state, QualityGovernor.stateFor(this.governor.tier));
+        }
+
         // Initialize debug exporter
         this.debugExporter = new DebugExporter(this);
 
@@ -51,11 +58,32 @@ class ImageTracker {
         this.ui = new UIManager(this);
         this.offlineManager = window.OfflineManager ? new OfflineManager() : null;
         this.camera = new CameraManager();
+        this.frameScheduler = new FrameScheduler(this.camera.video, timing => this.processCameraFrame(timing));
         this.referenceManager = new ReferenceImageManager(this.ui);
+        if (this.governor) {
+            this.ui.updateQualityTier(this.governor.getStatus());
+        }
         this.detector = null;
         this.opticalFlow = null;
+        this.pipeline = null; // Main-thread TrackingPipeline (fallback path)
         this.arRenderer = null; // Will be initialized after camera starts
 
+        // Render loop decoupled from processing: the latest tracker update,
+        // and per-target Kalman filters used to predict corners between updates
+        this.decoupledRender = AppConfig.rendering.decoupledRender;
+        this.renderLoopActive = false;
+        this.renderFrame = null; // {results, frame, selectedTargetId}
+        this.renderFilters = new Map(); // targetId -> Kalman filters
+
+        // Vision worker (detection + tracking off the main thread)
+        this.visionWorker = null;
+        this.workerResults = [];
+        this.workerFrameSize = null;
+        this.workerPoolStats = null;
+
+        // Grayscale processing frame shared by detection and optical flow
+        this.grayFrame = null;
+
         // Initialize when OpenCV is ready
         this.waitForOpenCV();
 
@@ -98,6 +126,9 @@ class ImageTracker {
             }
 
             console.log('[OpenCV] Initialization complete, critical functions verified');
+            if (typeof configureOpenCVThreads === 'function') {
+                configureOpenCVThreads(window.cv, AppConfig.opencv.threads);
+            }
             this.ui.updateStatus('OpenCV loaded. Loading database...');
             this.initialize();
 
@@ -108,6 +139,9 @@ class ImageTracker {
                     this.detector.setVocabularyQuery(vocabularyQuery);
                 }
 
+                // Hand the database to the vision worker (main thread keeps tracking until it is ready)
+                this.loadWorkerTargets();
+
                 // Create ARRenderer early so VideoManager exists
                 this.ui.updateStatus('Initializing AR renderer...');
                 await this.preloadARRenderer();
@@ -144,6 +178,20 @@ class ImageTracker {
         // Initialize detector with vocabulary tree and optical flow tracker
         this.detector = new FeatureDetector(this.state, this.profiler, vocabularyQuery);
         this.opticalFlow = new OpticalFlowTracker(this.state);
+        this.pipeline = new TrackingPipeline(
+            this.state,
+            this.detector,
+            this.opticalFlow,
+            this.profiler,
+            {
+                onTargetStatus: (targetId, updates) => {
+                    this.referenceManager.updateTargetRuntime(targetId, updates);
+                }
+            }
+        );
+
+        // Start the vision worker while the album loads
+        this.startVisionWorker();
 
         // Initialize visualizer for feature point visualization
         this.visualizer = new Visualizer();
@@ -152,6 +200,62 @@ class ImageTracker {
         this.setupOrientationHandling();
     }
 
+    startVisionWorker() {
+        if (!AppConfig.worker.enabled || typeof VisionWorkerClient === 'undefined' ||
+            !VisionWorkerClient.isSupported()) {
+            console.log('[ImageTracker] Vision worker unavailable, tracking on main thread');
+            return;
+        }
+
+        this.visionWorker = new VisionWorkerClient();
+        this.visionWorker.start().catch(error => this.disableVisionWorker(error));
+    }
+
+    async loadWorkerTargets() {
+        if (!this.visionWorker) return;
+
+        try {
+            await this.visionWorker.start();
+            const database = this.referenceManager.zipLoader?.getDatabase();
+            if (!database) {
+                throw new Error('No database available for vision worker');
+            }
+            const count = await this.visionWorker.loadTargets(database);
+            console.log(`[ImageTracker] Vision worker loaded ${count} targets`);
+        } catch (error) {
+            this.disableVisionWorker(error);
+        }
+    }
+
+    disableVisionWorker(error) {
+        if (!this.visionWorker) return;
+
+        console.warn('[ImageTracker] Vision worker disabled, falling back to main thread:', error);
+        this.visionWorker.terminate();
+        this.visionWorker = null;
+        this.workerResults = [];
+        this.workerFrameSize = null;
+        this.state.trackedTargets.clear();
+    }
+
+    isWorkerActive() {
+        // Targets loaded but no longer ready: the worker crashed between frames
+        if (this.visionWorker && this.visionWorker.hasTargets && !this.visionWorker.isReady) {
+            this.disableVisionWorker(new Error('Vision worker stopped'));
+        }
+
+        if (!this.visionWorker || !this.visionWorker.isReady || !this.visionWorker.hasTargets) {
+            return false;
+        }
+
+        // Switching from the main-thread pipeline: release its frames first
+        if (!this.workerFrameSize && this.pipeline && this.pipeline.getTrackedTargetIds().length > 0) {
+            this.pipeline.reset();
+        }
+
+        return true;
+    }
+
     setupOrientationHandling() {
         // Get overlay element reference
         const overlay = document.getElementById('cameraTransitionOverlay');
@@ -338,6 +442,7 @@ class ImageTracker {
     stopTracking() {
         // Update state
         this.state.isTracking = false;
+        this.frameScheduler.stop();
 
         // Stop camera
         this.camera.stop();
@@ -350,18 +455,18 @@ class ImageTracker {
         this.state.lastCorners = null;
         this.state.frameCount = 0;
 
-        // Clean up tracked targets
-        for (const [targetId, tracked] of this.state.trackedTargets) {
-            if (tracked.lastFrame) {
-                tracked.lastFrame.delete();
-            }
-            this.opticalFlow.resetTrackingState(targetId);
-            this.referenceManager.updateTargetRuntime(targetId, {
-                status: 'idle'
-            });
+        // Clean up tracked targets (main-thread frames or worker mirror)
+        if (this.pipeline) {
+            this.pipeline.reset();
         }
         this.state.trackedTargets.clear();
 
+        if (this.visionWorker) {
+            this.visionWorker.reset();
+        }
+        this.workerResults = [];
+        this.workerFrameSize = null;
+
         // Clean up AR renderer
         if (this.arRenderer) {
             for (const targetId of Array.from(this.state.trackedTargets.keys())) {
@@ -519,28 +624,39 @@ class ImageTracker {
         return bestTarget.targetId;
     }
 
+    /**
+     * Start processing camera frames (no-op while the loop runs)
+     */
     processVideo() {
-        // Exit if not tracking
         if (!this.state.isTracking) return;
 
-        // Schedule next frame
-        requestAnimationFrame(() => this.processVideo());
+        this.frameScheduler.start();
+        this.startRenderLoop();
+    }
 
-        // Calculate FPS
-        const now = performance.now();
-        if (this.state.lastFrameTimestamp) {
-            const delta = now - this.state.lastFrameTimestamp;
-            if (delta > 0) {
-                const currentFps = 1000 / delta;
-                // apply exponential moving average for smoother display
-                this.state.fps = this.state.fps ? (this.state.fps * 0.75 + currentFps * 0.25) : currentFps;
-                this.ui.updateFPS(this.state.fps);
-            }
+    /**
+     * Frame step, run by the scheduler once per new camera frame
+     * @param {Object} timing - FrameScheduler frame {now, mediaTime, presentedFrames, captureTime}
+     * @returns {Promise|undefined} Pending worker round trip; new frames are
+     *   dropped until it settles
+     */
+    processCameraFrame(timing) {
+        // Exit if not tracking
+        if (!this.state.isTracking) {
+            this.frameScheduler.stop();
+            return;
         }
-        this.state.lastFrameTimestamp = now;
 
-        // Skip if already processing a frame
-        if (this.state.isProcessing) return;
+        // Processed rate, camera rate and latency from the frame metadata
+        const frameStats = this.frameScheduler.getStats();
+        this.state.fps = frameStats.processedFps;
+        this.state.lastFrameTimestamp = timing.now;
+        this.ui.updateFPS(frameStats.processedFps, frameStats);
+
+        // Detection and tracking run in the vision worker when it is available
+        if (this.isWorkerActive()) {
+            return this.processVideoWithWorker();
+        }
 
         // Set processing flag
         this.state.isProcessing = true;
@@ -549,12 +665,13 @@ class ImageTracker {
         let frameToProcess = null;
 
         try {
-            this.profiler.startTimer('frame_total');
+            this.profiler.beginFrame();
+            this.profiler.startTimer(PerformanceProfiler.Span.FRAME_TOTAL);
 
             // Capture processing frame (low-res for AR tracking)
-            this.profiler.startTimer('capture_frame');
+            this.profiler.startTimer(PerformanceProfiler.Span.CAPTURE_FRAME);
             frameToProcess = this.camera.captureFrame(this.state.maxDimension);
-            this.profiler.endTimer('capture_frame');
+            this.profiler.endTimer(PerformanceProfiler.Span.CAPTURE_FRAME);
             if (!frameToProcess) return;
 
             // Log frame resolution on first frame
@@ -566,180 +683,18 @@ class ImageTracker {
                 });
             }
 
-            // Increment frame counter
-            this.state.frameCount++;
+            // Convert once; detection and optical flow both consume the gray frame
+            this.profiler.startTimer(PerformanceProfiler.Span.GRAY_CONVERSION);
+            if (!this.grayFrame) this.grayFrame = new cv.Mat();
+            cv.cvtColor(frameToProcess, this.grayFrame, cv.COLOR_RGBA2GRAY);
+            this.profiler.endTimer(PerformanceProfiler.Span.GRAY_CONVERSION);
 
+            // Detect all targets every N frames, optical flow for the tracked ones in between
             const targets = this.referenceManager.getTargets();
-            let trackingResults = [];
-            let shouldRunDetector = this.state.frameCount % this.state.detectionInterval === 0 ||
-                                   !this.state.useOpticalFlow;
-
-            // OPTIMIZATION: Detect all targets but only track the selected one
-            if (targets.length === 0) {
-                trackingResults = [];
-            } else if (shouldRunDetector) {
-                // Always detect all targets to enable switching between them
-                // This allows us to see which target is closest to center
-                let targetsToDetect = targets;
-
-                // Run full feature detection for targets
-                this.profiler.startTimer('detection_total');
-                trackingResults = this.detector.detectMultipleTargets(frameToProcess, targetsToDetect);
-                this.profiler.endTimer('detection_total');
-
-                // Update tracked targets with detection results
-                for (const result of trackingResults) {
-                    if (result.success && result.corners) {
-                        // Clean up old frame if exists
-                        const existing = this.state.trackedTargets.get(result.targetId);
-                        if (existing && existing.lastFrame) {
-                            existing.lastFrame.delete();
-                        }
-
-                        // Store new tracking data
-                        this.state.trackedTargets.set(result.targetId, {
-                            corners: result.corners.slice(),
-                            lastFrame: frameToProcess.clone()
-                        });
-
-                        // Reset optical flow tracking state on new detection
-                        // This initializes Kalman filters and geometric state
-                        const trackState = this.opticalFlow.getTrackingState(result.targetId);
-                        trackState.framesSinceDetection = 0;
-                        trackState.consecutivePoorFrames = 0;
-                        trackState.prevScale = this.opticalFlow.calculateScale(result.corners);
-                        trackState.prevRotation = this.opticalFlow.calculateRotation(result.corners);
-                        trackState.prevAspectRatio = this.opticalFlow.calculateAspectRatio(result.corners);
-
-                        // Update target runtime status
-                        this.referenceManager.updateTargetRuntime(result.targetId, {
-                            status: 'tracked',
-                            lastSeen: Date.now(),
-                            score: result.score
-                        });
-                    } else if (this.state.useOpticalFlow && this.state.trackedTargets.has(result.targetId)) {
-                        // Detection failed but we have tracking data - try optical flow
-                        this.profiler.startTimer('optical_flow_fallback');
-                        const tracked = this.state.trackedTargets.get(result.targetId);
-                        const flowResult = this.opticalFlow.track(
-                            tracked.lastFrame,
-                            frameToProcess,
-                            tracked.corners,
-                            result.targetId
-                        );
-                        this.profiler.endTimer('optical_flow_fallback');
-
-                        if (flowResult.success) {
-                            // Update with optical flow result
-                            tracked.lastFrame.delete();
-                            tracked.lastFrame = frameToProcess.clone();
-                            tracked.corners = flowResult.corners.slice();
-
-                            trackingResults[trackingResults.indexOf(result)] = {
-                                ...result,
-                                ...flowResult,
-                                success: true
-                            };
-
-                            this.referenceManager.updateTargetRuntime(result.targetId, {
-                                status: 'tracked',
-                                lastSeen: Date.now()
-                            });
-
-                            // Check if we should trigger re-detection for quality
-                            if (flowResult.shouldRedetect) {
-                                // Will trigger full detection on next interval
-                                this.state.frameCount = this.state.detectionInterval - 1;
-                            }
-                        } else {
-                            // Optical flow failed - force re-detection immediately
-                            if (flowResult.shouldRedetect) {
-                                this.state.trackedTargets.delete(result.targetId);
-                                this.opticalFlow.resetTrackingState(result.targetId);
-                                this.state.frameCount = this.state.detectionInterval - 1;
-                            }
-                            this.referenceManager.updateTargetRuntime(result.targetId, {
-                                status: 'lost'
-                            });
-                        }
-                    } else {
-                        // No detection and no tracking data
-                        this.referenceManager.updateTargetRuntime(result.targetId, {
-                            status: 'lost'
-                        });
-                    }
-                }
-            } else {
-                // OPTIMIZATION: Only use optical flow for active target (single-video mode)
-                this.profiler.startTimer('optical_flow_tracking');
-
-                if (this.state.activeVideoTarget && this.state.trackedTargets.has(this.state.activeVideoTarget)) {
-                    // Only track the currently selected target
-                    const targetId = this.state.activeVideoTarget;
-                    const tracked = this.state.trackedTargets.get(targetId);
-
-                    const flowResult = this.opticalFlow.track(
-                        tracked.lastFrame,
-                        frameToProcess,
-                        tracked.corners,
-                        targetId
-                    );
-
-                    if (flowResult.success) {
-                        // Update tracking data
-                        tracked.lastFrame.delete();
-                        tracked.lastFrame = frameToProcess.clone();
-                        tracked.corners = flowResult.corners.slice();
-
-                        const target = this.referenceManager.getTarget(targetId);
-                        trackingResults.push({
-                            targetId,
-                            targetLabel: target?.label || targetId,
-                            ...flowResult,
-                            success: true
-                        });
-
-                        this.referenceManager.updateTargetRuntime(targetId, {
-                            status: 'tracked',
-                            lastSeen: Date.now()
-                        });
-
-                        // Check if we should trigger re-detection for quality
-                        if (flowResult.shouldRedetect) {
-                            // Will trigger full detection on next interval
-                            this.state.frameCount = this.state.detectionInterval - 1;
-                        }
-                    } else {
-                        // Optical flow failed
-                        if (flowResult.shouldRedetect) {
-                            // Force re-detection immediately
-                            this.state.trackedTargets.delete(targetId);
-                            this.opticalFlow.resetTrackingState(targetId);
-                            this.state.frameCount = this.state.detectionInterval - 1;
-                        }
-                        this.referenceManager.updateTargetRuntime(targetId, {
-                            status: 'lost'
-                        });
-                    }
-                }
-                // Clean up tracking data for non-active targets to save memory
-                for (const [targetId, tracked] of this.state.trackedTargets) {
-                    if (targetId !== this.state.activeVideoTarget) {
-                        if (tracked.lastFrame) tracked.lastFrame.delete();
-                        this.state.trackedTargets.delete(targetId);
-                        this.opticalFlow.resetTrackingState(targetId);
-                    }
-                }
-
-                this.profiler.endTimer('optical_flow_tracking');
-            }
-
-            // Select best target for video display (center-priority with resistance)
-            const selectedTargetId = this.selectBestTarget(
-                trackingResults,
-                frameToProcess.cols,
-                frameToProcess.rows
-            );
+            this.detector.candidateScores = null;
+            const trackingResults = this.pipeline.processFrame(this.grayFrame, targets);
+            this.referenceManager.trimReferenceCache();
+            this.noteVideoCandidates(this.detector.candidateScores);
 
             // Visualize optical flow feature points if enabled
             if (this.state.visualizeFlowPoints && this.visualizer) {
@@ -749,7 +704,7 @@ class ImageTracker {
                 );
 
                 if (resultWithFlow) {
-                    this.profiler.startTimer('visualization');
+                    this.profiler.startTimer(PerformanceProfiler.Span.VISUALIZATION);
 
                     // Render to output canvas with feature points
                     this.visualizer.renderResults(
@@ -761,55 +716,349 @@ class ImageTracker {
                         resultWithFlow.flowStatus // Flow status
                     );
 
-                    this.profiler.endTimer('visualization');
+                    this.profiler.endTimer(PerformanceProfiler.Span.VISUALIZATION);
                 }
             }
 
-            // Render AR overlays (tracking + videos + camera background)
-            if (this.arRenderer) {
-                this.profiler.startTimer('ar_rendering');
-
-                // Update video only for the selected target
-                if (selectedTargetId) {
-                    const selectedResult = trackingResults.find(r => r.targetId === selectedTargetId);
-                    if (selectedResult && selectedResult.success && selectedResult.corners) {
-                        const target = this.referenceManager.getTarget(selectedTargetId);
-                        if (target && target.videoUrl) {
-                            // Don't await - let it load asynchronously
-                            this.arRenderer.updateTarget(
-                                selectedTargetId,
-                                selectedResult.corners,
-                                target.videoUrl
-                            ).catch(err => {
-                                console.error('[ImageTracker] Video update error:', err);
-                            });
-                        }
+            this.renderTrackingResults(trackingResults, frameToProcess);
+
+            this.profiler.endTimer(PerformanceProfiler.Span.FRAME_TOTAL);
+            this.updateQualityGovernor();
+        } catch (error) {
+            console.error('Error in processVideo:', error);
+        } finally {
+            // Return the capture buffer to the pool
+            if (frameToProcess) {
+                MatPool.shared().release(frameToProcess);
+            }
+
+            // Mark processing as complete
+            this.state.isProcessing = false;
+        }
+    }
+
+    /**
+     * Worker-mode frame step: submit the frame and apply the results the
+     * worker returns for it
+     * @returns {Promise} Settles when the reply has been applied
+     */
+    processVideoWithWorker() {
+        this.state.isProcessing = true;
+
+        return this.camera.captureFrameSource(this.state.maxDimension)
+            .then(frame => {
+                if (!frame) return null;
+                this.profiler.startTimer(PerformanceProfiler.Span.WORKER_ROUNDTRIP);
+                return this.visionWorker.processFrame(frame, {
+                    activeVideoTarget: this.state.activeVideoTarget,
+                    detectionInterval: this.state.detectionInterval,
+                    useOpticalFlow: this.state.useOpticalFlow,
+                    maxFeatures: this.state.maxFeatures,
+                    pyramidLevels: this.state.pyramidLevels
+                });
+            })
+            .then(reply => {
+                if (!reply) return;
+                this.profiler.endTimer(PerformanceProfiler.Span.WORKER_ROUNDTRIP);
+                this.applyWorkerResult(reply);
+            })
+            .catch(error => {
+                console.error('[ImageTracker] Vision worker frame failed:', error);
+                // The worker crashed: hand tracking back to the main thread
+                if (this.visionWorker && !this.visionWorker.isReady) {
+                    this.disableVisionWorker(error);
+                }
+            })
+            .finally(() => {
+                this.state.isProcessing = false;
+            });
+    }
+
+    /**
+     * Apply a worker result message to main-thread state
+     * @param {Object} reply - Result message from VisionWorker
+     */
+    applyWorkerResult(reply) {
+        if (!this.state.isTracking) return;
+
+        // Log frame resolution on first frame
+        if (!this.workerFrameSize) {
+            console.log('[ImageTracker] Processed frame resolution (worker):', {
+                width: reply.width,
+                height: reply.height,
+                maxDimension: this.state.maxDimension
+            });
+        }
+
+        for (const { targetId, updates } of reply.statusUpdates || []) {
+            this.referenceManager.updateTargetRuntime(targetId, updates);
+        }
+        this.noteVideoCandidates(reply.candidates);
+
+        // Worker timings feed the same profiler the governor reads
+        this.profiler.beginFrame();
+        this.profiler.recordSamples(reply.timings, PerformanceProfiler.TRACK_WORKER);
+
+        const results = reply.results || [];
+        this.workerResults = results;
+        this.workerPoolStats = reply.poolStats || null;
+        this.workerFrameSize = { cols: reply.width, rows: reply.height };
+        if (typeof reply.frameCount === 'number') {
+            this.state.frameCount = reply.frameCount;
+        }
+
+        // Mirror tracked targets (corners only - frames stay in the worker)
+        const trackedIds = new Set(reply.trackedTargetIds || []);
+        for (const targetId of Array.from(this.state.trackedTargets.keys())) {
+            if (!trackedIds.has(targetId)) {
+                this.state.trackedTargets.delete(targetId);
+            }
+        }
+        for (const targetId of trackedIds) {
+            const result = results.find(r => r.targetId === targetId && r.success && r.corners);
+            const existing = this.state.trackedTargets.get(targetId);
+            this.state.trackedTargets.set(targetId, {
+                corners: result ? result.corners : (existing ? existing.corners : null)
+            });
+        }
+
+        // Visualize optical flow feature points if enabled
+        if (this.state.visualizeFlowPoints && this.visualizer) {
+            const resultWithFlow = results.find(r =>
+                r.prevFeaturePoints && r.nextFeaturePoints
+            );
+
+            if (resultWithFlow) {
+                this.profiler.startTimer(PerformanceProfiler.Span.VISUALIZATION);
+                this.visualizer.renderOverlay(
+                    resultWithFlow,
+                    this.ui.canvas,
+                    resultWithFlow.nextFeaturePoints,
+                    resultWithFlow.flowStatus
+                );
+                this.profiler.endTimer(PerformanceProfiler.Span.VISUALIZATION);
+            }
+        }
+
+        this.renderTrackingResults(results, this.workerFrameSize);
+
+        this.updateQualityGovernor();
+    }
+
+    /**
+     * Let the governor re-evaluate the frame budget and apply a new tier
+     */
+    updateQualityGovernor() {
+        if (!this.governor) return;
+
+        const tier = this.governor.update();
+        if (!tier) return;
+
+        const resolutionChanged = tier.maxDimension !== this.state.maxDimension;
+        Object.assign(this.state, QualityGovernor.stateFor(tier));
+
+        // Tracked keyframes and corners are in the old resolution: re-detect
+        if (resolutionChanged) {
+            if (this.pipeline) {
+                this.pipeline.reset();
+            }
+            if (this.visionWorker) {
+                this.visionWorker.reset();
+            }
+            this.state.trackedTargets.clear();
+            this.renderFilters.clear();
+        }
+
+        this.ui.updateQualityTier(this.governor.getStatus());
+    }
+
+    /**
+     * MatPool statistics of whichever thread runs the tracker
+     * @returns {Object} MatPool.getStats() plus its source ('worker' or 'main')
+     */
+    getMatPoolStats() {
+        if (this.isWorkerActive() && this.workerPoolStats) {
+            return { source: 'worker', ...this.workerPoolStats };
+        }
+        return { source: 'main', ...MatPool.shared().getStats() };
+    }
+
+    /**
+     * Feed the vocabulary ranking of a detection to video prefetch
+     * @param {Array|null} candidates - [{targetId, score}]
+     */
+    noteVideoCandidates(candidates) {
+        if (candidates && this.arRenderer && this.arRenderer.videoManager) {
+            this.arRenderer.videoManager.noteCandidates(candidates);
+        }
+    }
+
+    /**
+     * Record sightings and pre-buffer the videos of the likeliest targets,
+     * so switching to one does not wait on the network
+     * @param {Array} trackingResults
+     */
+    prefetchVideos(trackingResults) {
+        const videoManager = this.arRenderer.videoManager;
+        if (!videoManager) return;
+
+        for (const result of trackingResults) {
+            if (result.success) videoManager.noteSeen(result.targetId);
+        }
+        videoManager.prefetch(
+            this.referenceManager.getTargets(),
+            target => this.referenceManager.requestVideo(target.id)
+        );
+    }
+
+    /**
+     * Select the display target and render AR overlays for a set of results
+     * @param {Array} trackingResults - Results from the pipeline or the worker
+     * @param {{cols: number, rows: number}} frame - Processing frame (or its size)
+     * @returns {string|null} Selected target ID
+     */
+    renderTrackingResults(trackingResults, frame) {
+        // Select best target for video display (center-priority with resistance)
+        const selectedTargetId = this.selectBestTarget(
+            trackingResults,
+            frame.cols,
+            frame.rows
+        );
+
+        // Render AR overlays (tracking + videos + camera background)
+        if (this.arRenderer) {
+            this.profiler.startTimer(PerformanceProfiler.Span.AR_RENDERING);
+
+            // Update video only for the selected target
+            if (selectedTargetId) {
+                const selectedResult = trackingResults.find(r => r.targetId === selectedTargetId);
+                if (selectedResult && selectedResult.success && selectedResult.corners) {
+                    const target = this.referenceManager.getTarget(selectedTargetId);
+                    if (target && target.videoUrl) {
+                        // Don't await - let it load asynchronously
+                        this.arRenderer.updateTarget(
+                            selectedTargetId,
+                            selectedResult.corners,
+                            target.videoUrl
+                        ).catch(err => {
+                            console.error('[ImageTracker] Video update error:', err);
+                        });
+                    } else if (target && target.videoDeferred && !target.videoRequest) {
+                        // Streamed album: fetch the video now, overlay starts once it is in
+                        this.referenceManager.requestVideo(selectedTargetId).catch(err => {
+                            console.error('[ImageTracker] Deferred video load error:', err);
+                        });
                     }
                 }
+            }
+
+            this.prefetchVideos(trackingResults);
 
+            if (this.decoupledRender) {
+                // Drawn by the render loop at display rate
+                this.setRenderFrame(trackingResults, frame, selectedTargetId);
+            } else {
                 // Render everything (camera background + rectangles + videos)
                 // Pass processing frame for coordinate mapping
                 // Video element is used directly via VideoTexture (no display frame needed)
                 // Only render video for selected target
-                this.arRenderer.render(trackingResults, frameToProcess, selectedTargetId);
+                this.arRenderer.render(trackingResults, frame, selectedTargetId);
+            }
+
+            this.profiler.endTimer(PerformanceProfiler.Span.AR_RENDERING);
+        }
 
-                this.profiler.endTimer('ar_rendering');
+        // Update tracking mode indicator
+        this.ui.updateTrackingMode();
+
+        return selectedTargetId;
+    }
+
+    /**
+     * Hand a tracker update to the render loop and feed its corners into the
+     * per-target Kalman filters
+     * @param {Array} trackingResults - Results of one tracker update
+     * @param {{cols: number, rows: number}} frame - Processing frame (or its size)
+     * @param {string|null} selectedTargetId
+     */
+    setRenderFrame(trackingResults, frame, selectedTargetId) {
+        const now = performance.now();
+        const results = [];
+
+        for (const result of trackingResults) {
+            if (!result.success || !result.corners || result.corners.length !== 4) {
+                results.push(result);
+                continue;
             }
 
-            // Update tracking mode indicator
-            this.ui.updateTrackingMode();
+            let filters = this.renderFilters.get(result.targetId);
+            if (!filters) {
+                filters = this.opticalFlow.initializeKalmanFilters();
+                this.renderFilters.set(result.targetId, filters);
+            }
+            this.opticalFlow.applyKalmanSmoothing(result.corners, filters, now);
 
-            this.profiler.endTimer('frame_total');
-        } catch (error) {
-            console.error('Error in processVideo:', error);
-        } finally {
-            // Clean up resources
-            if (frameToProcess && !this.state.lastFrame || (this.state.lastFrame && frameToProcess !== this.state.lastFrame)) {
-                frameToProcess.delete();
+            // Own corner objects: the render loop overwrites them with predictions
+            results.push({
+                ...result,
+                corners: result.corners.map(corner => ({ x: corner.x, y: corner.y }))
+            });
+        }
+
+        // Lost targets start from rest when they come back
+        for (const targetId of Array.from(this.renderFilters.keys())) {
+            if (!results.some(r => r.targetId === targetId && r.success && r.corners)) {
+                this.renderFilters.delete(targetId);
             }
+        }
 
-            // Mark processing as complete
-            this.state.isProcessing = false;
+        this.renderFrame = {
+            results,
+            frame: { cols: frame.cols, rows: frame.rows },
+            selectedTargetId
+        };
+    }
+
+    /**
+     * Start the display-rate render loop (no-op if running or not decoupled)
+     */
+    startRenderLoop() {
+        if (!this.decoupledRender || this.renderLoopActive) return;
+
+        this.renderLoopActive = true;
+        requestAnimationFrame(() => this.renderLoop());
+    }
+
+    /**
+     * Draw the latest tracker update with corners extrapolated to now
+     */
+    renderLoop() {
+        if (!this.state.isTracking) {
+            this.renderLoopActive = false;
+            this.renderFrame = null;
+            this.renderFilters.clear();
+            return;
+        }
+
+        requestAnimationFrame(() => this.renderLoop());
+
+        const renderFrame = this.renderFrame;
+        if (!this.arRenderer || !renderFrame) return;
+
+        try {
+            const now = performance.now();
+            const maxLeadMs = AppConfig.rendering.maxPredictionMs;
+
+            for (const result of renderFrame.results) {
+                const filters = this.renderFilters.get(result.targetId);
+                if (filters && result.success && result.corners) {
+                    this.opticalFlow.predictKalmanCorners(filters, now, maxLeadMs, result.corners);
+                }
+            }
+
+            this.arRenderer.render(renderFrame.results, renderFrame.frame, renderFrame.selectedTargetId);
+        } catch (error) {
+            console.error('Error in renderLoop:', error);
         }
     }
 }
@@ -0,0 +1,153 @@
+/**
+ * QualityGovernor - Steps processing quality to hold a per-frame time budget
+ *
+ * Reads the PerformanceProfiler's rolling samples for frame_total,
+ * detection_total and optical_flow_tracking once per full window of new
+ * frames and moves between the tiers in AppConfig.governor.tiers (processing
+ * resolution, ORB feature budget, pyramid levels, detection interval).
+ * Stepping down needs several consecutive over-budget windows and stepping up
+ * several windows well under budget, so the tier does not oscillate.
+ */
+class QualityGovernor {
+  /**
+   * @param {PerformanceProfiler} profiler - Profiler the tracker records into
+   * @param {Object} options - Overrides for AppConfig.governor
+   */
+  constructor(profiler, options = {}) {
+    const config = { ...AppConfig.governor, ...options };
+
+    this.profiler = profiler;
+    this.tiers = config.tiers;
+    this.frameBudgetMs = config.frameBudgetMs;
+    this.upshiftRatio = config.upshiftRatio;
+    this.downshiftWindows = config.downshiftWindows;
+    this.upshiftWindows = config.upshiftWindows;
+
+    this.tierIndex = config.initialTier >= 0
+      ? Math.min(config.initialTier, this.tiers.length - 1)
+      : QualityGovernor.initialTierForDevice(this.tiers.length);
+
+    this.overBudget = 0; // Consecutive windows over budget
+    this.underBudget = 0; // Consecutive windows comfortably under budget
+    this.windowStart = 0; // frame_total sample count at the start of the window
+    this.lastCost = 0;
+  }
+
+  /**
+   * Starting tier from the core count (lower tiers on small devices)
+   * @param {number} tierCount
+   * @returns {number}
+   */
+  static initialTierForDevice(tierCount) {
+    const cores = (typeof navigator !== 'undefined' && navigator.hardwareConcurrency) || 4;
+    const tier = cores >= 8 ? 0 : cores >= 4 ? 1 : 2;
+    return Math.min(tier, tierCount - 1);
+  }
+
+  /**
+   * Tracker state fields for a tier
+   * @param {Object} tier
+   * @returns {Object}
+   */
+  static stateFor(tier) {
+    return {
+      maxDimension: tier.maxDimension,
+      maxFeatures: tier.maxFeatures,
+      pyramidLevels: tier.pyramidLevels,
+      detectionInterval: tier.detectionInterval
+    };
+  }
+
+  /**
+   * Current tier settings
+   * @returns {Object} {name, maxDimension, maxFeatures, pyramidLevels, detectionInterval}
+   */
+  get tier() {
+    return this.tiers[this.tierIndex];
+  }
+
+  /**
+   * Estimated cost of one tracker frame, in ms
+   * @returns {number|null} null until frame_total has samples
+   */
+  estimateCost() {
+    const frame = this.profiler.getRecentAverage('frame_total');
+    if (frame === null) return null;
+
+    // Detection runs once per interval; amortize it over the flow frames
+    const flow = this.profiler.getRecentAverage('optical_flow_tracking');
+    const detection = this.profiler.getRecentAverage('detection_total');
+    const amortized = (flow || 0) + (detection || 0) / Math.max(1, this.tier.detectionInterval);
+
+    return Math.max(frame, amortized);
+  }
+
+  /**
+   * Evaluate the budget; call once per tracker frame
+   * @returns {Object|null} The new tier when it changed, else null
+   */
+  update() {
+    const count = this.profiler.getSampleCount('frame_total');
+    const windowSize = this.profiler.getWindowSize();
+
+    // Judge only full windows of samples taken at the current tier
+    if (count - this.windowStart < windowSize) return null;
+    this.windowStart = count;
+
+    const cost = this.estimateCost();
+    if (cost === null) return null;
+    this.lastCost = cost;
+
+    if (cost > this.frameBudgetMs) {
+      this.overBudget++;
+      this.underBudget = 0;
+    } else if (cost < this.frameBudgetMs * this.upshiftRatio) {
+      this.underBudget++;
+      this.overBudget = 0;
+    } else {
+      this.overBudget = 0;
+      this.underBudget = 0;
+    }
+
+    if (this.overBudget >= this.downshiftWindows && this.tierIndex < this.tiers.length - 1) {
+      return this.setTier(this.tierIndex + 1, cost);
+    }
+    if (this.underBudget >= this.upshiftWindows && this.tierIndex > 0) {
+      return this.setTier(this.tierIndex - 1, cost);
+    }
+    return null;
+  }
+
+  /**
+   * @private
+   */
+  setTier(index, cost) {
+    const from = this.tier.name;
+    this.tierIndex = index;
+    this.overBudget = 0;
+    this.underBudget = 0;
+
+    console.log(`[QualityGovernor] ${from} -> ${this.tier.name} ` +
+      `(${cost.toFixed(1)}ms vs ${this.frameBudgetMs}ms budget)`);
+    return this.tier;
+  }
+
+  /**
+   * Snapshot for the debug UI / export
+   * @returns {Object}
+   */
+  getStatus() {
+    return {
+      tier: this.tier.name,
+      tierIndex: this.tierIndex,
+      tierCount: this.tiers.length,
+      frameBudgetMs: this.frameBudgetMs,
+      lastCostMs: Math.round(this.lastCost * 100) / 100
+    };
+  }
+}
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.QualityGovernor = QualityGovernor;
+}
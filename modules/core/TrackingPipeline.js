@@ -0,0 +1,644 @@
+/**
+ * TrackingPipeline - Per-frame detection / optical flow state machine
+ *
+ * Owns the "detect every N frames, track with optical flow in between"
+ * logic so it can run either on the main thread (ImageTracker fallback) or
+ * inside the vision worker. The pipeline never touches the DOM; target
+ * runtime changes are reported through the onTargetStatus callback.
+ *
+ * With a background detector the pipeline is pipelined: detection is
+ * launched on frame N and optical flow keeps tracking frames N+1..N+k.
+ * When the result arrives it is propagated through the flow motion
+ * accumulated since frame N before it replaces the tracked corners.
+ */
+class TrackingPipeline {
+  /**
+   * @param {Object} state - Tracker state (detectionInterval, frameCount, trackedTargets, ...)
+   * @param {FeatureDetector} detector - Feature detector instance
+   * @param {OpticalFlowTracker} opticalFlow - Optical flow tracker instance
+   * @param {PerformanceProfiler} profiler - Profiler (optional)
+   * @param {Object} options
+   * @param {Function} options.onTargetStatus - (targetId, updates) runtime status callback
+   * @param {Object} options.backgroundDetector - Optional {isAvailable(), detect(frame, targets)}
+   *   where detect returns a Promise of detection results for the given frame
+   */
+  constructor(state, detector, opticalFlow, profiler = null, options = {}) {
+    this.state = state;
+    this.detector = detector;
+    this.opticalFlow = opticalFlow;
+    this.profiler = profiler;
+    this.onTargetStatus = options.onTargetStatus || (() => {});
+    this.backgroundDetector = options.backgroundDetector || null;
+
+    // Keyframe and launch-frame buffers are recycled through the pool
+    this.pool = MatPool.shared();
+
+    // One grayscale keyframe per frame, shared by every target measured in
+    // it and by the detection launch; freed when the last holder lets go
+    this.keyframe = null; // {seq, mat, refs} for the newest retained frame
+
+    // Pipelined detection bookkeeping
+    this.frameSeq = 0;
+    this.generation = 0; // Bumped on reset so stale results are discarded
+    this.pendingDetection = null; // {seq, keyframe, frame, corners: Map} while the detector runs
+    this.completedDetection = null; // {launch, results} waiting to be merged
+  }
+
+  /**
+   * Run detection or optical flow for one frame
+   * @param {cv.Mat} frame - Processing frame (owned by caller)
+   * @param {Array} targets - Runtime targets with referenceData
+   * @returns {Array} Tracking results (one per detected/tracked target)
+   */
+  processFrame(frame, targets) {
+    const state = this.state;
+
+    // Increment frame counter
+    state.frameCount++;
+    this.frameSeq++;
+
+    if (!targets || targets.length === 0) {
+      return [];
+    }
+
+    const shouldRunDetector = state.frameCount % state.detectionInterval === 0 ||
+                              !state.useOpticalFlow;
+
+    if (this.isPipelined()) {
+      return this.processFramePipelined(frame, targets, shouldRunDetector);
+    }
+
+    if (shouldRunDetector) {
+      return this.runDetection(frame, targets);
+    }
+
+    return this.runOpticalFlow(frame, targets);
+  }
+
+  /**
+   * Whether detection can run in the background for this frame
+   * @returns {boolean}
+   */
+  isPipelined() {
+    return !!(AppConfig.detection.pipelined && this.backgroundDetector &&
+              this.backgroundDetector.isAvailable());
+  }
+
+  /**
+   * Pipelined frame step: optical flow never waits on the detector
+   * @private
+   */
+  processFramePipelined(frame, targets, shouldRunDetector) {
+    const state = this.state;
+
+    // Track the held targets from the previous frame
+    const trackingResults = state.useOpticalFlow ? this.runOpticalFlow(frame, targets) : [];
+
+    // Fold in a detection that finished since the last frame
+    if (this.completedDetection) {
+      const detectionResults = this.mergeBackgroundDetection(frame);
+      for (const result of detectionResults) {
+        const index = trackingResults.findIndex(r => r.targetId === result.targetId);
+        if (index >= 0) {
+          trackingResults[index] = result;
+        } else {
+          trackingResults.push(result);
+        }
+      }
+    }
+
+    // Launch the next detection; re-acquire continuously while nothing is tracked
+    if (!this.pendingDetection &&
+        (shouldRunDetector || state.trackedTargets.size === 0)) {
+      this.launchBackgroundDetection(frame, targets);
+    }
+
+    return trackingResults;
+  }
+
+  /**
+   * Hand a frame to the background detector and remember the tracked
+   * corners at launch time for later propagation
+   * @private
+   */
+  launchBackgroundDetection(frame, targets) {
+    const generation = this.generation;
+    const keyframe = this.retainKeyframe(frame);
+    const launch = {
+      seq: this.frameSeq,
+      keyframe,
+      frame: keyframe.mat,
+      corners: new Map()
+    };
+    for (const [targetId, tracked] of this.state.trackedTargets) {
+      if (tracked.corners) launch.corners.set(targetId, tracked.corners.slice());
+    }
+
+    let promise;
+    try {
+      promise = this.backgroundDetector.detect(frame, targets);
+    } catch (error) {
+      promise = Promise.reject(error);
+    }
+    if (!promise) {
+      this.releaseKeyframe(keyframe);
+      return;
+    }
+
+    this.pendingDetection = launch;
+    // Ends outside this frame, so it is recorded directly rather than as a nested timer
+    const launchedAt = performance.now();
+
+    promise.then(results => {
+      if (generation !== this.generation) {
+        this.releaseKeyframe(keyframe);
+        return;
+      }
+      this.profiler?.record(PerformanceProfiler.Span.DETECTION_LATENCY, performance.now() - launchedAt, launchedAt);
+      this.completedDetection = { launch, results: results || [] };
+    }).catch(error => {
+      console.warn('[TrackingPipeline] Background detection failed:', error);
+      this.releaseKeyframe(keyframe);
+    }).finally(() => {
+      if (this.pendingDetection === launch) {
+        this.pendingDetection = null;
+      }
+    });
+  }
+
+  /**
+   * Propagate a finished background detection to the current frame and
+   * store it as the new tracking state
+   * @private
+   */
+  mergeBackgroundDetection(frame) {
+    const { launch, results } = this.completedDetection;
+    this.completedDetection = null;
+
+    const merged = [];
+    const framesBehind = this.frameSeq - launch.seq;
+
+    this.profiler?.startTimer(PerformanceProfiler.Span.DETECTION_PROPAGATION);
+    try {
+      for (const result of results) {
+        if (!result.success || !result.corners) {
+          if (!this.state.trackedTargets.has(result.targetId)) {
+            this.onTargetStatus(result.targetId, { status: 'lost' });
+          }
+          continue;
+        }
+
+        const corners = framesBehind === 0 ?
+          result.corners :
+          this.propagateCorners(result.targetId, result.corners, launch, frame);
+
+        if (!corners) {
+          if (!this.state.trackedTargets.has(result.targetId)) {
+            this.onTargetStatus(result.targetId, { status: 'lost' });
+          }
+          continue;
+        }
+
+        this.storeTrackedTarget(result.targetId, corners, frame);
+        this.resetFlowStateForDetection(result.targetId, corners);
+
+        this.onTargetStatus(result.targetId, {
+          status: 'tracked',
+          lastSeen: Date.now(),
+          score: result.score
+        });
+
+        merged.push({ ...result, corners, success: true, propagatedFrames: framesBehind });
+      }
+    } finally {
+      this.releaseKeyframe(launch.keyframe);
+      this.profiler?.endTimer(PerformanceProfiler.Span.DETECTION_PROPAGATION);
+    }
+
+    return merged;
+  }
+
+  /**
+   * Move corners detected in the launch frame into the current frame.
+   * Targets tracked throughout use the homography between their corners at
+   * launch and now (the product of the per-frame flow homographies); other
+   * targets are carried over with a single optical flow step.
+   * @private
+   * @returns {Array|null} Corners in the current frame
+   */
+  propagateCorners(targetId, detectedCorners, launch, frame) {
+    const launchCorners = launch.corners.get(targetId);
+    const current = this.state.trackedTargets.get(targetId);
+
+    if (launchCorners && current && current.corners) {
+      return TrackingPipeline.transformCorners(launchCorners, current.corners, detectedCorners);
+    }
+
+    this.opticalFlow.resetTrackingState(targetId);
+    this.resetFlowStateForDetection(targetId, detectedCorners);
+    const flowResult = this.opticalFlow.track(launch.frame, frame, detectedCorners, targetId);
+    return flowResult.success ? flowResult.corners : null;
+  }
+
+  /**
+   * Apply the homography mapping `from` onto `to` (4 corners each) to points
+   * @returns {Array|null}
+   */
+  static transformCorners(from, to, points) {
+    const pool = MatPool.shared();
+    let homography = null;
+
+    try {
+      const src = pool.fromArray('propagate_src', 4, cv.CV_32FC2, from.flatMap(p => [p.x, p.y]));
+      const dst = pool.fromArray('propagate_dst', 4, cv.CV_32FC2, to.flatMap(p => [p.x, p.y]));
+      homography = cv.getPerspectiveTransform(src, dst);
+
+      const input = pool.fromArray('propagate_input', points.length, cv.CV_32FC2, points.flatMap(p => [p.x, p.y]));
+      const output = pool.scratch('propagate_output');
+      cv.perspectiveTransform(input, output, homography);
+
+      const transformed = [];
+      for (let i = 0; i < points.length; i++) {
+        const x = output.data32F[i * 2];
+        const y = output.data32F[i * 2 + 1];
+        if (!Number.isFinite(x) || !Number.isFinite(y)) return null;
+        transformed.push({ x, y });
+      }
+      return transformed;
+    } catch (error) {
+      console.warn('[TrackingPipeline] Corner propagation failed:', error);
+      return null;
+    } finally {
+      if (homography) homography.delete();
+    }
+  }
+
+  /**
+   * Full detection pass over all targets, with optical flow fallback for
+   * targets that were tracked but not re-detected
+   * @private
+   */
+  runDetection(frame, targets) {
+    const state = this.state;
+
+    // Always detect all targets to enable switching between them
+    // This allows us to see which target is closest to center
+    this.profiler?.startTimer(PerformanceProfiler.Span.DETECTION_TOTAL);
+    const trackingResults = this.detector.detectMultipleTargets(frame, targets);
+    this.profiler?.endTimer(PerformanceProfiler.Span.DETECTION_TOTAL);
+
+    // Update tracked targets with detection results
+    const fallback = [];
+    for (const result of trackingResults) {
+      if (result.success && result.corners) {
+        this.storeTrackedTarget(result.targetId, result.corners, frame);
+
+        // Reset optical flow tracking state on new detection
+        // This initializes Kalman filters and geometric state
+        this.resetFlowStateForDetection(result.targetId, result.corners);
+
+        this.onTargetStatus(result.targetId, {
+          status: 'tracked',
+          lastSeen: Date.now(),
+          score: result.score
+        });
+      } else if (state.useOpticalFlow && state.trackedTargets.has(result.targetId)) {
+        fallback.push(result);
+      } else {
+        // No detection and no tracking data
+        this.onTargetStatus(result.targetId, { status: 'lost' });
+      }
+    }
+
+    // Detection failed but we have tracking data - try optical flow
+    if (fallback.length > 0) {
+      this.profiler?.startTimer(PerformanceProfiler.Span.OPTICAL_FLOW_FALLBACK);
+      const flowResults = this.trackTargets(fallback.map(result => result.targetId), frame, targets);
+      this.profiler?.endTimer(PerformanceProfiler.Span.OPTICAL_FLOW_FALLBACK);
+
+      fallback.forEach((result, i) => {
+        if (flowResults[i].success) {
+          trackingResults[trackingResults.indexOf(result)] = {
+            ...result,
+            ...flowResults[i],
+            success: true
+          };
+        }
+      });
+    }
+
+    return trackingResults;
+  }
+
+  /**
+   * Optical flow pass. In multi-target mode every tracked target is kept
+   * (up to tracking.maxTrackedTargets, the active one first); otherwise
+   * only the active (video) target is
+   * @private
+   */
+  runOpticalFlow(frame, targets) {
+    const state = this.state;
+    const trackingResults = [];
+
+    this.profiler?.startTimer(PerformanceProfiler.Span.OPTICAL_FLOW_TRACKING);
+
+    const targetIds = this.selectFlowTargets();
+
+    // Clean up tracking data for the other targets to save memory
+    for (const id of Array.from(state.trackedTargets.keys())) {
+      if (!targetIds.includes(id)) {
+        this.dropTrackedTarget(id);
+      }
+    }
+
+    const flowResults = this.trackTargets(targetIds, frame, targets);
+    targetIds.forEach((targetId, i) => {
+      if (flowResults[i].success) {
+        const target = targets.find(t => t.id === targetId);
+        trackingResults.push({
+          targetId,
+          targetLabel: target?.label || targetId,
+          ...flowResults[i],
+          success: true
+        });
+      }
+    });
+
+    this.profiler?.endTimer(PerformanceProfiler.Span.OPTICAL_FLOW_TRACKING);
+
+    return trackingResults;
+  }
+
+  /**
+   * Tracked targets the optical flow pass follows this frame
+   * @private
+   * @returns {Array<string>}
+   */
+  selectFlowTargets() {
+    const state = this.state;
+    const activeId = state.activeVideoTarget;
+    const hasActive = !!activeId && state.trackedTargets.has(activeId);
+
+    // OPTIMIZATION: Single-video mode tracks only the active target
+    if (!AppConfig.tracking.multiTarget) {
+      return hasActive ? [activeId] : [];
+    }
+
+    const targetIds = Array.from(state.trackedTargets.keys()).filter(id => id !== activeId);
+    if (hasActive) targetIds.unshift(activeId);
+    return targetIds.slice(0, Math.max(1, AppConfig.tracking.maxTrackedTargets));
+  }
+
+  /**
+   * Track targets from their last frames into the current frame. Targets
+   * measured in the same keyframe (the usual case: they were detected or
+   * tracked together) share one OpticalFlowTracker.trackMany() call, so
+   * gray conversion, seeding and the pyramidal flow run once for all of them.
+   * @param {Array<string>} targetIds - Ids held in state.trackedTargets
+   * @param {cv.Mat} frame
+   * @param {Array} targets - Runtime targets (enable region re-detection)
+   * @returns {Array<Object>} Flow results in targetIds order
+   */
+  trackTargets(targetIds, frame, targets) {
+    const state = this.state;
+
+    const groups = new Map(); // lastFrame -> indices into targetIds
+    targetIds.forEach((targetId, index) => {
+      const { lastFrame } = state.trackedTargets.get(targetId);
+      if (!groups.has(lastFrame)) groups.set(lastFrame, []);
+      groups.get(lastFrame).push(index);
+    });
+
+    const results = new Array(targetIds.length);
+    for (const [lastFrame, indices] of groups) {
+      const flowResults = this.opticalFlow.trackMany(lastFrame, frame, indices.map(index => ({
+        targetId: targetIds[index],
+        corners: state.trackedTargets.get(targetIds[index]).corners
+      })));
+
+      indices.forEach((index, i) => {
+        const targetId = targetIds[index];
+        const target = targets.find(t => t.id === targetId) || null;
+        results[index] = this.applyFlowResult(targetId, frame, target, flowResults[i]);
+      });
+    }
+    return results;
+  }
+
+  /**
+   * Update one target's tracked state / re-detection scheduling from its
+   * optical flow result. Quality-driven re-detection first searches the
+   * target's predicted region; a full detection is scheduled only when that
+   * misses.
+   * @private
+   * @param {string} targetId
+   * @param {cv.Mat} frame
+   * @param {Object} target - Runtime target (enables region re-detection)
+   * @param {Object} flowResult - OpticalFlowTracker result for the target
+   * @returns {Object} Optical flow result, or the region detection merged into it
+   */
+  applyFlowResult(targetId, frame, target, flowResult) {
+    const tracked = this.state.trackedTargets.get(targetId);
+
+    if (flowResult.success) {
+      // Update tracking data
+      this.storeTrackedTarget(targetId, flowResult.corners, frame);
+
+      this.onTargetStatus(targetId, {
+        status: 'tracked',
+        lastSeen: Date.now()
+      });
+
+      // Check if we should trigger re-detection for quality; other targets
+      // keep their flow corners until the next interval's detection
+      if (flowResult.shouldRedetect && this.isPrimaryTarget(targetId)) {
+        const redetected = this.redetectInRegion(targetId, frame, target, flowResult.corners);
+        if (redetected) {
+          return { ...flowResult, ...redetected, shouldRedetect: false };
+        }
+        // Will trigger full detection on next interval
+        this.scheduleRedetection();
+      }
+    } else {
+      // Optical flow failed - look where the target was, else force re-detection
+      if (flowResult.shouldRedetect) {
+        const primary = this.isPrimaryTarget(targetId);
+        const redetected = primary && this.redetectInRegion(targetId, frame, target, tracked.corners);
+        if (redetected) {
+          return { ...flowResult, ...redetected, shouldRedetect: false };
+        }
+        this.dropTrackedTarget(targetId);
+        if (primary) this.scheduleRedetection();
+      }
+      this.onTargetStatus(targetId, { status: 'lost' });
+    }
+
+    return flowResult;
+  }
+
+  /**
+   * Whether a target's tracking problems are worth an extra detection (region
+   * or full). In multi-target mode only the active target's are; the others
+   * wait for the regular interval, so holding more targets never adds
+   * detection work.
+   * @private
+   */
+  isPrimaryTarget(targetId) {
+    return !AppConfig.tracking.multiTarget || this.state.activeVideoTarget === targetId;
+  }
+
+  /**
+   * Detect a tracked target inside its predicted region and make the result
+   * the new tracking state
+   * @private
+   * @returns {Object|null} Detection result, or null when disabled or not found
+   */
+  redetectInRegion(targetId, frame, target, corners) {
+    if (!AppConfig.detection.roiRedetection || !target?.referenceData || !corners) {
+      return null;
+    }
+
+    this.profiler?.startTimer(PerformanceProfiler.Span.DETECTION_REGION);
+    const result = this.detector.detectTargetInRegion(frame, target, corners);
+    this.profiler?.endTimer(PerformanceProfiler.Span.DETECTION_REGION);
+
+    if (!result.success || !result.corners) return null;
+
+    this.storeTrackedTarget(targetId, result.corners, frame);
+    this.resetFlowStateForDetection(targetId, result.corners);
+    this.onTargetStatus(targetId, {
+      status: 'tracked',
+      lastSeen: Date.now(),
+      score: result.score
+    });
+
+    return result;
+  }
+
+  /**
+   * Store corners and a reference to the keyframe they were measured in
+   * @private
+   */
+  storeTrackedTarget(targetId, corners, frame) {
+    const existing = this.state.trackedTargets.get(targetId);
+
+    // Retain before releasing: the old keyframe may be this frame's
+    const keyframe = this.retainKeyframe(frame);
+    if (existing) this.releaseKeyframe(existing.keyframe);
+
+    this.state.trackedTargets.set(targetId, {
+      corners: corners.slice(),
+      keyframe,
+      lastFrame: keyframe.mat
+    });
+  }
+
+  /**
+   * Get the shared grayscale keyframe for the current frame, copying the
+   * frame only on first use within this frame step
+   * @private
+   * @param {cv.Mat} frame - Current processing frame
+   * @returns {{seq: number, mat: cv.Mat, refs: number}}
+   */
+  retainKeyframe(frame) {
+    const current = this.keyframe;
+    if (current && current.seq === this.frameSeq && current.refs > 0) {
+      current.refs++;
+      return current;
+    }
+
+    const mat = this.pool.acquire(frame.rows, frame.cols, cv.CV_8UC1);
+    const channels = frame.channels();
+    if (channels === 1) {
+      frame.copyTo(mat);
+    } else {
+      cv.cvtColor(frame, mat, channels === 4 ? cv.COLOR_RGBA2GRAY : cv.COLOR_RGB2GRAY);
+    }
+
+    this.keyframe = { seq: this.frameSeq, mat, refs: 1 };
+    return this.keyframe;
+  }
+
+  /**
+   * Drop one reference; the Mat returns to the pool with the last one
+   * @private
+   */
+  releaseKeyframe(keyframe) {
+    if (!keyframe || keyframe.refs <= 0) return;
+
+    keyframe.refs--;
+    if (keyframe.refs === 0) {
+      this.pool.release(keyframe.mat);
+      if (this.keyframe === keyframe) this.keyframe = null;
+    }
+  }
+
+  /**
+   * Prime the optical flow geometry/quality state after a fresh detection
+   * @private
+   */
+  resetFlowStateForDetection(targetId, corners) {
+    const trackState = this.opticalFlow.getTrackingState(targetId);
+    trackState.framesSinceDetection = 0;
+    trackState.consecutivePoorFrames = 0;
+    trackState.prevScale = this.opticalFlow.calculateScale(corners);
+    trackState.prevRotation = this.opticalFlow.calculateRotation(corners);
+    trackState.prevAspectRatio = this.opticalFlow.calculateAspectRatio(corners);
+
+    // Flow points belong to the old keyframe; re-seed on the detection frame
+    trackState.trackedPoints = null;
+    trackState.lastFeatureRefresh = 0;
+  }
+
+  /**
+   * Forget a tracked target and its optical flow state
+   * @param {string} targetId
+   */
+  dropTrackedTarget(targetId) {
+    const tracked = this.state.trackedTargets.get(targetId);
+    if (tracked) {
+      this.releaseKeyframe(tracked.keyframe);
+    }
+    this.state.trackedTargets.delete(targetId);
+    this.opticalFlow.resetTrackingState(targetId);
+  }
+
+  /**
+   * Make the next frame a detection frame
+   */
+  scheduleRedetection() {
+    this.state.frameCount = this.state.detectionInterval - 1;
+  }
+
+  /**
+   * Get ids of targets currently held for optical flow
+   * @returns {Array<string>}
+   */
+  getTrackedTargetIds() {
+    return Array.from(this.state.trackedTargets.keys());
+  }
+
+  /**
+   * Drop all tracking data and reset the frame counter
+   */
+  reset() {
+    for (const targetId of this.getTrackedTargetIds()) {
+      this.dropTrackedTarget(targetId);
+      this.onTargetStatus(targetId, { status: 'idle' });
+    }
+    this.state.frameCount = 0;
+
+    // In-flight detection is discarded when it resolves
+    this.generation++;
+    this.pendingDetection = null;
+    if (this.completedDetection) {
+      this.releaseKeyframe(this.completedDetection.launch.keyframe);
+      this.completedDetection = null;
+    }
+  }
+}
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.TrackingPipeline = TrackingPipeline;
+}
@@ -0,0 +1,263 @@
+/**
+ * FlatVocabularyTree - Vocabulary tree packed into contiguous typed arrays
+ *
+ * The JSON tree ({isLeaf, centers, children}) is flattened once into a
+ * struct-of-arrays node table and a single Int32Array of cluster centers,
+ * so quantization is a tight loop over 32-bit words with no per-descriptor
+ * allocation. Word ids match VocabularyBuilder._quantizeDescriptorHierarchical
+ * exactly (leaf-order numbering, same fallback when a child is missing).
+ */
+class FlatVocabularyTree {
+  /**
+   * @param {Object} layout - Output of FlatVocabularyTree.flatten()
+   */
+  constructor(layout) {
+    this.descriptorBytes = layout.descriptorBytes;
+    this.descriptorWords = layout.descriptorWords;
+    this.nodeCount = layout.nodeCount;
+    this.wordCount = layout.wordCount;
+
+    // Node table (index 0 is the root)
+    this.centerStart = layout.centerStart; // Int32Array - first center of node
+    this.centerCount = layout.centerCount; // Int32Array
+    this.childStart = layout.childStart; // Int32Array - children are contiguous
+    this.childCount = layout.childCount; // Int32Array
+    this.wordOffset = layout.wordOffset; // Int32Array - first word id in subtree
+    this.isLeaf = layout.isLeaf; // Uint8Array
+
+    // Centers, descriptorWords 32-bit words per center. Int32 rather than
+    // Uint32 so reads stay small integers in V8; XOR/popcount are unaffected
+    this.centers = layout.centers;
+
+    // Staging buffer for descriptors that cannot be viewed as words in place
+    this.staging = null;
+  }
+
+  /**
+   * Build from a vocabulary tree, or from a layout that was already
+   * flattened (exported database / binary cache)
+   * @param {Object} tree - Root node {isLeaf, centers, children} or layout
+   * @returns {FlatVocabularyTree}
+   */
+  static fromTree(tree) {
+    if (FlatVocabularyTree.isLayout(tree)) {
+      return new FlatVocabularyTree(tree);
+    }
+    return new FlatVocabularyTree(FlatVocabularyTree.flatten(tree));
+  }
+
+  /**
+   * @param {Object} value
+   * @returns {boolean} True for output of flatten()
+   */
+  static isLayout(value) {
+    return !!value && ArrayBuffer.isView(value.centerStart);
+  }
+
+  /**
+   * Flatten a tree breadth-first so each node's children are contiguous
+   * @param {Object} tree - Root node
+   * @returns {Object} Typed-array layout
+   */
+  static flatten(tree) {
+    const nodes = [];
+    const queue = [tree];
+    let totalCenters = 0;
+    let descriptorBytes = 0;
+
+    for (let head = 0; head < queue.length; head++) {
+      const node = queue[head];
+      nodes.push(node);
+      totalCenters += node.centers.length;
+      if (!descriptorBytes && node.centers.length > 0) {
+        descriptorBytes = node.centers[0].length;
+      }
+      if (!node.isLeaf && node.children) {
+        for (const child of node.children) queue.push(child);
+      }
+    }
+
+    const nodeCount = nodes.length;
+    const descriptorWords = Math.ceil(descriptorBytes / 4);
+    const layout = {
+      descriptorBytes,
+      descriptorWords,
+      nodeCount,
+      wordCount: 0,
+      centerStart: new Int32Array(nodeCount),
+      centerCount: new Int32Array(nodeCount),
+      childStart: new Int32Array(nodeCount),
+      childCount: new Int32Array(nodeCount),
+      wordOffset: new Int32Array(nodeCount),
+      isLeaf: new Uint8Array(nodeCount),
+      centers: new Int32Array(totalCenters * descriptorWords)
+    };
+
+    // Centers packed little-endian into 32-bit words (zero padded)
+    const centerBytes = new Uint8Array(layout.centers.buffer);
+    const stride = descriptorWords * 4;
+    let nextCenter = 0;
+    let nextChild = 1;
+
+    for (let n = 0; n < nodeCount; n++) {
+      const node = nodes[n];
+      layout.centerStart[n] = nextCenter;
+      layout.centerCount[n] = node.centers.length;
+      layout.isLeaf[n] = node.isLeaf ? 1 : 0;
+
+      for (const center of node.centers) {
+        const base = nextCenter * stride;
+        for (let b = 0; b < descriptorBytes; b++) {
+          centerBytes[base + b] = center[b];
+        }
+        nextCenter++;
+      }
+
+      const children = !node.isLeaf && node.children ? node.children.length : 0;
+      layout.childStart[n] = nextChild;
+      layout.childCount[n] = children;
+      nextChild += children;
+    }
+
+    // Word offsets follow leaf order, i.e. a depth-first walk
+    const assignOffsets = (n, offset) => {
+      layout.wordOffset[n] = offset;
+      if (layout.isLeaf[n]) {
+        return offset + layout.centerCount[n];
+      }
+      for (let c = 0; c < layout.childCount[n]; c++) {
+        offset = assignOffsets(layout.childStart[n] + c, offset);
+      }
+      return offset;
+    };
+    layout.wordCount = assignOffsets(0, 0);
+
+    return layout;
+  }
+
+  /**
+   * Rebuild the node tree VocabularyBuilder works on from a layout.
+   * Centers are views into layout.centers, not copies.
+   * @param {Object} layout - Output of flatten()
+   * @returns {Object} Root node {level, isLeaf, centers, children}
+   */
+  static toTree(layout) {
+    const stride = layout.descriptorWords * 4;
+    const centerBytes = new Uint8Array(
+      layout.centers.buffer, layout.centers.byteOffset, layout.centers.byteLength
+    );
+
+    const build = (n, level) => {
+      const centers = [];
+      for (let c = 0; c < layout.centerCount[n]; c++) {
+        const base = (layout.centerStart[n] + c) * stride;
+        centers.push(centerBytes.subarray(base, base + layout.descriptorBytes));
+      }
+
+      if (layout.isLeaf[n]) {
+        return { level, isLeaf: true, centers, children: null };
+      }
+
+      const children = [];
+      for (let c = 0; c < layout.childCount[n]; c++) {
+        children.push(build(layout.childStart[n] + c, level + 1));
+      }
+      return { level, isLeaf: false, centers, children };
+    };
+
+    return build(0, 0);
+  }
+
+  /**
+   * Quantize every row of a descriptor Mat
+   * @param {cv.Mat} descriptors - CV_8U, one descriptor per row
+   * @param {Int32Array} out - Optional output buffer (length >= rows)
+   * @returns {Int32Array} Word id per row
+   */
+  quantizeMat(descriptors, out = null) {
+    const rows = descriptors.rows;
+    const cols = descriptors.cols;
+    const words = this.getDescriptorWords(descriptors.data, rows, cols);
+    const ids = out && out.length >= rows ? out : new Int32Array(rows);
+
+    for (let i = 0; i < rows; i++) {
+      ids[i] = this.quantize(words, i * this.descriptorWords);
+    }
+    return ids;
+  }
+
+  /**
+   * View descriptor bytes as 32-bit words, copying only when the rows are
+   * misaligned or not a whole number of words
+   * @private
+   */
+  getDescriptorWords(bytes, rows, cols) {
+    const stride = this.descriptorWords * 4;
+    if (cols === stride && bytes.byteOffset % 4 === 0) {
+      return new Int32Array(bytes.buffer, bytes.byteOffset, rows * this.descriptorWords);
+    }
+
+    const needed = rows * stride;
+    if (!this.staging || this.staging.length < needed) {
+      this.staging = new Uint8Array(needed);
+    }
+    const staging = this.staging;
+    const copy = Math.min(cols, this.descriptorBytes);
+    for (let i = 0; i < rows; i++) {
+      staging.set(bytes.subarray(i * cols, i * cols + copy), i * stride);
+      staging.fill(0, i * stride + copy, (i + 1) * stride);
+    }
+    return new Int32Array(staging.buffer, 0, rows * this.descriptorWords);
+  }
+
+  /**
+   * Walk one descriptor from the root to its leaf word
+   * @param {Int32Array} words - Packed descriptors
+   * @param {number} base - Index of the descriptor's first word
+   * @returns {number} Word id
+   */
+  quantize(words, base) {
+    const centers = this.centers;
+    const descriptorWords = this.descriptorWords;
+    const centerStart = this.centerStart;
+    const centerCount = this.centerCount;
+    let node = 0;
+
+    for (;;) {
+      const first = centerStart[node];
+      const count = centerCount[node];
+      let best = 0;
+      let bestDist = 0x7fffffff;
+
+      for (let c = 0; c < count; c++) {
+        const centerBase = (first + c) * descriptorWords;
+        let dist = 0;
+        for (let w = 0; w < descriptorWords; w++) {
+          // SWAR popcount kept in int32 range so V8 stays on integer ops
+          let x = words[base + w] ^ centers[centerBase + w];
+          x = (x - ((x >> 1) & 0x55555555)) | 0;
+          x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+          dist += Math.imul((x + (x >> 4)) & 0x0F0F0F0F, 0x01010101) >>> 24;
+        }
+        if (dist < bestDist) {
+          bestDist = dist;
+          best = c;
+        }
+      }
+
+      if (this.isLeaf[node]) {
+        return this.wordOffset[node] + best;
+      }
+      if (best >= this.childCount[node]) {
+        // Matches the recursive walk when the chosen child does not exist
+        return this.wordOffset[node];
+      }
+      node = this.childStart[node] + best;
+    }
+  }
+}
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.FlatVocabularyTree = FlatVocabularyTree;
+}
@@ -21,9 +21,17 @@ class VocabularyBuilder {
 
     this.vocabulary = null;
     this.vocabularyTree = null; // Hierarchical tree structure
+    this.flatTreeLayout = null; // FlatVocabularyTree.flatten(vocabularyTree), built on export
     this.idfWeights = null;
+    this.invertedIndex = null; // word -> posting list of weighted targets
     this.targets = [];
 
+    // Incremental updates: mean word distance of the descriptors the tree was
+    // built from, and how many targets were added since without re-clustering
+    this.quantizationBaseline = null;
+    this.incrementalTargets = 0;
+    this.pendingFeatures = null; // targetId -> features an abandoned incremental update extracted
+
     // ORB detector params (must match live detector in FeatureDetector.js)
     this.orbParams = {
       nfeatures: AppConfig.orb.nfeatures,
@@ -45,6 +53,11 @@ class VocabularyBuilder {
 
     this.onProgress = options.onProgress || (() => {});
 
+    // Optional VocabularyWorkerPool: fans out feature extraction and the
+    // k-means assignment step. Started lazily on a cache miss.
+    this.workerPool = options.workerPool || null;
+    this.extractor = null; // Reused ORB + TEBLID pair, see _extractor()
+
     // Cache manager for storing vocabulary trees
     this.cacheManager = null;
     this.albumCode = options.albumCode || null;
@@ -56,7 +69,8 @@ class VocabularyBuilder {
    */
   async initCacheManager() {
     try {
-      if (!window.CacheManager) {
+      // No window (and no cache) inside build workers
+      if (typeof window === 'undefined' || !window.CacheManager) {
         return;
       }
 
@@ -173,131 +187,217 @@ class VocabularyBuilder {
     };
   }
 
+  /**
+   * ORB detector + TEBLID descriptor pair with its output buffers, created
+   * on first use and reused for every target image until releaseExtractor()
+   * @private
+   */
+  _extractor() {
+    if (!this.extractor) {
+      const teblidSizeConstant = this.teblidParams.size === 512
+        ? cv.TEBLID_SIZE_512_BITS
+        : cv.TEBLID_SIZE_256_BITS;
+
+      this.extractor = {
+        // ORB detector for keypoint detection
+        detector: new cv.ORB(
+          this.orbParams.nfeatures,
+          this.orbParams.scaleFactor,
+          this.orbParams.nlevels,
+          this.orbParams.edgeThreshold,
+          this.orbParams.firstLevel,
+          this.orbParams.WTA_K,
+          this.orbParams.scoreType,
+          this.orbParams.patchSize,
+          this.orbParams.fastThreshold
+        ),
+        // TEBLID descriptor for feature description
+        descriptor: new cv.xfeatures2d_TEBLID(
+          this.teblidParams.scaleFactor,
+          teblidSizeConstant
+        ),
+        keypoints: new cv.KeyPointVector(),
+        descriptors: new cv.Mat()
+      };
+    }
+    return this.extractor;
+  }
+
+  /**
+   * Free the reused detector / descriptor pair
+   */
+  releaseExtractor() {
+    if (!this.extractor) return;
+    for (const object of Object.values(this.extractor)) {
+      object.delete();
+    }
+    this.extractor = null;
+  }
+
   /**
    * Extract features from an image using ORB detector and TEBLID descriptor
    * @param {cv.Mat} imageMat - OpenCV Mat in grayscale
    * @param {string} targetId - Identifier for this target
-   * @returns {Object} Feature data
+   * @returns {Object} Feature data; keypoints are flat [x0, y0, ...]
    */
   extractFeatures(imageMat, targetId) {
-    // ORB detector for keypoint detection
-    const detector = new cv.ORB(
-      this.orbParams.nfeatures,
-      this.orbParams.scaleFactor,
-      this.orbParams.nlevels,
-      this.orbParams.edgeThreshold,
-      this.orbParams.firstLevel,
-      this.orbParams.WTA_K,
-      this.orbParams.scoreType,
-      this.orbParams.patchSize,
-      this.orbParams.fastThreshold
-    );
-
-    // TEBLID descriptor for feature description
-    const teblidSizeConstant = this.teblidParams.size === 512
-      ? cv.TEBLID_SIZE_512_BITS
-      : cv.TEBLID_SIZE_256_BITS;
-    const descriptor = new cv.xfeatures2d_TEBLID(
-      this.teblidParams.scaleFactor,
-      teblidSizeConstant
-    );
-
-    const keypoints = new cv.KeyPointVector();
-    const descriptors = new cv.Mat();
+    const { detector, descriptor, keypoints, descriptors } = this._extractor();
 
     // Detect keypoints with ORB, compute descriptors with TEBLID
     detector.detect(imageMat, keypoints);
     descriptor.compute(imageMat, keypoints, descriptors);
 
-    if (descriptors.rows === 0) {
+    const count = descriptors.rows;
+    if (count === 0) {
       console.warn(`No features found for ${targetId}`);
-      detector.delete();
-      descriptor.delete();
-      keypoints.delete();
-      descriptors.delete();
       return null;
     }
 
-    // Convert to arrays for processing
-    const keypointsArray = [];
-    const responsesArray = [];
-    for (let i = 0; i < keypoints.size(); i++) {
+    // One read per keypoint (compute dropped the ones it could not describe)
+    const points = new Float32Array(count * 2);
+    const responses = new Float32Array(count);
+    for (let i = 0; i < count; i++) {
       const kp = keypoints.get(i);
-      keypointsArray.push({
-        x: kp.pt.x,
-        y: kp.pt.y,
-        response: kp.response
-      });
-      responsesArray.push(kp.response);
+      points[i * 2] = kp.pt.x;
+      points[i * 2 + 1] = kp.pt.y;
+      responses[i] = kp.response;
     }
 
-    // Save descriptor size and image size before we delete anything
+    // Descriptors leave the WASM heap in one copy
     const descriptorSize = descriptors.cols;
+    const descriptorsArray = descriptors.data.slice(0, count * descriptorSize);
     const imageWidth = imageMat.cols;
     const imageHeight = imageMat.rows;
 
-    // Convert descriptors to Uint8Array (copy data before deletion)
-    const totalBytes = descriptors.rows * descriptorSize;
-    const descriptorsArray = new Uint8Array(totalBytes);
-    for (let i = 0; i < totalBytes; i++) {
-      descriptorsArray[i] = descriptors.data[i];
-    }
-
     // Feature selection (keep best distributed features)
     const selected = this._selectBestFeatures(
-      keypointsArray,
+      points,
+      responses,
       descriptorsArray,
       descriptorSize,
       { width: imageWidth, height: imageHeight }
     );
+    const numFeatures = selected.keypoints.length / 2;
 
-    console.log(`  ${targetId}: ${selected.keypoints.length} features`);
-
-    // Clean up OpenCV objects
-    detector.delete();
-    descriptor.delete();
-    keypoints.delete();
-    descriptors.delete();
+    console.log(`  ${targetId}: ${numFeatures} features`);
 
     return {
       id: targetId,
       keypoints: selected.keypoints,
       descriptors: selected.descriptors,
       descriptorSize: descriptorSize,
-      numFeatures: selected.keypoints.length,
+      numFeatures,
       imageSize: { width: imageWidth, height: imageHeight }
     };
   }
 
+  /**
+   * Extract features for every target, one image per pool worker when a
+   * worker pool is available, otherwise serially on this thread
+   * @param {Array} targetData - [{imageMat, targetId}]
+   * @param {Map<string, Object>} known - targetId -> features already extracted
+   * @returns {Promise<Array>} Feature data per target (null when none found)
+   */
+  async _extractAllFeatures(targetData, known = null) {
+    const results = targetData.map(({ targetId }) => (known && known.get(targetId)) || null);
+    const pending = [];
+    results.forEach((features, i) => {
+      if (!features) pending.push(i);
+    });
+    if (pending.length === 0) return results;
+
+    const pool = await this._startWorkerPool();
+    let completed = 0;
+
+    const reportProgress = () => {
+      completed++;
+      this.onProgress({
+        stage: 'extracting',
+        progress: (completed / pending.length) * 100
+      });
+    };
+
+    if (pool) {
+      try {
+        await Promise.all(pending.map(i =>
+          pool.extractFeatures(targetData[i].imageMat, targetData[i].targetId).then(features => {
+            results[i] = features;
+            reportProgress();
+          })
+        ));
+        return results;
+      } catch (error) {
+        console.warn('[VocabularyBuilder] Parallel extraction failed, continuing serially:', error);
+        this._disableWorkerPool();
+        completed = 0;
+      }
+    }
+
+    try {
+      for (const i of pending) {
+        const { imageMat, targetId } = targetData[i];
+        results[i] = this.extractFeatures(imageMat, targetId);
+        reportProgress();
+      }
+    } finally {
+      this.releaseExtractor();
+    }
+    return results;
+  }
+
+  /**
+   * Start the worker pool on first use; falls back to serial on failure
+   * @returns {Promise<VocabularyWorkerPool|null>}
+   */
+  async _startWorkerPool() {
+    if (!this.workerPool) return null;
+
+    try {
+      await this.workerPool.start();
+      return this.workerPool;
+    } catch (error) {
+      console.warn('[VocabularyBuilder] Worker pool unavailable, building serially:', error);
+      this._disableWorkerPool();
+      return null;
+    }
+  }
+
+  _disableWorkerPool() {
+    if (this.workerPool) {
+      this.workerPool.terminate();
+      this.workerPool = null;
+    }
+  }
+
   /**
    * Select best features using spatial distribution + response filtering
    * Mimics BRISK's selectivity by keeping only strong features
+   * @param {Float32Array} points - Flat [x0, y0, ...]
+   * @param {Float32Array} responses - Detector response per keypoint
    */
-  _selectBestFeatures(keypoints, descriptorsFlat, descriptorSize, imageSize) {
-    if (keypoints.length <= this.maxFeaturesPerTarget) {
-      return { keypoints, descriptors: descriptorsFlat };
+  _selectBestFeatures(points, responses, descriptorsFlat, descriptorSize, imageSize) {
+    const count = responses.length;
+    if (count <= this.maxFeaturesPerTarget) {
+      return { keypoints: points, descriptors: descriptorsFlat };
     }
 
     const { width, height } = imageSize;
 
     // STEP 1: Filter by response strength (keep top 60%)
     // This mimics BRISK's selectivity - only strong corners
-    const sortedByResponse = keypoints
-      .map((kp, i) => ({ index: i, response: kp.response, x: kp.x, y: kp.y }))
-      .sort((a, b) => b.response - a.response);
+    const sortedByResponse = Array.from({ length: count }, (_, i) => i)
+      .sort((a, b) => responses[b] - responses[a]);
 
     // Calculate response threshold (60th percentile)
-    const responseThresholdIdx = Math.floor(sortedByResponse.length * 0.4);
-    const responseThreshold = sortedByResponse[responseThresholdIdx]?.response || 0;
-
-    console.log(`  Response filtering: ${sortedByResponse.length} → ${sortedByResponse.filter(f => f.response > responseThreshold).length} features (threshold: ${responseThreshold.toFixed(1)})`);
+    const responseThresholdIdx = Math.floor(count * 0.4);
+    const responseThreshold = responses[sortedByResponse[responseThresholdIdx]] || 0;
 
     // Keep only strong features
-    const strongFeatures = sortedByResponse.filter(f => f.response > responseThreshold);
+    const strongFeatures = sortedByResponse.filter(i => responses[i] > responseThreshold);
 
-    // STEP 2: Spatial distribution on filtered features
-    const indices = strongFeatures;
+    console.log(`  Response filtering: ${count} → ${strongFeatures.length} features (threshold: ${responseThreshold.toFixed(1)})`);
 
+    // STEP 2: Spatial distribution on filtered features
     // Spatial grid for distribution
     const gridSize = 4;
     const cellW = width / gridSize;
@@ -307,17 +407,18 @@ class VocabularyBuilder {
     );
 
     const selected = [];
-    const cellCounts = Array(gridSize).fill(0).map(() => Array(gridSize).fill(0));
+    const taken = new Uint8Array(count);
+    const cellCounts = new Uint32Array(gridSize * gridSize);
 
     // First pass: distribute across grid
-    for (const { index } of indices) {
-      const kp = keypoints[index];
-      const cellX = Math.min(Math.floor(kp.x / cellW), gridSize - 1);
-      const cellY = Math.min(Math.floor(kp.y / cellH), gridSize - 1);
+    for (const index of strongFeatures) {
+      const cellX = Math.min(Math.floor(points[index * 2] / cellW), gridSize - 1);
+      const cellY = Math.min(Math.floor(points[index * 2 + 1] / cellH), gridSize - 1);
 
-      if (cellCounts[cellY][cellX] < featuresPerCell) {
+      if (cellCounts[cellY * gridSize + cellX] < featuresPerCell) {
         selected.push(index);
-        cellCounts[cellY][cellX]++;
+        taken[index] = 1;
+        cellCounts[cellY * gridSize + cellX]++;
 
         if (selected.length >= this.maxFeaturesPerTarget) break;
       }
@@ -325,8 +426,8 @@ class VocabularyBuilder {
 
     // Second pass: fill remaining with strongest
     if (selected.length < this.maxFeaturesPerTarget) {
-      for (const { index } of indices) {
-        if (!selected.includes(index)) {
+      for (const index of strongFeatures) {
+        if (!taken[index]) {
           selected.push(index);
           if (selected.length >= this.maxFeaturesPerTarget) break;
         }
@@ -334,15 +435,17 @@ class VocabularyBuilder {
     }
 
     // Extract selected features
-    const selectedKeypoints = selected.map(i => keypoints[i]);
+    const selectedKeypoints = new Float32Array(selected.length * 2);
     const selectedDescriptors = new Uint8Array(selected.length * descriptorSize);
 
     for (let i = 0; i < selected.length; i++) {
-      const srcOffset = selected[i] * descriptorSize;
-      const dstOffset = i * descriptorSize;
+      const index = selected[i];
+      selectedKeypoints[i * 2] = points[index * 2];
+      selectedKeypoints[i * 2 + 1] = points[index * 2 + 1];
+      const srcOffset = index * descriptorSize;
       selectedDescriptors.set(
-        descriptorsFlat.slice(srcOffset, srcOffset + descriptorSize),
-        dstOffset
+        descriptorsFlat.subarray(srcOffset, srcOffset + descriptorSize),
+        i * descriptorSize
       );
     }
 
@@ -352,6 +455,7 @@ class VocabularyBuilder {
     };
   }
 
+
   /**
    * Build hierarchical vocabulary tree using recursive k-means clustering
    * @param {Array} allDescriptors - Array of descriptor Uint8Arrays
@@ -400,6 +504,7 @@ class VocabularyBuilder {
       descriptorSize,
       0 // Start at level 0
     );
+    this.flatTreeLayout = null;
 
     // Extract flat vocabulary from leaf nodes for backward compatibility
     this.vocabulary = this._extractLeafNodes(this.vocabularyTree);
@@ -750,83 +855,79 @@ class VocabularyBuilder {
       return new Uint8Array(descriptorsFlat.slice(offset, offset + descriptorSize));
     });
 
-    let assignments = new Array(n).fill(0);
+    // Large nodes run the assignment step across the worker pool
+    const minParallel = AppConfig.vocabulary.parallelMinDescriptors || 4000;
+    let dataset = null;
+    if (this.workerPool && n >= minParallel) {
+      try {
+        dataset = await this.workerPool.createDataset(descriptorsFlat, descriptorSize);
+      } catch (error) {
+        console.warn('[VocabularyBuilder] Parallel k-means unavailable:', error);
+      }
+    }
+
+    let assignments = dataset ? dataset.assignments : new Int32Array(n);
     let changed = true;
     let iteration = 0;
     let prevChangedCount = n;
     const earlyStopThreshold = Math.max(1, Math.floor(n * 0.001)); // 0.1% change threshold
 
-    while (changed && iteration < maxIterations) {
-      iteration++;
-      let changedCount = 0;
-
-      // Assignment step: assign each descriptor to nearest center using Hamming distance
-      for (let i = 0; i < n; i++) {
-        const descOffset = i * descriptorSize;
-        const descriptor = descriptorsFlat.slice(descOffset, descOffset + descriptorSize);
-
-        let minDist = Infinity;
-        let bestCluster = 0;
-
-        for (let j = 0; j < k; j++) {
-          const dist = this._hammingDistance(descriptor, centers[j]);
-          if (dist < minDist) {
-            minDist = dist;
-            bestCluster = j;
+    try {
+      while (changed && iteration < maxIterations) {
+        iteration++;
+
+        // Assignment step: assign each descriptor to nearest center using Hamming distance
+        const centersFlat = VocabularyBuilder._packCenters(centers, descriptorSize);
+        let changedCount;
+        if (dataset) {
+          try {
+            changedCount = await this.workerPool.assign(dataset, centersFlat);
+          } catch (error) {
+            console.warn('[VocabularyBuilder] Parallel assignment failed, continuing serially:', error);
+            this.workerPool.releaseDataset(dataset);
+            assignments = Int32Array.from(dataset.assignments);
+            dataset = null;
+            this._disableWorkerPool();
           }
         }
-
-        if (assignments[i] !== bestCluster) {
-          assignments[i] = bestCluster;
-          changedCount++;
+        if (!dataset) {
+          changedCount = VocabularyBuilder.assignRange(
+            descriptorsFlat, descriptorSize, centersFlat, k, assignments, 0, n
+          );
         }
-      }
 
-      // Early termination: stop if very few points changed
-      if (changedCount < earlyStopThreshold) {
-        console.log(`  Binary k-means early stop: only ${changedCount} points changed`);
-        changed = false;
-        break;
-      }
+        // Early termination: stop if very few points changed
+        if (changedCount < earlyStopThreshold) {
+          console.log(`  Binary k-means early stop: only ${changedCount} points changed`);
+          changed = false;
+          break;
+        }
 
-      // Check if we're making progress (diminishing returns)
-      if (changedCount >= prevChangedCount * 0.95 && iteration > 5) {
-        console.log(`  Binary k-means early stop: minimal progress (${changedCount} changes)`);
-        changed = false;
-        break;
-      }
+        // Check if we're making progress (diminishing returns)
+        if (changedCount >= prevChangedCount * 0.95 && iteration > 5) {
+          console.log(`  Binary k-means early stop: minimal progress (${changedCount} changes)`);
+          changed = false;
+          break;
+        }
 
-      prevChangedCount = changedCount;
+        prevChangedCount = changedCount;
 
-      // Update step: recalculate centers using median voting (optimal for binary)
-      for (let j = 0; j < k; j++) {
-        // Collect all descriptors in this cluster
-        const clusterDescriptors = [];
-        for (let i = 0; i < n; i++) {
-          if (assignments[i] === j) {
-            const descOffset = i * descriptorSize;
-            clusterDescriptors.push(
-              descriptorsFlat.slice(descOffset, descOffset + descriptorSize)
-            );
-          }
-        }
+        // Update step: recalculate centers using median voting (optimal for binary)
+        centers = this._updateCentersMedian(descriptorsFlat, descriptorSize, assignments, centers);
 
-        // Skip empty clusters
-        if (clusterDescriptors.length === 0) {
-          continue;
+        // Progress update
+        if (iteration % 3 === 0) {
+          this.onProgress({
+            stage: 'clustering',
+            progress: Math.min(95, (iteration / maxIterations) * 100)
+          });
+          await this._sleep(0); // Allow UI updates
         }
-
-        // Compute new center using median voting (bit-wise majority)
-        centers[j] = this._medianVotingCenter(clusterDescriptors, descriptorSize);
       }
-
-      // Progress update
-      if (iteration % 3 === 0) {
-        this.onProgress({
-          stage: 'clustering',
-          progress: Math.min(95, (iteration / maxIterations) * 100)
-        });
-        await this._sleep(0); // Allow UI updates
+    } finally {
+      if (dataset) {
+        assignments = Int32Array.from(dataset.assignments);
+        this.workerPool.releaseDataset(dataset);
       }
     }
 
@@ -842,6 +943,119 @@ class VocabularyBuilder {
     return { centers, assignments, metrics };
   }
 
+  /**
+   * Pack k centers into one contiguous buffer for the assignment step
+   * @param {Array<Uint8Array>} centers
+   * @param {number} descriptorSize
+   * @returns {Uint8Array}
+   */
+  static _packCenters(centers, descriptorSize) {
+    const flat = new Uint8Array(centers.length * descriptorSize);
+    for (let j = 0; j < centers.length; j++) {
+      flat.set(centers[j], j * descriptorSize);
+    }
+    return flat;
+  }
+
+  /**
+   * Assign descriptors [start, end) to their nearest center (Hamming).
+   * Shared by the serial path and VocabularyWorker, which runs it on its
+   * slice of a shared descriptor buffer.
+   * @param {Uint8Array} descriptorsFlat - All descriptors of the node
+   * @param {number} descriptorSize - Bytes per descriptor
+   * @param {Uint8Array} centersFlat - k packed centers
+   * @param {number} k - Number of centers
+   * @param {Int32Array} assignments - Updated in place
+   * @param {number} start - First descriptor
+   * @param {number} end - One past the last descriptor
+   * @returns {number} Number of changed assignments
+   */
+  static assignRange(descriptorsFlat, descriptorSize, centersFlat, k, assignments, start, end) {
+    // 32-bit words when aligned (the common 32/64-byte case), bytes otherwise
+    const aligned = descriptorSize % 4 === 0 && descriptorsFlat.byteOffset % 4 === 0;
+    const unit = aligned ? 4 : 1;
+    const data = aligned
+      ? new Int32Array(descriptorsFlat.buffer, descriptorsFlat.byteOffset, descriptorsFlat.length / 4)
+      : descriptorsFlat;
+    const centers = aligned ? new Int32Array(centersFlat.buffer, centersFlat.byteOffset, centersFlat.length / 4) : centersFlat;
+    const stride = descriptorSize / unit;
+
+    let changedCount = 0;
+    for (let i = start; i < end; i++) {
+      const base = i * stride;
+      let minDist = 0x7fffffff;
+      let bestCluster = 0;
+
+      for (let j = 0; j < k; j++) {
+        const centerBase = j * stride;
+        let dist = 0;
+        for (let w = 0; w < stride; w++) {
+          let x = data[base + w] ^ centers[centerBase + w];
+          x = (x - ((x >> 1) & 0x55555555)) | 0;
+          x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+          dist += Math.imul((x + (x >> 4)) & 0x0F0F0F0F, 0x01010101) >>> 24;
+        }
+        if (dist < minDist) {
+          minDist = dist;
+          bestCluster = j;
+        }
+      }
+
+      if (assignments[i] !== bestCluster) {
+        assignments[i] = bestCluster;
+        changedCount++;
+      }
+    }
+    return changedCount;
+  }
+
+  /**
+   * Median-voting update for all clusters in one pass over the descriptors
+   * (same result as _medianVotingCenter per cluster; empty clusters keep
+   * their previous center)
+   * @returns {Array<Uint8Array>} New centers
+   */
+  _updateCentersMedian(descriptorsFlat, descriptorSize, assignments, centers) {
+    const k = centers.length;
+    const bits = descriptorSize * 8;
+    const ones = new Int32Array(k * bits);
+    const counts = new Int32Array(k);
+    const n = descriptorsFlat.length / descriptorSize;
+
+    for (let i = 0; i < n; i++) {
+      const cluster = assignments[i];
+      counts[cluster]++;
+      const base = cluster * bits;
+      const offset = i * descriptorSize;
+      for (let byteIdx = 0; byteIdx < descriptorSize; byteIdx++) {
+        const byte = descriptorsFlat[offset + byteIdx];
+        if (byte === 0) continue;
+        const bitBase = base + byteIdx * 8;
+        for (let bit = 0; bit < 8; bit++) {
+          if (byte & (1 << (7 - bit))) ones[bitBase + bit]++;
+        }
+      }
+    }
+
+    return centers.map((center, j) => {
+      if (counts[j] === 0) return center;
+
+      const newCenter = new Uint8Array(descriptorSize);
+      const half = counts[j] / 2;
+      const base = j * bits;
+      for (let byteIdx = 0; byteIdx < descriptorSize; byteIdx++) {
+        let byte = 0;
+        for (let bit = 0; bit < 8; bit++) {
+          if (ones[base + byteIdx * 8 + bit] > half) {
+            byte |= (1 << (7 - bit));
+          }
+        }
+        newCenter[byteIdx] = byte;
+      }
+      return newCenter;
+    });
+  }
+
   /**
    * Compute cluster center using median voting (bit-wise majority)
    * For each bit position, set to 1 if majority of descriptors have it set
@@ -889,7 +1103,7 @@ class VocabularyBuilder {
    * @param {Array<number>} assignments - Cluster assignments
    * @returns {Object} Quality metrics
    */
-  _computeClusterQuality(descriptorsFlat, descriptorSize, centers, assignments) {
+  _computeClusterQuality(descriptorsFlat, descriptorSize, centers, assignments, includeInter = true) {
     const n = descriptorsFlat.length / descriptorSize;
     const k = centers.length;
 
@@ -912,7 +1126,8 @@ class VocabularyBuilder {
     let interClusterSum = 0;
     let interClusterCount = 0;
 
-    for (let i = 0; i < k; i++) {
+    // O(k^2) - skipped when only the intra term is needed (drift checks)
+    for (let i = 0; includeInter && i < k; i++) {
       for (let j = i + 1; j < k; j++) {
         const dist = this._hammingDistance(centers[i], centers[j]);
         interClusterSum += dist;
@@ -1168,6 +1383,62 @@ class VocabularyBuilder {
     return bm25;
   }
 
+  /**
+   * Build the inverted file: for each word, the targets containing it and
+   * their weight, stored CSR-style (word_offsets indexes the posting arrays)
+   * @param {Array} targets - Targets with id and bow_tfidf
+   * @returns {Object} Serializable inverted index
+   */
+  buildInvertedIndex(targets) {
+    const wordCount = this.vocabularySize;
+    const counts = new Int32Array(wordCount + 1);
+    const targetNorms = new Array(targets.length).fill(0);
+
+    for (let t = 0; t < targets.length; t++) {
+      for (const wordIdStr in targets[t].bow_tfidf) {
+        const wordId = parseInt(wordIdStr);
+        if (wordId >= 0 && wordId < wordCount) counts[wordId + 1]++;
+      }
+    }
+
+    const wordOffsets = new Array(wordCount + 1);
+    wordOffsets[0] = 0;
+    for (let w = 0; w < wordCount; w++) {
+      wordOffsets[w + 1] = wordOffsets[w] + counts[w + 1];
+    }
+
+    const numPostings = wordOffsets[wordCount];
+    const postingTargets = new Array(numPostings);
+    const postingWeights = new Array(numPostings);
+    const cursor = wordOffsets.slice(0, wordCount);
+
+    for (let t = 0; t < targets.length; t++) {
+      const vector = targets[t].bow_tfidf;
+      let norm = 0;
+      for (const wordIdStr in vector) {
+        const weight = vector[wordIdStr];
+        norm += weight * weight;
+
+        const wordId = parseInt(wordIdStr);
+        if (wordId < 0 || wordId >= wordCount) continue;
+        const slot = cursor[wordId]++;
+        postingTargets[slot] = t;
+        postingWeights[slot] = weight;
+      }
+      targetNorms[t] = Math.sqrt(norm);
+    }
+
+    console.log(`Inverted index: ${numPostings} postings over ${wordCount} words`);
+
+    return {
+      target_ids: targets.map(target => target.id),
+      target_norms: targetNorms,
+      word_offsets: wordOffsets,
+      posting_targets: postingTargets,
+      posting_weights: postingWeights
+    };
+  }
+
   /**
    * Process all targets and build complete database
    * Checks cache first, builds if not cached
@@ -1176,7 +1447,7 @@ class VocabularyBuilder {
     console.log(`Processing ${targetData.length} targets...`);
 
     // Ensure cache manager is initialized
-    if (!this.cacheManager && window.CacheManager) {
+    if (!this.cacheManager && typeof window !== 'undefined' && window.CacheManager) {
       await this.initCacheManager();
     }
 
@@ -1185,13 +1456,33 @@ class VocabularyBuilder {
       this.onProgress({ stage: 'cache', progress: 0, message: 'Checking cache...' });
 
       try {
+        const warmStart = performance.now();
         const cachedData = await this.cacheManager.getVocabulary(this.albumCode);
         if (cachedData) {
           console.log('[VocabularyBuilder] Found cached vocabulary, checking version...');
           const importSuccess = this.importDatabase(cachedData);
+          const changes = importSuccess ? this._diffTargets(targetData) : null;
+          const changed = changes && (changes.added.length > 0 || changes.removed.length > 0);
+
+          if (changed) {
+            console.log(`[VocabularyBuilder] Album changed: +${changes.added.length}` +
+              ` -${changes.removed.length} targets`);
+          }
 
-          if (importSuccess) {
-            console.log('[VocabularyBuilder] Loaded from cache successfully');
+          if (changed && AppConfig.vocabulary.incremental &&
+              await this.updateTargets(changes.added, changes.removed)) {
+            await this._storeInCache();
+            return this.targets;
+          }
+
+          if (importSuccess && !changed) {
+            const elapsed = performance.now() - warmStart;
+            const target = AppConfig.database.warmStartTargetMs;
+            console.log(`[VocabularyBuilder] Loaded from cache successfully in ${elapsed.toFixed(1)}ms` +
+              ` (target ${target}ms)`);
+            if (elapsed > target) {
+              console.warn('[VocabularyBuilder] Warm start exceeded its target');
+            }
             this.onProgress({
               stage: 'cache',
               progress: 100,
@@ -1199,7 +1490,7 @@ class VocabularyBuilder {
               cached: true
             });
             return this.targets;
-          } else {
+          } else if (!importSuccess) {
             console.log('[VocabularyBuilder] Version mismatch - clearing cache and rebuilding');
             // Clear incompatible cache
             await this.cacheManager.deleteVocabulary(this.albumCode);
@@ -1220,17 +1511,13 @@ class VocabularyBuilder {
     const targetFeatures = [];
     let descriptorSize = null;
 
-    for (let i = 0; i < targetData.length; i++) {
-      const { imageMat, targetId } = targetData[i];
-
-      this.onProgress({
-        stage: 'extracting',
-        progress: ((i + 1) / targetData.length) * 100
-      });
-
-      const features = this.extractFeatures(imageMat, targetId);
+    const extracted = await this._extractAllFeatures(targetData, this.pendingFeatures);
+    this.pendingFeatures = null;
+    for (let i = 0; i < extracted.length; i++) {
+      const features = extracted[i];
       if (!features) continue;
 
+      features.fingerprint = VocabularyBuilder.fingerprintImage(targetData[i].imageMat);
       descriptorSize = features.descriptorSize;
       targetFeatures.push(features);
       allDescriptors.push(features.descriptors);
@@ -1258,12 +1545,9 @@ class VocabularyBuilder {
     this.onProgress({ stage: 'bow', progress: 0 });
     console.log('Converting to Bag-of-Words...');
 
-    const targetBoWVectors = [];
     for (let i = 0; i < targetFeatures.length; i++) {
       const target = targetFeatures[i];
-      const bow = this.descriptorsToBoW(target.descriptors, descriptorSize);
-      target.bow = bow;
-      targetBoWVectors.push(bow);
+      target.bow = this.descriptorsToBoW(target.descriptors, descriptorSize);
 
       this.onProgress({
         stage: 'bow',
@@ -1271,12 +1555,32 @@ class VocabularyBuilder {
       });
     }
 
-    // Step 4: Compute IDF
+    this.targets = targetFeatures;
+
+    // Steps 5-6: IDF, BM25 / TF-IDF vectors and the inverted file
+    this._computeWeights(targetFeatures);
+
+    // Drift reference for later incremental updates
+    this.quantizationBaseline = this._measureQuantizationDistance(allDescriptors, descriptorSize);
+    this.incrementalTargets = 0;
+
+    // Cache the built vocabulary tree
+    await this._storeInCache();
+
+    return targetFeatures;
+  }
+
+  /**
+   * IDF, per-target weighted vectors and the inverted file for a target set
+   * @param {Array<Object>} targetFeatures - Targets with bow and numFeatures
+   */
+  _computeWeights(targetFeatures) {
+    // Compute IDF
     this.onProgress({ stage: 'idf', progress: 0 });
-    this.computeIDF(targetBoWVectors);
+    this.computeIDF(targetFeatures.map(target => target.bow));
     this.onProgress({ stage: 'idf', progress: 100 });
 
-    // Step 5: Choose weighting scheme (TF-IDF or BM25)
+    // Choose weighting scheme (TF-IDF or BM25)
     const weightingScheme = AppConfig.vocabulary?.weightingScheme || 'bm25';
     console.log(`Computing ${weightingScheme.toUpperCase()} vectors...`);
 
@@ -1307,29 +1611,195 @@ class VocabularyBuilder {
     console.log(`  Weighting scheme: ${weightingScheme.toUpperCase()}`);
     console.log(`  Average document length: ${avgDocLength.toFixed(1)} features`);
 
-    this.targets = targetFeatures;
+    // Inverted file so queries only touch targets sharing words
+    this.invertedIndex = this.buildInvertedIndex(targetFeatures);
+  }
 
-    // Cache the built vocabulary tree
-    if (this.cacheManager && this.albumCode) {
-      this.onProgress({ stage: 'caching', progress: 0, message: 'Saving to cache...' });
+  /**
+   * Write the current database to the vocabulary cache (if available)
+   */
+  async _storeInCache() {
+    if (!this.cacheManager || !this.albumCode) return;
 
-      try {
-        const database = this.exportDatabase();
-        await this.cacheManager.storeVocabulary(this.albumCode, database);
-        console.log('[VocabularyBuilder] Vocabulary tree cached');
-        this.onProgress({ stage: 'caching', progress: 100 });
-      } catch (error) {
-        console.error('[VocabularyBuilder] Failed to cache vocabulary:', error);
+    this.onProgress({ stage: 'caching', progress: 0, message: 'Saving to cache...' });
+
+    try {
+      const database = this.exportDatabase();
+      await this.cacheManager.storeVocabulary(this.albumCode, database);
+      console.log('[VocabularyBuilder] Vocabulary tree cached');
+      this.onProgress({ stage: 'caching', progress: 100 });
+    } catch (error) {
+      console.error('[VocabularyBuilder] Failed to cache vocabulary:', error);
+    }
+  }
+
+  /**
+   * Compare the imported targets with the album being loaded
+   * @param {Array<{imageMat, targetId}>} targetData
+   * @returns {{added: Array, removed: Array<string>}} Changed images count
+   *   as removed + added
+   */
+  _diffTargets(targetData) {
+    const cached = new Map(this.targets.map(target => [target.id, target]));
+    const seen = new Set();
+    const added = [];
+    const removed = [];
+
+    for (const data of targetData) {
+      seen.add(data.targetId);
+      const target = cached.get(data.targetId);
+      const fingerprint = VocabularyBuilder.fingerprintImage(data.imageMat);
+
+      if (!target) {
+        added.push(data);
+      } else if (target.fingerprint && target.fingerprint !== fingerprint) {
+        removed.push(target.id);
+        added.push(data);
       }
     }
 
-    return targetFeatures;
+    for (const target of this.targets) {
+      if (!seen.has(target.id)) removed.push(target.id);
+    }
+
+    return { added, removed };
+  }
+
+  /**
+   * Incremental update: quantize new targets into the existing tree, then
+   * refresh IDF / BM25 and the inverted file. The tree is kept unless the
+   * new descriptors fit it noticeably worse than the ones it was built from
+   * (AppConfig.vocabulary.driftThreshold) or too much of the album was
+   * added incrementally (AppConfig.vocabulary.maxIncrementalFraction).
+   * @param {Array<{imageMat, targetId}>} addedData - New or changed targets
+   * @param {Array<string>} removedIds - Targets to drop
+   * @returns {Promise<boolean>} False when a full rebuild is needed instead
+   */
+  async updateTargets(addedData, removedIds) {
+    if (!this.vocabularyTree || this.targets.length === 0) return false;
+
+    const descriptorSize = this.targets[0].descriptorSize;
+    const removed = new Set(removedIds);
+    const kept = this.targets.filter(target => !removed.has(target.id));
+
+    // Decided before extracting, so a rebuild does not extract twice. Targets
+    // without features only lower the fraction, so the check stays valid
+    const total = kept.length + addedData.length;
+    if (total === 0 ||
+        (this.incrementalTargets + addedData.length) / total > AppConfig.vocabulary.maxIncrementalFraction) {
+      console.log(`[VocabularyBuilder] ${this.incrementalTargets + addedData.length}/${total}` +
+        ' targets added incrementally - re-clustering');
+      return false;
+    }
+
+    this.onProgress({ stage: 'extracting', progress: 0 });
+    const extracted = addedData.length > 0 ? await this._extractAllFeatures(addedData) : [];
+    const added = [];
+    extracted.forEach((features, i) => {
+      if (!features) return;
+      features.fingerprint = VocabularyBuilder.fingerprintImage(addedData[i].imageMat);
+      added.push(features);
+    });
+
+    // Past this point a rejected update hands its features to the rebuild
+    this.pendingFeatures = new Map(added.map(features => [features.id, features]));
+
+    if (added.some(features => features.descriptorSize !== descriptorSize)) {
+      return false;
+    }
+
+    const incrementalTargets = this.incrementalTargets + added.length;
+
+    if (added.length > 0 && this.quantizationBaseline > 0) {
+      const distance = this._measureQuantizationDistance(added.map(t => t.descriptors), descriptorSize);
+      const drift = distance / this.quantizationBaseline;
+      console.log(`[VocabularyBuilder] Quantization drift ${drift.toFixed(3)}` +
+        ` (${distance.toFixed(2)} vs ${this.quantizationBaseline.toFixed(2)} bits)`);
+      if (drift > AppConfig.vocabulary.driftThreshold) {
+        console.log('[VocabularyBuilder] Drift above threshold - re-clustering');
+        return false;
+      }
+    }
+
+    this.onProgress({ stage: 'bow', progress: 0 });
+    for (const target of added) {
+      target.bow = this.descriptorsToBoW(target.descriptors, descriptorSize);
+    }
+    this.onProgress({ stage: 'bow', progress: 100 });
+
+    this.pendingFeatures = null;
+    this.targets = kept.concat(added);
+    this.incrementalTargets = incrementalTargets;
+    this._computeWeights(this.targets);
+
+    console.log(`[VocabularyBuilder] Incremental update: ${this.targets.length} targets` +
+      ` (+${added.length} -${removedIds.length})`);
+    return true;
   }
 
   /**
-   * Export database in JSON format (includes hierarchical tree)
+   * Mean Hamming distance from descriptors to their vocabulary word - the
+   * intra-cluster term of _computeClusterQuality over the leaf words
+   * @param {Array<Uint8Array>} descriptorSets - Flat descriptors per target
+   * @param {number} descriptorSize
+   * @returns {number}
+   */
+  _measureQuantizationDistance(descriptorSets, descriptorSize) {
+    const total = descriptorSets.reduce((sum, set) => sum + set.length / descriptorSize, 0);
+    const sampleSize = Math.min(total, AppConfig.vocabulary.driftSampleSize);
+    if (sampleSize === 0) return 0;
+
+    // Evenly strided sample across all targets
+    const step = total / sampleSize;
+    const sample = new Uint8Array(sampleSize * descriptorSize);
+    const assignments = new Int32Array(sampleSize);
+    let setIndex = 0;
+    let setStart = 0;
+
+    for (let i = 0; i < sampleSize; i++) {
+      const global = Math.floor(i * step);
+      while (global >= setStart + descriptorSets[setIndex].length / descriptorSize) {
+        setStart += descriptorSets[setIndex].length / descriptorSize;
+        setIndex++;
+      }
+      const offset = (global - setStart) * descriptorSize;
+      const descriptor = descriptorSets[setIndex].subarray(offset, offset + descriptorSize);
+      sample.set(descriptor, i * descriptorSize);
+      assignments[i] = this.quantizeDescriptor(descriptor);
+    }
+
+    return this._computeClusterQuality(sample, descriptorSize, this.vocabulary, assignments, false).intraCluster;
+  }
+
+  /**
+   * Cheap content hash of a target image (size + strided pixel sample), used
+   * to notice a photo replaced under the same name
+   * @param {cv.Mat} imageMat
+   * @returns {string}
+   */
+  static fingerprintImage(imageMat) {
+    const data = imageMat.data;
+    const step = Math.max(1, Math.floor(data.length / 4096));
+    let hash = 0x811c9dc5;
+
+    hash = Math.imul(hash ^ imageMat.rows, 0x01000193);
+    hash = Math.imul(hash ^ imageMat.cols, 0x01000193);
+    for (let i = 0; i < data.length; i += step) {
+      hash = Math.imul(hash ^ data[i], 0x01000193);
+    }
+    return (hash >>> 0).toString(16);
+  }
+
+  /**
+   * Export database (structured-clone friendly, see VocabularyCodec)
+   * Descriptors are flat Uint8Arrays, keypoints flat Float32Arrays
+   * [x0, y0, x1, y1, ...] and the tree is a FlatVocabularyTree layout.
    */
   exportDatabase() {
+    if (!this.flatTreeLayout && this.vocabularyTree) {
+      this.flatTreeLayout = FlatVocabularyTree.flatten(this.vocabularyTree);
+    }
+
     const database = {
       metadata: {
         num_targets: this.targets.length,
@@ -1339,29 +1809,30 @@ class VocabularyBuilder {
         descriptor_type: 'TEBLID',
         descriptor_bytes: this.targets[0]?.descriptorSize || 64,
         has_hierarchical_tree: this.vocabularyTree !== null,
+        quantization_distance: this.quantizationBaseline,
+        incremental_targets: this.incrementalTargets,
         // Database versioning
         database_version: AppConfig.database.version,
         config_signature: AppConfig.database.getConfigSignature(),
         created_at: new Date().toISOString()
       },
       vocabulary: {
-        words: this.vocabulary.map(word => Array.from(word)),
+        words: this.vocabulary,
         idf_weights: this.idfWeights,
-        tree: this.vocabularyTree ? this._serializeTree(this.vocabularyTree) : null
+        flat_tree: this.flatTreeLayout,
+        inverted_index: this.invertedIndex
       },
       targets: this.targets.map(target => ({
         id: target.id,
         filename: target.id, // Will be set by ZipDatabaseLoader
         num_features: target.numFeatures,
-        keypoints: target.keypoints.map(kp => [kp.x, kp.y]),
-        descriptors: Array.from(target.descriptors).reduce((acc, val, i) => {
-          const idx = Math.floor(i / target.descriptorSize);
-          if (!acc[idx]) acc[idx] = [];
-          acc[idx].push(val);
-          return acc;
-        }, []),
+        num_descriptors: target.descriptors.length / target.descriptorSize,
+        keypoints: target.keypoints, // Flat [x0, y0, ...] since extraction
+        descriptors: target.descriptors,
         bow: target.bow,
         bow_tfidf: target.bow_tfidf,
+        weighting_scheme: target.weighting_scheme,
+        fingerprint: target.fingerprint || null,
         image_meta: {
           width: target.imageSize.width,
           height: target.imageSize.height,
@@ -1374,21 +1845,7 @@ class VocabularyBuilder {
   }
 
   /**
-   * Serialize tree structure for export
-   * @param {Object} node - Tree node
-   * @returns {Object} Serialized node
-   */
-  _serializeTree(node) {
-    return {
-      level: node.level,
-      isLeaf: node.isLeaf,
-      centers: node.centers.map(c => Array.from(c)),
-      children: node.children ? node.children.map(c => this._serializeTree(c)) : null
-    };
-  }
-
-  /**
-   * Import database from cached data
+   * Import database from cached data (VocabularyCodec.decode output)
    * Restores vocabulary tree and targets
    * @returns {boolean} True if import successful, false if version mismatch
    */
@@ -1430,16 +1887,17 @@ class VocabularyBuilder {
     this.k = database.metadata.branching_factor;
     this.levels = database.metadata.levels;
     this.vocabularySize = database.metadata.vocabulary_size;
+    this.quantizationBaseline = database.metadata.quantization_distance || null;
+    this.incrementalTargets = database.metadata.incremental_targets || 0;
 
-    // Restore vocabulary (convert arrays back to Uint8Arrays)
-    this.vocabulary = database.vocabulary.words.map(word =>
-      new Uint8Array(word)
-    );
+    // Restore vocabulary (views into the decoded cache buffer)
+    this.vocabulary = database.vocabulary.words;
     this.idfWeights = database.vocabulary.idf_weights;
 
     // Restore hierarchical tree if available
-    if (database.vocabulary.tree) {
-      this.vocabularyTree = this._deserializeTree(database.vocabulary.tree);
+    this.flatTreeLayout = database.vocabulary.flat_tree || null;
+    if (this.flatTreeLayout) {
+      this.vocabularyTree = FlatVocabularyTree.toTree(this.flatTreeLayout);
       console.log('[VocabularyBuilder] Hierarchical tree restored');
     } else {
       this.vocabularyTree = null;
@@ -1448,24 +1906,16 @@ class VocabularyBuilder {
 
     // Restore targets
     this.targets = database.targets.map(target => {
-      const descriptorSize = database.metadata.descriptor_bytes;
-
-      // Convert descriptors back to flat Uint8Array
-      const descriptorsFlat = new Uint8Array(
-        target.descriptors.length * descriptorSize
-      );
-      target.descriptors.forEach((desc, i) => {
-        descriptorsFlat.set(desc, i * descriptorSize);
-      });
-
       return {
         id: target.id,
         numFeatures: target.num_features,
-        keypoints: target.keypoints.map(kp => ({ x: kp[0], y: kp[1] })),
-        descriptors: descriptorsFlat,
-        descriptorSize: descriptorSize,
+        keypoints: target.keypoints,
+        descriptors: target.descriptors,
+        descriptorSize: database.metadata.descriptor_bytes,
         bow: target.bow,
         bow_tfidf: target.bow_tfidf,
+        weighting_scheme: target.weighting_scheme,
+        fingerprint: target.fingerprint || null,
         imageSize: {
           width: target.image_meta.width,
           height: target.image_meta.height
@@ -1473,24 +1923,14 @@ class VocabularyBuilder {
       };
     });
 
+    // Caches written before the inverted index existed are indexed here
+    this.invertedIndex = database.vocabulary.inverted_index ||
+      this.buildInvertedIndex(this.targets);
+
     console.log(`[VocabularyBuilder] Imported ${this.targets.length} targets`);
     return true;
   }
 
-  /**
-   * Deserialize tree structure from import
-   * @param {Object} serialized - Serialized node
-   * @returns {Object} Tree node
-   */
-  _deserializeTree(serialized) {
-    return {
-      level: serialized.level,
-      isLeaf: serialized.isLeaf,
-      centers: serialized.centers.map(c => new Uint8Array(c)),
-      children: serialized.children ? serialized.children.map(c => this._deserializeTree(c)) : null
-    };
-  }
-
   _sleep(ms) {
     return new Promise(resolve => setTimeout(resolve, ms));
   }
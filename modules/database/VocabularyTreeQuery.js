@@ -3,12 +3,19 @@
  * Uses Bag-of-Words (BoW) and TF-IDF scoring to select likely targets
  */
 class VocabularyTreeQuery {
-  constructor(vocabulary, idf, vocabularyTree = null) {
+  constructor(vocabulary, idf, vocabularyTree = null, invertedIndex = null) {
     this.vocabulary = vocabulary; // Array of visual word descriptors
     this.idf = idf; // Inverse document frequency weights
     this.vocabularySize = vocabulary.length;
     this.vocabularyTree = vocabularyTree; // Optional hierarchical tree for fast lookup
 
+    // Tree packed into typed arrays for quantization; wordIds is reused per query
+    this.flatTree = vocabularyTree ? FlatVocabularyTree.fromTree(vocabularyTree) : null;
+    this.wordIds = null;
+
+    // Optional inverted file (VocabularyBuilder.buildInvertedIndex) for scoring
+    this.invertedIndex = invertedIndex ? this.loadInvertedIndex(invertedIndex) : null;
+
     // Convert vocabulary to OpenCV Mat for fast matching (fallback if no tree)
     this.vocabularyMat = this.createVocabularyMat(vocabulary);
 
@@ -18,6 +25,51 @@ class VocabularyTreeQuery {
 
     console.log(`[VocabularyTreeQuery] Initialized with ${this.vocabularySize} words`);
     console.log(`[VocabularyTreeQuery] Hierarchical tree: ${vocabularyTree ? 'ENABLED (fast)' : 'DISABLED (slow)'}`);
+    console.log(`[VocabularyTreeQuery] Inverted index: ${this.invertedIndex ? 'ENABLED' : 'DISABLED'}`);
+  }
+
+  /**
+   * Convert the exported inverted index to typed arrays
+   * @param {Object} index - {target_ids, target_norms, word_offsets, posting_targets, posting_weights}
+   * @returns {Object} Runtime index
+   */
+  loadInvertedIndex(index) {
+    const numTargets = index.target_ids.length;
+    return {
+      targetIds: index.target_ids,
+      targetNorms: Float64Array.from(index.target_norms),
+      wordOffsets: Int32Array.from(index.word_offsets),
+      postingTargets: Int32Array.from(index.posting_targets),
+      postingWeights: Float64Array.from(index.posting_weights),
+      wordCount: index.word_offsets.length - 1,
+      // Score accumulators, reused across queries
+      dots: new Float64Array(numTargets),
+      stamps: new Uint32Array(numTargets),
+      touched: new Int32Array(numTargets),
+      epoch: 0,
+      // Index target -> position in the caller's target list (-1 = absent),
+      // rebuilt only when that list changes
+      positions: new Int32Array(numTargets).fill(-1),
+      positionsLength: -1
+    };
+  }
+
+  /**
+   * Rebuild the index -> runtime target position table
+   * @private
+   * @param {Array} targets - Runtime targets with id
+   */
+  _mapTargetPositions(targets) {
+    const index = this.invertedIndex;
+    const byId = new Map();
+    for (let i = 0; i < targets.length; i++) {
+      byId.set(targets[i].id, i);
+    }
+    for (let t = 0; t < index.targetIds.length; t++) {
+      const position = byId.get(index.targetIds[t]);
+      index.positions[t] = position === undefined ? -1 : position;
+    }
+    index.positionsLength = targets.length;
   }
 
   /**
@@ -53,7 +105,7 @@ class VocabularyTreeQuery {
     }
 
     // Use hierarchical quantization if tree is available (FAST)
-    if (this.vocabularyTree) {
+    if (this.flatTree) {
       return this._computeBoWHierarchical(descriptors);
     }
 
@@ -63,23 +115,20 @@ class VocabularyTreeQuery {
 
   /**
    * Hierarchical BoW computation using tree traversal (FAST: O(k*L) per descriptor)
+   * Quantizes straight from the Mat's data buffer via the flat tree
    * @param {cv.Mat} descriptors - Frame descriptors
    * @returns {Object} BoW vector as {wordId: count}
    */
   _computeBoWHierarchical(descriptors) {
     const bow = {};
-    const descriptorSize = descriptors.cols;
 
-    // Quantize each descriptor using tree traversal
-    for (let i = 0; i < descriptors.rows; i++) {
-      // Extract descriptor as Uint8Array
-      const descriptor = new Uint8Array(descriptorSize);
-      for (let j = 0; j < descriptorSize; j++) {
-        descriptor[j] = descriptors.ucharAt(i, j);
-      }
+    if (!this.wordIds || this.wordIds.length < descriptors.rows) {
+      this.wordIds = new Int32Array(descriptors.rows);
+    }
+    const wordIds = this.flatTree.quantizeMat(descriptors, this.wordIds);
 
-      // Quantize using hierarchical tree
-      const wordId = this._quantizeDescriptorHierarchical(descriptor, this.vocabularyTree, 0);
+    for (let i = 0; i < descriptors.rows; i++) {
+      const wordId = wordIds[i];
       bow[wordId] = (bow[wordId] || 0) + 1;
     }
 
@@ -114,104 +163,6 @@ class VocabularyTreeQuery {
     return bow;
   }
 
-  /**
-   * Hierarchical quantization - traverse tree from root to leaf
-   * Same implementation as in VocabularyBuilder for consistency
-   * @param {Uint8Array} descriptor - Binary descriptor
-   * @param {Object} node - Current tree node
-   * @param {number} wordOffset - Offset for word ID calculation
-   * @returns {number} Word ID
-   */
-  _quantizeDescriptorHierarchical(descriptor, node, wordOffset) {
-    // If leaf node, find best matching word among leaf centers
-    if (node.isLeaf) {
-      let minDist = Infinity;
-      let bestLocalIdx = 0;
-
-      for (let i = 0; i < node.centers.length; i++) {
-        const dist = this._hammingDistance(descriptor, node.centers[i]);
-        if (dist < minDist) {
-          minDist = dist;
-          bestLocalIdx = i;
-        }
-      }
-
-      return wordOffset + bestLocalIdx;
-    }
-
-    // Internal node: find best matching child center
-    let minDist = Infinity;
-    let bestChildIdx = 0;
-
-    for (let i = 0; i < node.centers.length; i++) {
-      const dist = this._hammingDistance(descriptor, node.centers[i]);
-      if (dist < minDist) {
-        minDist = dist;
-        bestChildIdx = i;
-      }
-    }
-
-    // Calculate word offset for the chosen subtree
-    let subtreeSize = 0;
-    if (node.children && node.children.length > 0) {
-      // Count words in previous siblings
-      for (let i = 0; i < bestChildIdx && i < node.children.length; i++) {
-        subtreeSize += this._countWords(node.children[i]);
-      }
-    }
-
-    // Recurse into best matching child
-    if (node.children && node.children[bestChildIdx]) {
-      return this._quantizeDescriptorHierarchical(
-        descriptor,
-        node.children[bestChildIdx],
-        wordOffset + subtreeSize
-      );
-    }
-
-    // Shouldn't reach here, but return offset as fallback
-    return wordOffset;
-  }
-
-  /**
-   * Count total vocabulary words in a subtree
-   * @param {Object} node - Tree node
-   * @returns {number} Number of words
-   */
-  _countWords(node) {
-    if (node.isLeaf) {
-      return node.centers.length;
-    }
-
-    let count = 0;
-    if (node.children) {
-      for (const child of node.children) {
-        count += this._countWords(child);
-      }
-    }
-    return count;
-  }
-
-  /**
-   * Hamming distance between two binary descriptors
-   * @param {Uint8Array} a - First descriptor
-   * @param {Uint8Array} b - Second descriptor
-   * @returns {number} Hamming distance
-   */
-  _hammingDistance(a, b) {
-    let dist = 0;
-    for (let i = 0; i < a.length; i++) {
-      const xor = a[i] ^ b[i];
-      // Count set bits (popcount)
-      let count = xor;
-      count = count - ((count >> 1) & 0x55);
-      count = (count & 0x33) + ((count >> 2) & 0x33);
-      count = (count + (count >> 4)) & 0x0f;
-      dist += count;
-    }
-    return dist;
-  }
-
   /**
    * Compute TF-IDF vector from BoW
    * @param {Object} bow - Bag-of-words vector
@@ -316,12 +267,20 @@ class VocabularyTreeQuery {
       ) / targets.length;
 
       frameVector = this.computeBM25(frameBow, avgDocLength);
-      console.log('[VocabularyTreeQuery] Frame BoW:', Object.keys(frameBow).length, 'words');
-      console.log('[VocabularyTreeQuery] Frame BM25:', Object.keys(frameVector).length, 'words');
+      if (Logger.debugEnabled) {
+        Logger.debug('[VocabularyTreeQuery] Frame BoW:', Object.keys(frameBow).length, 'words');
+        Logger.debug('[VocabularyTreeQuery] Frame BM25:', Object.keys(frameVector).length, 'words');
+      }
     } else {
       frameVector = this.computeTfIdf(frameBow);
-      console.log('[VocabularyTreeQuery] Frame BoW:', Object.keys(frameBow).length, 'words');
-      console.log('[VocabularyTreeQuery] Frame TF-IDF:', Object.keys(frameVector).length, 'words');
+      if (Logger.debugEnabled) {
+        Logger.debug('[VocabularyTreeQuery] Frame BoW:', Object.keys(frameBow).length, 'words');
+        Logger.debug('[VocabularyTreeQuery] Frame TF-IDF:', Object.keys(frameVector).length, 'words');
+      }
+    }
+
+    if (this.invertedIndex) {
+      return this._scoreWithInvertedIndex(frameVector, targets, maxCandidates);
     }
 
     // Score all targets
@@ -341,6 +300,100 @@ class VocabularyTreeQuery {
     return scores.slice(0, maxCandidates);
   }
 
+  /**
+   * Cosine scoring through the inverted file: only targets sharing at least
+   * one word with the frame are visited. Ranking matches the full scan
+   * (score descending, ties in target order, zero-score targets last).
+   * @param {Object} frameVector - Weighted frame BoW
+   * @param {Array} targets - Runtime targets with id
+   * @param {number} maxCandidates - Maximum candidates to return
+   * @returns {Array} Sorted array of {target, score}
+   */
+  _scoreWithInvertedIndex(frameVector, targets, maxCandidates) {
+    const index = this.invertedIndex;
+    const { wordOffsets, postingTargets, postingWeights, dots, stamps, touched } = index;
+
+    // New epoch marks all accumulators stale without clearing them
+    index.epoch = (index.epoch + 1) >>> 0;
+    if (index.epoch === 0) {
+      stamps.fill(0);
+      index.epoch = 1;
+    }
+    const epoch = index.epoch;
+
+    let frameNorm = 0;
+    let numTouched = 0;
+    for (const wordIdStr in frameVector) {
+      const weight = frameVector[wordIdStr];
+      frameNorm += weight * weight;
+
+      const wordId = +wordIdStr;
+      if (!(wordId >= 0 && wordId < index.wordCount)) continue;
+
+      for (let p = wordOffsets[wordId]; p < wordOffsets[wordId + 1]; p++) {
+        const t = postingTargets[p];
+        if (stamps[t] !== epoch) {
+          stamps[t] = epoch;
+          dots[t] = 0;
+          touched[numTouched++] = t;
+        }
+        dots[t] += weight * postingWeights[p];
+      }
+    }
+    frameNorm = Math.sqrt(frameNorm);
+
+    // Map indexed targets onto the caller's runtime targets; a stale table
+    // (targets added, removed or reordered) is rebuilt once and re-checked
+    if (index.positionsLength !== targets.length) {
+      this._mapTargetPositions(targets);
+    }
+    let hits = this._collectHits(targets, numTouched, frameNorm);
+    if (!hits) {
+      this._mapTargetPositions(targets);
+      hits = this._collectHits(targets, numTouched, frameNorm);
+    }
+
+    hits.sort((a, b) => (b.score - a.score) || (a.position - b.position));
+
+    const candidates = hits.slice(0, maxCandidates).map(({ target, score }) => ({ target, score }));
+    if (candidates.length < maxCandidates) {
+      const chosen = new Set(candidates.map(c => c.target));
+      for (let i = 0; i < targets.length && candidates.length < maxCandidates; i++) {
+        if (!chosen.has(targets[i])) {
+          candidates.push({ target: targets[i], score: 0 });
+        }
+      }
+    }
+    return candidates;
+  }
+
+  /**
+   * Scored hits of the touched targets
+   * @private
+   * @returns {Array|null} {target, score, position}, or null when the
+   *   position table does not match `targets`
+   */
+  _collectHits(targets, numTouched, frameNorm) {
+    const index = this.invertedIndex;
+    const { touched, dots, positions, targetIds, targetNorms } = index;
+    const hits = [];
+
+    for (let i = 0; i < numTouched; i++) {
+      const t = touched[i];
+      const position = positions[t];
+      if (position >= 0 && targets[position]?.id !== targetIds[t]) return null;
+
+      const norm = targetNorms[t];
+      if (position < 0 || frameNorm === 0 || norm === 0) continue;
+
+      const score = dots[t] / (frameNorm * norm);
+      if (score > 0) {
+        hits.push({ target: targets[position], score, position });
+      }
+    }
+    return hits;
+  }
+
   /**
    * Clean up resources
    */
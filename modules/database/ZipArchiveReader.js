@@ -0,0 +1,264 @@
+/**
+ * ZipArchiveReader - Random access to zip entries without reading the archive
+ *
+ * Parses the central directory from the end of the archive and reads single
+ * entries on demand. The byte source is either an HTTP URL (Range requests)
+ * or a Blob (blob.slice), so an album can be indexed from a few small reads
+ * and its videos pulled only when needed. Stored entries from a Blob are
+ * returned as zero-copy slices; deflated entries are inflated with
+ * DecompressionStream.
+ *
+ * Returns null / throws on anything the loader should hand to JSZip instead
+ * (no Range support, encrypted or unsupported entries).
+ */
+class ZipArchiveReader {
+  /**
+   * @param {Function} readRange - async (start, end) => ArrayBuffer of [start, end)
+   * @param {number} size - Archive size in bytes
+   * @param {Blob|null} blob - Source blob, for zero-copy slices
+   */
+  constructor(readRange, size, blob = null) {
+    this.readRange = readRange;
+    this.size = size;
+    this.blob = blob;
+    this.entries = [];
+    this.tail = null; // {start, bytes} from the opening read
+  }
+
+  /**
+   * Open an archive over HTTP Range requests
+   * @param {string} url
+   * @returns {Promise<ZipArchiveReader|null>} null if the server ignores Range
+   */
+  static async fromUrl(url) {
+    const response = await fetch(url, {
+      headers: { Range: `bytes=-${ZipArchiveReader.TAIL_BYTES}` }
+    });
+
+    const contentRange = response.headers.get('content-range');
+    const match = contentRange && contentRange.match(/bytes (\d+)-(\d+)\/(\d+)/);
+    if (response.status !== 206 || !match) {
+      // Full body coming back - do not download it twice
+      if (response.body) response.body.cancel();
+      return null;
+    }
+
+    const readRange = async (start, end) => {
+      const part = await fetch(url, { headers: { Range: `bytes=${start}-${end - 1}` } });
+      if (part.status !== 206) {
+        throw new Error(`Range request failed (${part.status})`);
+      }
+      return part.arrayBuffer();
+    };
+
+    const reader = new ZipArchiveReader(readRange, parseInt(match[3], 10));
+    reader.tail = {
+      start: parseInt(match[1], 10),
+      bytes: new Uint8Array(await response.arrayBuffer())
+    };
+    await reader.open();
+    return reader;
+  }
+
+  /**
+   * Open an archive held in a Blob / File
+   * @param {Blob} blob
+   * @returns {Promise<ZipArchiveReader>}
+   */
+  static async fromBlob(blob) {
+    const reader = new ZipArchiveReader(
+      (start, end) => blob.slice(start, end).arrayBuffer(),
+      blob.size,
+      blob
+    );
+    await reader.open();
+    return reader;
+  }
+
+  /**
+   * Whether deflated entries can be read
+   * @returns {boolean}
+   */
+  static canInflate() {
+    return typeof DecompressionStream !== 'undefined';
+  }
+
+  /**
+   * Read the central directory into this.entries
+   */
+  async open() {
+    const tailStart = Math.max(0, this.size - ZipArchiveReader.TAIL_BYTES);
+    const tail = this.tail ||
+      { start: tailStart, bytes: new Uint8Array(await this.readRange(tailStart, this.size)) };
+    const tailView = new DataView(tail.bytes.buffer, tail.bytes.byteOffset, tail.bytes.byteLength);
+
+    // End of central directory record: last signature match from the end
+    let eocd = -1;
+    for (let i = tail.bytes.length - 22; i >= 0; i--) {
+      if (tailView.getUint32(i, true) === ZipArchiveReader.SIG_EOCD) {
+        eocd = i;
+        break;
+      }
+    }
+    if (eocd < 0) {
+      throw new Error('Not a zip archive (no end of central directory)');
+    }
+
+    let count = tailView.getUint16(eocd + 10, true);
+    let directorySize = tailView.getUint32(eocd + 12, true);
+    let directoryOffset = tailView.getUint32(eocd + 16, true);
+
+    // ZIP64: the locator sits right before the EOCD record
+    if (directoryOffset === 0xFFFFFFFF || count === 0xFFFF) {
+      const locator = eocd - 20;
+      if (locator < 0 || tailView.getUint32(locator, true) !== ZipArchiveReader.SIG_ZIP64_LOCATOR) {
+        throw new Error('Corrupt ZIP64 archive');
+      }
+      const recordOffset = ZipArchiveReader.readUint64(tailView, locator + 8);
+      const record = new DataView(await this.readRange(recordOffset, recordOffset + 56));
+      if (record.getUint32(0, true) !== ZipArchiveReader.SIG_ZIP64_EOCD) {
+        throw new Error('Corrupt ZIP64 end of central directory');
+      }
+      count = ZipArchiveReader.readUint64(record, 32);
+      directorySize = ZipArchiveReader.readUint64(record, 40);
+      directoryOffset = ZipArchiveReader.readUint64(record, 48);
+    }
+
+    // Central directory is usually inside the tail we already have
+    let directory;
+    if (directoryOffset >= tail.start) {
+      const from = directoryOffset - tail.start;
+      directory = tail.bytes.subarray(from, from + directorySize);
+    } else {
+      directory = new Uint8Array(await this.readRange(directoryOffset, directoryOffset + directorySize));
+    }
+
+    this.entries = ZipArchiveReader.parseDirectory(directory, count);
+    this.tail = null;
+    return this.entries;
+  }
+
+  /**
+   * @private
+   */
+  static parseDirectory(directory, count) {
+    const view = new DataView(directory.buffer, directory.byteOffset, directory.byteLength);
+    const decoder = new TextDecoder();
+    const entries = [];
+    let p = 0;
+
+    for (let i = 0; i < count; i++) {
+      if (view.getUint32(p, true) !== ZipArchiveReader.SIG_CENTRAL) {
+        throw new Error('Corrupt zip central directory');
+      }
+
+      const nameLength = view.getUint16(p + 28, true);
+      const extraLength = view.getUint16(p + 30, true);
+      const commentLength = view.getUint16(p + 32, true);
+      const entry = {
+        name: decoder.decode(directory.subarray(p + 46, p + 46 + nameLength)),
+        flags: view.getUint16(p + 8, true),
+        method: view.getUint16(p + 10, true),
+        compressedSize: view.getUint32(p + 20, true),
+        size: view.getUint32(p + 24, true),
+        localOffset: view.getUint32(p + 42, true)
+      };
+      entry.dir = entry.name.endsWith('/');
+
+      // ZIP64 extended information: only the saturated fields are present
+      let e = p + 46 + nameLength;
+      const extraEnd = e + extraLength;
+      while (e + 4 <= extraEnd) {
+        const id = view.getUint16(e, true);
+        const length = view.getUint16(e + 2, true);
+        if (id === 0x0001) {
+          let q = e + 4;
+          if (entry.size === 0xFFFFFFFF) { entry.size = ZipArchiveReader.readUint64(view, q); q += 8; }
+          if (entry.compressedSize === 0xFFFFFFFF) {
+            entry.compressedSize = ZipArchiveReader.readUint64(view, q);
+            q += 8;
+          }
+          if (entry.localOffset === 0xFFFFFFFF) entry.localOffset = ZipArchiveReader.readUint64(view, q);
+        }
+        e += 4 + length;
+      }
+
+      entries.push(entry);
+      p = extraEnd + commentLength;
+    }
+
+    return entries;
+  }
+
+  /**
+   * Whether an entry can be read by this reader
+   * @param {Object} entry
+   * @returns {boolean}
+   */
+  supports(entry) {
+    if (entry.flags & 0x1) return false; // encrypted
+    if (entry.method === ZipArchiveReader.METHOD_STORED) return true;
+    return entry.method === ZipArchiveReader.METHOD_DEFLATE && ZipArchiveReader.canInflate();
+  }
+
+  /**
+   * Read one entry
+   * @param {Object} entry - From this.entries
+   * @param {string} type - MIME type of the returned Blob
+   * @returns {Promise<Blob>}
+   */
+  async readBlob(entry, type = '') {
+    if (!this.supports(entry)) {
+      throw new Error(`Unsupported zip entry: ${entry.name}`);
+    }
+
+    const dataStart = await this.locateData(entry);
+    const dataEnd = dataStart + entry.compressedSize;
+
+    if (entry.method === ZipArchiveReader.METHOD_STORED) {
+      if (this.blob) {
+        return this.blob.slice(dataStart, dataEnd, type);
+      }
+      return new Blob([await this.readRange(dataStart, dataEnd)], { type });
+    }
+
+    const compressed = new Blob([await this.readRange(dataStart, dataEnd)]);
+    const inflated = compressed.stream().pipeThrough(new DecompressionStream('deflate-raw'));
+    return new Blob([await new Response(inflated).arrayBuffer()], { type });
+  }
+
+  /**
+   * Offset of an entry's data (the local header's extra field may differ
+   * from the central directory's, so it has to be read)
+   * @private
+   */
+  async locateData(entry) {
+    const header = new DataView(await this.readRange(entry.localOffset, entry.localOffset + 30));
+    if (header.getUint32(0, true) !== ZipArchiveReader.SIG_LOCAL) {
+      throw new Error(`Corrupt local header: ${entry.name}`);
+    }
+    return entry.localOffset + 30 + header.getUint16(26, true) + header.getUint16(28, true);
+  }
+
+  /**
+   * @private
+   */
+  static readUint64(view, offset) {
+    return view.getUint32(offset, true) + view.getUint32(offset + 4, true) * 0x100000000;
+  }
+}
+
+ZipArchiveReader.SIG_LOCAL = 0x04034b50;
+ZipArchiveReader.SIG_CENTRAL = 0x02014b50;
+ZipArchiveReader.SIG_EOCD = 0x06054b50;
+ZipArchiveReader.SIG_ZIP64_LOCATOR = 0x07064b50;
+ZipArchiveReader.SIG_ZIP64_EOCD = 0x06064b50;
+ZipArchiveReader.METHOD_STORED = 0;
+ZipArchiveReader.METHOD_DEFLATE = 8;
+// EOCD (22) + max comment (65535) + ZIP64 locator (20), rounded up
+ZipArchiveReader.TAIL_BYTES = 65600;
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.ZipArchiveReader = ZipArchiveReader;
+}
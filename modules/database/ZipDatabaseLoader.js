@@ -13,17 +13,33 @@ class ZipDatabaseLoader {
     this.database = null;
     this.vocabularyQuery = null;
     this.videoBlobs = new Map(); // targetId -> blob URL
+    this.archive = null; // ZipArchiveReader when streaming
+    this.deferredVideos = new Map(); // targetId -> {read, promise, retryAt}
+    this.cacheSources = []; // [{name, type, read}] for AlbumContentCache
+    this.decodeCanvas = null; // Shared by an album's images while loading
+    this.targetClahe = null;
   }
 
   /**
    * Load database from zip file
-   * @param {string|File} source - URL to zip or File object
+   * @param {string|File|CachedAlbum} source - URL to zip, File object or an
+   *   album already extracted into AlbumContentCache
    * @returns {Promise<Object>} Database structure
    */
   async loadFromZip(source) {
+    if (typeof CachedAlbum !== 'undefined' && source instanceof CachedAlbum) {
+      return this._loadFromCache(source);
+    }
+
     console.log('Loading album from zip...');
     this.onProgress({ stage: 'loading', progress: 0, message: 'Loading zip file...' });
 
+    // Streaming: index the archive, read images only, defer videos
+    const archive = await this._openArchive(source);
+    if (archive) {
+      return this._loadFromArchive(archive);
+    }
+
     let zipData;
     if (typeof source === 'string') {
       // Load from URL
@@ -54,21 +70,170 @@ class ZipDatabaseLoader {
     return this.database;
   }
 
+  /**
+   * Open the archive for random access when streaming is enabled
+   * @param {string|Blob} source
+   * @returns {Promise<ZipArchiveReader|null>} null to use the JSZip path
+   */
+  async _openArchive(source) {
+    if (!AppConfig.album.streaming || typeof ZipArchiveReader === 'undefined') {
+      return null;
+    }
+
+    try {
+      const archive = typeof source === 'string'
+        ? await ZipArchiveReader.fromUrl(source)
+        : await ZipArchiveReader.fromBlob(source);
+      if (!archive) {
+        console.log('[ZipDatabaseLoader] No range support, loading whole archive');
+        return null;
+      }
+
+      const unsupported = archive.entries.find(entry => this._isRootEntry(entry.name, entry) &&
+        (this._isImageFile(entry.name) || this._isVideoFile(entry.name)) && !archive.supports(entry));
+      if (unsupported) {
+        console.log(`[ZipDatabaseLoader] Cannot stream ${unsupported.name}, loading whole archive`);
+        return null;
+      }
+
+      return archive;
+    } catch (error) {
+      console.warn('[ZipDatabaseLoader] Streaming open failed, loading whole archive:', error);
+      return null;
+    }
+  }
+
+  /**
+   * Build the database from an indexed archive. Only images are read here;
+   * videos are fetched by resolveVideoUrl() when their target is first shown.
+   * @param {ZipArchiveReader} archive
+   */
+  async _loadFromArchive(archive) {
+    console.log(`[ZipDatabaseLoader] Streaming album (${archive.entries.length} entries)`);
+    this.archive = archive;
+    this.onProgress({ stage: 'loading', progress: 100, message: 'Archive indexed' });
+
+    const rootEntries = archive.entries.filter(entry => this._isRootEntry(entry.name, entry));
+
+    const images = await this._loadImages(rootEntries
+      .filter(entry => this._isImageFile(entry.name))
+      .map(entry => ({ path: entry.name, read: () => archive.readBlob(entry) })));
+
+    for (const entry of rootEntries) {
+      if (this._isImageFile(entry.name)) {
+        this._addCacheSource({
+          name: entry.name,
+          type: this._getImageMimeType(entry.name),
+          read: () => archive.readBlob(entry)
+        });
+      }
+      if (!this._isVideoFile(entry.name)) continue;
+      const ext = entry.name.toLowerCase().split('.').pop();
+      const mimeType = this._getVideoMimeType(ext);
+      const targetId = this._targetIdFromFilename(entry.name, 'video');
+      this.deferredVideos.set(targetId, {
+        read: () => archive.readBlob(entry, mimeType),
+        promise: null,
+        retryAt: 0
+      });
+      this._addCacheSource({
+        name: entry.name,
+        type: mimeType,
+        // A video shown before caching is read from its blob URL, not again
+        read: () => this.videoBlobs.has(targetId)
+          ? fetch(this.videoBlobs.get(targetId)).then(response => response.blob())
+          : archive.readBlob(entry, mimeType)
+      });
+    }
+    console.log(`Indexed ${this.deferredVideos.size} videos (loaded on first detection)`);
+
+    await this._buildDatabase(images, new Map());
+    return this.database;
+  }
+
+  /**
+   * Build the database from an album in AlbumContentCache. Videos play from
+   * their cache URLs when sw.js serves them, else load on first detection.
+   * @param {CachedAlbum} album
+   */
+  async _loadFromCache(album) {
+    console.log(`[ZipDatabaseLoader] Loading album from cache (${album.entries.length} files)`);
+    this.onProgress({ stage: 'loading', progress: 100, message: 'Loaded from cache' });
+
+    const images = await this._loadImages(album.entries
+      .filter(entry => this._isImageFile(entry.name))
+      .map(entry => ({ path: entry.name, read: () => album.read(entry.name) })));
+
+    const videos = new Map();
+    const streamable = album.streamable;
+    for (const entry of album.entries) {
+      if (!this._isVideoFile(entry.name)) continue;
+      const targetId = this._targetIdFromFilename(entry.name, 'video');
+      if (streamable) {
+        videos.set(targetId, album.url(entry.name));
+      } else {
+        this.deferredVideos.set(targetId, { read: () => album.read(entry.name), promise: null, retryAt: 0 });
+      }
+    }
+    console.log(streamable
+      ? `Streaming ${videos.size} videos from the album cache`
+      : `Indexed ${this.deferredVideos.size} cached videos (loaded on first detection)`);
+
+    await this._buildDatabase(images, videos);
+    return this.database;
+  }
+
+  /**
+   * Remember how to re-read an album file for the album cache (albums
+   * opened from a code only; a local file is not cached)
+   * @private
+   */
+  _addCacheSource(source) {
+    if (this.albumCode) this.cacheSources.push(source);
+  }
+
+  /**
+   * Album files to store in AlbumContentCache after a load from a zip;
+   * handed out once so their sources can be freed
+   * @returns {Array<{name, type, read}>} read() resolves to a Blob
+   */
+  takeCacheableEntries() {
+    const entries = this.cacheSources;
+    this.cacheSources = [];
+    return entries;
+  }
+
   /**
    * Extract image files from zip (files in root directory only)
    */
   async _extractImages(zip) {
-    const images = [];
     const imageFiles = [];
 
     // Look for image files in root directory
     zip.forEach((relativePath, file) => {
       // Only process files in root (no directory separator)
-      if (!file.dir && !relativePath.includes('/') && this._isImageFile(relativePath)) {
-        imageFiles.push({ path: relativePath, file });
+      if (this._isRootEntry(relativePath, file) && this._isImageFile(relativePath)) {
+        imageFiles.push({ path: relativePath, read: () => file.async('blob') });
+        this._addCacheSource({
+          name: relativePath,
+          type: this._getImageMimeType(relativePath),
+          read: () => file.async('blob')
+        });
       }
     });
 
+    return this._loadImages(imageFiles);
+  }
+
+  /**
+   * Decode target images into Mats. Decoding runs off the main thread
+   * (createImageBitmap), one image ahead of the preprocessing of the current
+   * one; see _imageToMat for the resolution cap.
+   * @param {Array<{path, read}>} imageFiles - read() resolves to the image Blob
+   */
+  async _loadImages(imageFiles) {
+    const images = [];
+
     if (imageFiles.length === 0) {
       throw new Error(`No image files found in zip root directory`);
     }
@@ -81,37 +246,41 @@ class ZipDatabaseLoader {
       message: `Loading ${imageFiles.length} images...`
     });
 
-    // Load each image
-    for (let i = 0; i < imageFiles.length; i++) {
-      const { path, file } = imageFiles[i];
-      const blob = await file.async('blob');
-      const imageMat = await this._loadImageToMat(blob);
+    // Load each image, reading and decoding the next one while this one is preprocessed
+    const decode = (file) => file.read().then(blob =>
+      this._decodeImage(blob).then(image => ({ blob, image }))
+    );
+    let next = decode(imageFiles[0]);
+    try {
+      for (let i = 0; i < imageFiles.length; i++) {
+        const { path } = imageFiles[i];
+        const { blob, image } = await next;
+        if (i + 1 < imageFiles.length) {
+          next = decode(imageFiles[i + 1]);
+        }
+        const imageMat = this._imageToMat(image);
 
-      // Extract target ID from filename
-      const filename = path.split('/').pop();
-      const baseFilename = filename.replace(/\.[^/.]+$/, '');
-
-      // Handle both patterns:
-      // 1. Direct match: photo1.jpg → photo1
-      // 2. Photo/video pattern: photo123.jpg → 123 (to match with video123.mp4)
-      let targetId = baseFilename;
-      if (baseFilename.match(/^photo\d+$/i)) {
-        // Extract just the number: photo123 → 123
-        targetId = baseFilename.replace(/^photo/i, '');
-      }
+        const filename = path.split('/').pop();
+        const targetId = this._targetIdFromFilename(filename, 'photo');
 
-      images.push({
-        targetId,
-        filename,
-        imageMat,
-        blob
-      });
+        images.push({
+          targetId,
+          filename,
+          imageMat,
+          blob
+        });
 
-      this.onProgress({
-        stage: 'images',
-        progress: ((i + 1) / imageFiles.length) * 100,
-        message: `Loaded ${filename}`
-      });
+        this.onProgress({
+          stage: 'images',
+          progress: ((i + 1) / imageFiles.length) * 100,
+          message: `Loaded ${filename}`
+        });
+      }
+    } catch (error) {
+      for (const img of images) img.imageMat.delete();
+      throw error;
+    } finally {
+      this._releaseImageDecoder();
     }
 
     return images;
@@ -127,7 +296,7 @@ class ZipDatabaseLoader {
     // Look for video files in root directory
     zip.forEach((relativePath, file) => {
       // Only process files in root (no directory separator)
-      if (!file.dir && !relativePath.includes('/') && this._isVideoFile(relativePath)) {
+      if (this._isRootEntry(relativePath, file) && this._isVideoFile(relativePath)) {
         videoFiles.push({ path: relativePath, file });
       }
     });
@@ -145,9 +314,7 @@ class ZipDatabaseLoader {
       const { path, file } = videoFiles[i];
       const arrayBuffer = await file.async('arraybuffer');
 
-      // Extract target ID from filename
       const filename = path.split('/').pop();
-      const baseFilename = filename.replace(/\.[^/.]+$/, '');
 
       // Get MIME type based on file extension
       const ext = filename.toLowerCase().split('.').pop();
@@ -155,15 +322,9 @@ class ZipDatabaseLoader {
 
       // Create blob with correct MIME type
       const blob = new Blob([arrayBuffer], { type: mimeType });
+      this._addCacheSource({ name: path, type: mimeType, read: async () => blob });
 
-      // Handle both patterns:
-      // 1. Direct match: video1.mp4 → video1
-      // 2. Photo/video pattern: video123.mp4 → 123 (to match with photo123.jpg)
-      let targetId = baseFilename;
-      if (baseFilename.match(/^video\d+$/i)) {
-        // Extract just the number: video123 → 123
-        targetId = baseFilename.replace(/^video/i, '');
-      }
+      const targetId = this._targetIdFromFilename(filename, 'video');
 
       // Create blob URL for video
       const blobUrl = URL.createObjectURL(blob);
@@ -186,12 +347,19 @@ class ZipDatabaseLoader {
   async _buildDatabase(images, videos) {
     console.log('Building vocabulary tree from images...');
 
+    // Worker pool for extraction / k-means; only started on a cache miss
+    const workerPool = AppConfig.vocabulary.parallelBuild &&
+      typeof VocabularyWorkerPool !== 'undefined' && VocabularyWorkerPool.isSupported()
+      ? new VocabularyWorkerPool()
+      : null;
+
     // Create vocabulary builder
     this.vocabularyBuilder = new VocabularyBuilder({
       branchingFactor: AppConfig.vocabulary.branchingFactor,
       levels: AppConfig.vocabulary.levels,
       maxFeaturesPerTarget: AppConfig.vocabulary.maxFeaturesPerTarget,
       albumCode: this.albumCode,
+      workerPool,
       onProgress: (progress) => {
         this.onProgress({
           stage: progress.stage,
@@ -208,7 +376,12 @@ class ZipDatabaseLoader {
     }));
 
     // Process targets and build vocabulary
-    await this.vocabularyBuilder.processTargets(targetData);
+    try {
+      await this.vocabularyBuilder.processTargets(targetData);
+    } finally {
+      if (workerPool) workerPool.terminate();
+      this.vocabularyBuilder.workerPool = null;
+    }
 
     // Export database
     this.database = this.vocabularyBuilder.exportDatabase();
@@ -218,6 +391,8 @@ class ZipDatabaseLoader {
       const videoUrl = videos.get(target.id);
       if (videoUrl) {
         target.videoUrl = videoUrl;
+      } else if (this.deferredVideos.has(target.id)) {
+        target.videoDeferred = true;
       } else {
         console.warn(`No video found for target: ${target.id}`);
       }
@@ -247,14 +422,15 @@ class ZipDatabaseLoader {
    */
   _initializeVocabularyQuery() {
     try {
-      // VocabularyTreeQuery expects vocabulary as array of arrays (not Mats)
+      // VocabularyTreeQuery expects vocabulary as array of byte arrays (not Mats)
       const vocabulary = this.database.vocabulary.words;
       const idf = this.database.vocabulary.idf_weights;
-      const vocabularyTree = this.database.vocabulary.tree || null;
+      const vocabularyTree = this.database.vocabulary.flat_tree || this.database.vocabulary.tree || null;
+      const invertedIndex = this.database.vocabulary.inverted_index || null;
 
       // Create vocabulary query (assumes VocabularyTreeQuery is globally available)
       if (typeof VocabularyTreeQuery !== 'undefined') {
-        this.vocabularyQuery = new VocabularyTreeQuery(vocabulary, idf, vocabularyTree);
+        this.vocabularyQuery = new VocabularyTreeQuery(vocabulary, idf, vocabularyTree, invertedIndex);
         console.log('Vocabulary tree query initialized');
       } else {
         console.warn('VocabularyTreeQuery not available');
@@ -266,68 +442,138 @@ class ZipDatabaseLoader {
   }
 
   /**
-   * Load image blob to OpenCV Mat
+   * Decode an image blob without blocking the main thread
+   * @param {Blob} blob
+   * @returns {Promise<ImageBitmap|HTMLImageElement>}
    */
-  _loadImageToMat(blob) {
-    return new Promise((resolve, reject) => {
-      const img = new Image();
-      img.onload = () => {
-        try {
-          // Create canvas and draw image
-          const canvas = document.createElement('canvas');
-          canvas.width = img.width;
-          canvas.height = img.height;
-          const ctx = canvas.getContext('2d');
-          ctx.drawImage(img, 0, 0);
-
-          // Convert to OpenCV Mat
-          const imageMat = cv.imread(canvas);
-
-          // Convert to grayscale for feature detection
-          const gray = new cv.Mat();
-          cv.cvtColor(imageMat, gray, cv.COLOR_RGBA2GRAY);
-
-          let processingMat = gray;
-
-          // Preprocessing pipeline for target images during database creation
-          if (AppConfig.targetPreprocessing.useCLAHE) {
-            // 1. Optional Gaussian blur to reduce noise
-            if (AppConfig.targetPreprocessing.useBlur) {
-              const blurred = new cv.Mat();
-              const kernelSize = AppConfig.targetPreprocessing.blurKernelSize || 3;
-              const sigma = AppConfig.targetPreprocessing.blurSigma || 0.5;
-              cv.GaussianBlur(processingMat, blurred, new cv.Size(kernelSize, kernelSize), sigma);
-              processingMat = blurred;
-            }
-
-            // 2. CLAHE for contrast enhancement
-            const clahe = new cv.CLAHE(2.0, new cv.Size(8, 8));
-            const enhanced = new cv.Mat();
-            clahe.apply(processingMat, enhanced);
-
-            // Clean up intermediate results
-            if (AppConfig.targetPreprocessing.useBlur) {
-              processingMat.delete(); // Delete blurred mat
-            }
-            gray.delete(); // Delete original
-            processingMat = enhanced; // Use enhanced version
-            clahe.delete();
-          }
-
-          // Clean up
-          imageMat.delete();
-
-          URL.revokeObjectURL(img.src);
-          resolve(processingMat);
-        } catch (error) {
-          reject(error);
-        }
-      };
-      img.onerror = () => {
-        reject(new Error('Failed to load image'));
-      };
-      img.src = URL.createObjectURL(blob);
-    });
+  async _decodeImage(blob) {
+    if (typeof createImageBitmap === 'function') {
+      return createImageBitmap(blob);
+    }
+
+    const img = new Image();
+    const url = URL.createObjectURL(blob);
+    try {
+      img.src = url;
+      await img.decode();
+      return img;
+    } finally {
+      URL.revokeObjectURL(url);
+    }
+  }
+
+  /**
+   * Decoded image to a preprocessed grayscale Mat. The image is drawn into
+   * one canvas shared by the whole album, scaled so its longer side is at
+   * most targetPreprocessing.maxDimension. Extraction cost grows with the
+   * pixels, and the album is built once for every quality tier, so the cap
+   * sits above the largest frame size detection runs at
+   * (frameProcessing.maxDimension and the governor tiers). Features from
+   * finer detail would never be found in a frame.
+   * @param {ImageBitmap|HTMLImageElement} image - Closed here if an ImageBitmap
+   * @returns {cv.Mat} CV_8UC1
+   */
+  _imageToMat(image) {
+    const maxDimension = AppConfig.targetPreprocessing.maxDimension || 0;
+    const longer = Math.max(image.width, image.height);
+    const scale = maxDimension > 0 && longer > maxDimension ? maxDimension / longer : 1;
+    const width = Math.max(1, Math.round(image.width * scale));
+    const height = Math.max(1, Math.round(image.height * scale));
+
+    if (!this.decodeCanvas) {
+      this.decodeCanvas = typeof OffscreenCanvas !== 'undefined'
+        ? new OffscreenCanvas(width, height)
+        : document.createElement('canvas');
+    }
+    const canvas = this.decodeCanvas;
+    canvas.width = width;
+    canvas.height = height;
+    const ctx = canvas.getContext('2d', { willReadFrequently: true });
+    ctx.imageSmoothingQuality = 'high';
+    ctx.drawImage(image, 0, 0, width, height);
+    if (typeof image.close === 'function') image.close();
+
+    const rgba = cv.matFromImageData(ctx.getImageData(0, 0, width, height));
+    const gray = new cv.Mat();
+    cv.cvtColor(rgba, gray, cv.COLOR_RGBA2GRAY);
+    rgba.delete();
+
+    return this._preprocessTarget(gray);
+  }
+
+  /**
+   * Preprocessing pipeline for target images during database creation
+   * @param {cv.Mat} gray - Consumed (deleted or returned)
+   * @returns {cv.Mat}
+   */
+  _preprocessTarget(gray) {
+    if (!AppConfig.targetPreprocessing.useCLAHE) {
+      return gray;
+    }
+
+    let processingMat = gray;
+
+    // 1. Optional Gaussian blur to reduce noise
+    if (AppConfig.targetPreprocessing.useBlur) {
+      const blurred = new cv.Mat();
+      const kernelSize = AppConfig.targetPreprocessing.blurKernelSize || 3;
+      const sigma = AppConfig.targetPreprocessing.blurSigma || 0.5;
+      cv.GaussianBlur(processingMat, blurred, new cv.Size(kernelSize, kernelSize), sigma);
+      processingMat = blurred;
+    }
+
+    // 2. CLAHE for contrast enhancement (one instance for the album)
+    if (!this.targetClahe) {
+      this.targetClahe = new cv.CLAHE(2.0, new cv.Size(8, 8));
+    }
+    const enhanced = new cv.Mat();
+    this.targetClahe.apply(processingMat, enhanced);
+
+    // Clean up intermediate results
+    if (processingMat !== gray) {
+      processingMat.delete(); // Delete blurred mat
+    }
+    gray.delete(); // Delete original
+    return enhanced;
+  }
+
+  /**
+   * Free the canvas and CLAHE shared by one album's images
+   * @private
+   */
+  _releaseImageDecoder() {
+    if (this.decodeCanvas) {
+      // Release the backing store now rather than at GC
+      this.decodeCanvas.width = 0;
+      this.decodeCanvas.height = 0;
+      this.decodeCanvas = null;
+    }
+    if (this.targetClahe) {
+      this.targetClahe.delete();
+      this.targetClahe = null;
+    }
+  }
+
+  /**
+   * Files in the archive root only (no directory separator)
+   * @param {string} path
+   * @param {Object} entry - JSZip object or ZipArchiveReader entry ({dir})
+   */
+  _isRootEntry(path, entry) {
+    return !entry.dir && !path.includes('/');
+  }
+
+  /**
+   * Target id from a photo/video filename. Handles both patterns:
+   * 1. Direct match: photo1.jpg → photo1
+   * 2. Photo/video pattern: photo123.jpg / video123.mp4 → 123
+   * @param {string} filename
+   * @param {string} prefix - 'photo' or 'video'
+   */
+  _targetIdFromFilename(filename, prefix) {
+    const baseFilename = filename.replace(/\.[^/.]+$/, '');
+    const numbered = new RegExp(`^${prefix}(\\d+)$`, 'i').exec(baseFilename);
+    return numbered ? numbered[1] : baseFilename;
   }
 
   /**
@@ -346,6 +592,14 @@ class ZipDatabaseLoader {
     return ['mp4', 'webm', 'ogv', 'mov'].includes(ext);
   }
 
+  /**
+   * Get MIME type for image file
+   */
+  _getImageMimeType(filename) {
+    const ext = filename.toLowerCase().split('.').pop();
+    return ext === 'jpg' ? 'image/jpeg' : `image/${ext}`;
+  }
+
   /**
    * Get MIME type for video file
    */
@@ -399,6 +653,42 @@ class ZipDatabaseLoader {
     return this.videoBlobs.get(targetId);
   }
 
+  /**
+   * Blob URL for a target's video, reading a deferred video from the
+   * archive on first call (concurrent calls share one read). A failed read
+   * is retried once album.videoRetryDelay has passed; until then calls
+   * resolve to null
+   * @param {string} targetId
+   * @returns {Promise<string|null>}
+   */
+  resolveVideoUrl(targetId) {
+    const existing = this.videoBlobs.get(targetId);
+    if (existing) return Promise.resolve(existing);
+
+    const deferred = this.deferredVideos.get(targetId);
+    if (!deferred) return Promise.resolve(null);
+
+    if (!deferred.promise) {
+      if (Date.now() < deferred.retryAt) return Promise.resolve(null);
+
+      console.log(`[ZipDatabaseLoader] Loading deferred video for ${targetId}`);
+      deferred.promise = deferred.read()
+        .then(blob => {
+          const blobUrl = URL.createObjectURL(blob);
+          this.videoBlobs.set(targetId, blobUrl);
+          this.deferredVideos.delete(targetId);
+          return blobUrl;
+        })
+        .catch(error => {
+          // Keep the entry for a later retry, but not on every frame
+          deferred.promise = null;
+          deferred.retryAt = Date.now() + (AppConfig.album.videoRetryDelay ?? 5000);
+          throw error;
+        });
+    }
+    return deferred.promise;
+  }
+
   /**
    * Clean up resources
    */
@@ -408,6 +698,9 @@ class ZipDatabaseLoader {
       URL.revokeObjectURL(blobUrl);
     }
     this.videoBlobs.clear();
+    this.deferredVideos.clear();
+    this.cacheSources = [];
+    this.archive = null;
     this.database = null;
     this.vocabularyBuilder = null;
   }
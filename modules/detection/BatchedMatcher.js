@@ -0,0 +1,256 @@
+/**
+ * BatchedMatcher - Matches one frame against several targets in a single call
+ *
+ * The descriptors of all candidate targets are stacked (cv.vconcat, cached
+ * while the candidate set is unchanged) and matched against the frame with one
+ * knnMatch. Reference rows stay grouped by target, so per-target results are
+ * contiguous ranges of flat typed arrays:
+ *
+ *   targetIndex[i], refIndex[i], frameIndex[i], distance[i], good[i]
+ *   for i in [offsets[t], offsets[t + 1])
+ *
+ * good[i] is the ratio test against the second-nearest frame descriptor, the
+ * same test FeatureDetector applied per target. The downstream stages read
+ * these arrays instead of walking DMatch vectors through embind.
+ */
+class BatchedMatcher {
+  /**
+   * @param {cv.BFMatcher} matcher - Shared Hamming matcher
+   * @param {PerformanceProfiler} profiler
+   */
+  constructor(matcher, profiler = null) {
+    this.matcher = matcher;
+    this.profiler = profiler;
+
+    // Stacked reference descriptors for the last candidate set
+    this.stacked = null;
+    this.stackedSources = [];
+    this.ownsStacked = false;
+
+    this.capacity = 0;
+    this.allocate(1024);
+  }
+
+  /**
+   * @private
+   */
+  allocate(capacity) {
+    this.capacity = capacity;
+    this.targetIndex = new Int32Array(capacity);
+    this.refIndex = new Int32Array(capacity);
+    this.frameIndex = new Int32Array(capacity);
+    this.distance = new Float32Array(capacity);
+    this.good = new Uint8Array(capacity);
+  }
+
+  /**
+   * Whether a target's reference data can be matched against the frame.
+   * Counts are checked first: reading referenceData.descriptors materializes
+   * the target's Mat (ReferenceCache)
+   * @param {Object} frameFeatures - {keypoints, descriptors}
+   * @param {ReferenceData} referenceData
+   * @returns {boolean}
+   */
+  static canMatch(frameFeatures, referenceData) {
+    const frameDescriptors = frameFeatures.descriptors;
+    if (!referenceData || !(referenceData.count > 10) ||
+        frameFeatures.keypoints.size() <= 10 ||
+        !frameDescriptors || frameDescriptors.empty() || frameDescriptors.rows === 0) {
+      return false;
+    }
+
+    const refDescriptors = referenceData.descriptors;
+    return !!(refDescriptors && !refDescriptors.empty() && refDescriptors.rows > 0 &&
+      frameDescriptors.cols === refDescriptors.cols);
+  }
+
+  /**
+   * Match the frame against every target's reference data
+   * @param {cv.Mat} frameDescriptors
+   * @param {Array<Object>} referenceList - referenceData of each target (all canMatch)
+   * @param {number} ratioThreshold - Lowe ratio
+   * @returns {Object} {count, offsets, goodCounts, targetIndex, refIndex,
+   *   frameIndex, distance, good}; the typed arrays are reused by the next call
+   */
+  match(frameDescriptors, referenceList, ratioThreshold) {
+    const targetCount = referenceList.length;
+    const offsets = new Int32Array(targetCount + 1);
+    const goodCounts = new Int32Array(targetCount);
+    for (let t = 0; t < targetCount; t++) {
+      offsets[t + 1] = offsets[t] + referenceList[t].descriptors.rows;
+    }
+
+    const rows = offsets[targetCount];
+    if (rows > this.capacity) {
+      this.allocate(Math.max(rows, this.capacity * 2));
+    }
+
+    const result = {
+      count: 0,
+      offsets,
+      goodCounts,
+      targetIndex: this.targetIndex,
+      refIndex: this.refIndex,
+      frameIndex: this.frameIndex,
+      distance: this.distance,
+      good: this.good
+    };
+    if (rows === 0) return result;
+
+    const query = this.stack(referenceList);
+
+    // Ranges are indexed by query row; rows without a match are left unused
+    result.count = rows;
+    this.good.fill(0, 0, rows);
+    this.frameIndex.fill(-1, 0, rows);
+
+    let knnMatches = null;
+    try {
+      knnMatches = new cv.DMatchVectorVector();
+
+      this.profiler?.startTimer(PerformanceProfiler.Span.DETECT_KNN_MATCH);
+      this.matcher.knnMatch(query, frameDescriptors, knnMatches, 2);
+      this.profiler?.endTimer(PerformanceProfiler.Span.DETECT_KNN_MATCH);
+
+      this.profiler?.startTimer(PerformanceProfiler.Span.DETECT_FILTER_MATCHES);
+      this.readKnn(knnMatches, offsets, ratioThreshold, result);
+      this.profiler?.endTimer(PerformanceProfiler.Span.DETECT_FILTER_MATCHES);
+    } catch (error) {
+      console.error('[BatchedMatcher] ❌ ERROR in KNN matching:', error);
+      this.matchNearest(query, frameDescriptors, offsets, result);
+    } finally {
+      if (knnMatches) knnMatches.delete();
+    }
+
+    return result;
+  }
+
+  /**
+   * Flatten knnMatch output with the ratio test, one pass over the rows
+   * @private
+   */
+  readKnn(knnMatches, offsets, ratioThreshold, result) {
+    const { targetIndex, refIndex, frameIndex, distance, good, goodCounts } = result;
+    const rows = Math.min(knnMatches.size(), result.count);
+
+    let t = 0;
+    for (let i = 0; i < rows; i++) {
+      while (i >= offsets[t + 1]) t++;
+
+      const pair = knnMatches.get(i);
+      const size = pair.size();
+      if (size >= 1) {
+        const first = pair.get(0);
+        targetIndex[i] = t;
+        refIndex[i] = i - offsets[t];
+        frameIndex[i] = first.trainIdx;
+        distance[i] = first.distance;
+
+        if (size >= 2) {
+          const second = pair.get(1);
+          if (Number.isFinite(first.distance) && Number.isFinite(second.distance) &&
+              first.distance < ratioThreshold * second.distance) {
+            good[i] = 1;
+            goodCounts[t]++;
+          }
+        }
+      }
+      pair.delete();
+    }
+  }
+
+  /**
+   * Fallback when knnMatch fails: nearest match per row, kept when within
+   * distanceThresholdMultiplier of the target's best distance
+   * @private
+   */
+  matchNearest(query, frameDescriptors, offsets, result) {
+    const { targetIndex, refIndex, frameIndex, distance, good, goodCounts } = result;
+    const matches = new cv.DMatchVector();
+
+    try {
+      this.matcher.match(query, frameDescriptors, matches);
+
+      const rows = Math.min(matches.size(), result.count);
+      let t = 0;
+      for (let i = 0; i < rows; i++) {
+        while (i >= offsets[t + 1]) t++;
+        const match = matches.get(i);
+        targetIndex[i] = t;
+        refIndex[i] = i - offsets[t];
+        frameIndex[i] = match.trainIdx;
+        distance[i] = match.distance;
+      }
+
+      for (let t = 0; t < goodCounts.length; t++) {
+        let best = Infinity;
+        for (let i = offsets[t]; i < offsets[t + 1]; i++) {
+          if (frameIndex[i] >= 0 && distance[i] < best) best = distance[i];
+        }
+        const threshold = Math.min(100, AppConfig.detection.distanceThresholdMultiplier * best);
+        for (let i = offsets[t]; i < offsets[t + 1]; i++) {
+          if (frameIndex[i] >= 0 && distance[i] <= threshold) {
+            good[i] = 1;
+            goodCounts[t]++;
+          }
+        }
+      }
+    } catch (error) {
+      console.error('[BatchedMatcher] ❌ ERROR in fallback matching:', error);
+      result.frameIndex.fill(-1, 0, result.count);
+      result.good.fill(0, 0, result.count);
+      goodCounts.fill(0);
+    } finally {
+      matches.delete();
+    }
+  }
+
+  /**
+   * Stacked descriptors of the reference list, rebuilt only when it changes
+   * @private
+   */
+  stack(referenceList) {
+    const sources = referenceList.map(referenceData => referenceData.descriptors);
+    const unchanged = this.stacked && sources.length === this.stackedSources.length &&
+      sources.every((mat, i) => mat === this.stackedSources[i]);
+    if (unchanged) return this.stacked;
+
+    this.release();
+    this.stackedSources = sources;
+
+    // One target: match its Mat directly
+    if (sources.length === 1) {
+      this.stacked = sources[0];
+      this.ownsStacked = false;
+      return this.stacked;
+    }
+
+    const list = new cv.MatVector();
+    try {
+      for (const mat of sources) list.push_back(mat);
+      this.stacked = new cv.Mat();
+      cv.vconcat(list, this.stacked);
+      this.ownsStacked = true;
+    } finally {
+      list.delete();
+    }
+    return this.stacked;
+  }
+
+  /**
+   * Drop the stacked descriptors (targets were replaced or removed)
+   */
+  release() {
+    if (this.stacked && this.ownsStacked) {
+      this.stacked.delete();
+    }
+    this.stacked = null;
+    this.stackedSources = [];
+    this.ownsStacked = false;
+  }
+}
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.BatchedMatcher = BatchedMatcher;
+}
@@ -28,6 +28,8 @@ class FeatureDetector {
             AppConfig.orb.patchSize,
             AppConfig.orb.fastThreshold
         );
+        this.pyramidLevels = AppConfig.orb.nlevels;
+        this.maxFeatures = AppConfig.orb.nfeatures;
         console.log('[FeatureDetector] ✅ ORB detector created');
 
         // TEBLID descriptor for feature description
@@ -52,11 +54,19 @@ class FeatureDetector {
         this.profiler = profiler;
         this.vocabularyQuery = vocabularyQuery; // Vocabulary tree query for candidate selection
         this.maxCandidates = AppConfig.detection.maxCandidates;
+        this.candidateScores = null; // [{targetId, score}] of the last vocabulary query
         this.useVocabularyTree = true; // Enable/disable vocabulary tree optimization
 
         // Reuse matcher across all targets to avoid recreation overhead
         // TEBLID uses binary descriptors, so NORM_HAMMING is correct
         this.matcher = new cv.BFMatcher(cv.NORM_HAMMING, false);
+        this.batchedMatcher = new BatchedMatcher(this.matcher, profiler);
+        // Single-target matches (region re-detection) get their own matcher,
+        // so they never replace the stacked candidate set of full detections
+        this.singleMatcher = new BatchedMatcher(this.matcher, profiler);
+
+        // Scratch Mats and CLAHE are reused across frames
+        this.pool = MatPool.shared();
     }
 
     /**
@@ -77,12 +87,12 @@ class FeatureDetector {
         }
 
         // OPTIMIZATION: Detect keypoints once for the frame, not per-target
-        this.profiler?.startTimer('detect_frame_features');
+        this.profiler?.startTimer(PerformanceProfiler.Span.DETECT_FRAME_FEATURES);
         const frameFeatures = this.extractFrameFeatures(frame);
-        this.profiler?.endTimer('detect_frame_features');
+        this.profiler?.endTimer(PerformanceProfiler.Span.DETECT_FRAME_FEATURES);
 
         if (!frameFeatures) {
-            console.log('[FeatureDetector] No frame features extracted');
+            Logger.debug('[FeatureDetector] No frame features extracted');
             return targets.map(target => ({
                 targetId: target.id,
                 targetLabel: target.label,
@@ -91,13 +101,15 @@ class FeatureDetector {
             }));
         }
 
-        console.log(`[FeatureDetector] Frame features: ${frameFeatures.keypoints.size()} keypoints`);
+        if (Logger.debugEnabled) {
+            Logger.debug(`[FeatureDetector] Frame features: ${frameFeatures.keypoints.size()} keypoints`);
+        }
 
         // VOCABULARY TREE OPTIMIZATION: Select candidates using BoW similarity
         let targetsToMatch = targets;
 
         if (this.useVocabularyTree && this.vocabularyQuery && targets.length >= this.maxCandidates) {
-            this.profiler?.startTimer('vocabulary_candidate_selection');
+            this.profiler?.startTimer(PerformanceProfiler.Span.VOCABULARY_CANDIDATE_SELECTION);
 
             // Adaptive candidate count based on vocabulary size
             const vocabSize = this.vocabularyQuery.vocabularySize;
@@ -108,17 +120,22 @@ class FeatureDetector {
                 adaptiveMaxCandidates = Math.min(1, targets.length); // Large vocab: check fewer
             }
 
-            const candidates = this.vocabularyQuery.queryCandidates(
+            // Ranked a little deeper than matched: video prefetch reads the scores
+            const ranked = this.vocabularyQuery.queryCandidates(
                 frameFeatures.descriptors,
                 targets,
-                adaptiveMaxCandidates
+                Math.max(adaptiveMaxCandidates, AppConfig.video?.prefetchCount || 0)
             );
-            this.profiler?.endTimer('vocabulary_candidate_selection');
-
-            console.log('[FeatureDetector] Vocabulary candidates:', candidates.map(c => ({
-                id: c.target.id,
-                score: c.score.toFixed(3)
-            })));
+            const candidates = ranked.slice(0, adaptiveMaxCandidates);
+            this.candidateScores = ranked.map(c => ({ targetId: c.target.id, score: c.score }));
+            this.profiler?.endTimer(PerformanceProfiler.Span.VOCABULARY_CANDIDATE_SELECTION);
+
+            if (Logger.debugEnabled) {
+                Logger.debug('[FeatureDetector] Vocabulary candidates:', candidates.map(c => ({
+                    id: c.target.id,
+                    score: c.score.toFixed(3)
+                })));
+            }
 
             // Adaptive similarity threshold based on vocabulary size
             let minSimilarity = AppConfig.detection.minSimilarityThreshold;
@@ -131,7 +148,9 @@ class FeatureDetector {
                 } else {
                     minSimilarity = 0.25;
                 }
-                console.log(`[FeatureDetector] Adaptive similarity threshold: ${minSimilarity.toFixed(2)} (vocab: ${vocabSize} words)`);
+                if (Logger.debugEnabled) {
+                    Logger.debug(`[FeatureDetector] Adaptive similarity threshold: ${minSimilarity.toFixed(2)} (vocab: ${vocabSize} words)`);
+                }
             }
 
             // Score gap filtering: require significant gap between top candidates
@@ -142,10 +161,11 @@ class FeatureDetector {
                 const scoreGap = candidates[0].score - candidates[1].score;
                 passedScoreGap = scoreGap > minScoreGap;
 
-                console.log(`[FeatureDetector] Score gap: ${scoreGap.toFixed(3)} (threshold: ${minScoreGap}, ${passedScoreGap ? 'PASS ✓' : 'FAIL ✗'})`);
-
-                if (!passedScoreGap) {
-                    console.log('[FeatureDetector] ⚠️  Ambiguous match: top scores too similar, rejecting all candidates');
+                if (Logger.debugEnabled) {
+                    Logger.debug(`[FeatureDetector] Score gap: ${scoreGap.toFixed(3)} (threshold: ${minScoreGap}, ${passedScoreGap ? 'PASS ✓' : 'FAIL ✗'})`);
+                    if (!passedScoreGap) {
+                        Logger.debug('[FeatureDetector] ⚠️  Ambiguous match: top scores too similar, rejecting all candidates');
+                    }
                 }
             }
 
@@ -167,22 +187,37 @@ class FeatureDetector {
             // FALLBACK: If vocabulary filtered everything out AND we have few targets,
             // fall back to checking all targets (vocabulary not discriminative enough)
             if (targetsToMatch.length === 0 && targets.length <= 5) {
-                console.log('[FeatureDetector] ⚠️  Vocabulary not discriminative, falling back to checking all targets');
+                Logger.debug('[FeatureDetector] ⚠️  Vocabulary not discriminative, falling back to checking all targets');
                 targetsToMatch = targets;
             }
 
-            console.log('[FeatureDetector] Checking targets:', targetsToMatch.map(t => t.id));
+            if (Logger.debugEnabled) {
+                Logger.debug('[FeatureDetector] Checking targets:', targetsToMatch.map(t => t.id));
+            }
         }
 
         // Match frame features against selected targets only
-        console.log(`[FeatureDetector] 🎯 MATCHING AGAINST ${targetsToMatch.length} TARGETS`);
+        if (Logger.debugEnabled) {
+            Logger.debug(`[FeatureDetector] 🎯 MATCHING AGAINST ${targetsToMatch.length} TARGETS`);
+        }
+
+        // One knnMatch for all matchable targets; per-target stages read its ranges
+        const matchable = targetsToMatch.filter(t => BatchedMatcher.canMatch(frameFeatures, t.referenceData));
+        const matchSet = this.batchedMatcher.match(
+            frameFeatures.descriptors,
+            matchable.map(t => t.referenceData),
+            AppConfig.detection.ratioThreshold
+        );
+
         const results = [];
         for (const target of targetsToMatch) {
-            console.log(`[FeatureDetector] ━━━━ Processing target: ${target.id} (${target.label}) ━━━━`);
+            if (Logger.debugEnabled) {
+                Logger.debug(`[FeatureDetector] ━━━━ Processing target: ${target.id} (${target.label}) ━━━━`);
+            }
 
-            this.profiler?.startTimer(`detection_target_${target.id}`);
-            const result = this.matchTarget(frameFeatures, target.referenceData);
-            this.profiler?.endTimer(`detection_target_${target.id}`);
+            this.profiler?.startTimer(PerformanceProfiler.Span.DETECTION_TARGET);
+            const result = this.matchTarget(frameFeatures, target.referenceData, matchSet, matchable.indexOf(target));
+            this.profiler?.endTimer(PerformanceProfiler.Span.DETECTION_TARGET, target.id);
 
             results.push({
                 targetId: target.id,
@@ -205,25 +240,27 @@ class FeatureDetector {
         }
 
         // Log detection summary
-        const successCount = results.filter(r => r.success).length;
-        const failCount = results.filter(r => !r.success).length;
-        console.log('[FeatureDetector] ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━');
-        console.log('[FeatureDetector] 📊 DETECTION CYCLE COMPLETE:', {
-            totalTargets: targets.length,
-            targetsChecked: targetsToMatch.length,
-            detected: successCount,
-            failed: failCount,
-            successRate: `${((successCount / results.length) * 100).toFixed(1)}%`
-        });
-        if (successCount > 0) {
-            const detectedTargets = results.filter(r => r.success).map(r => ({
-                id: r.targetId,
-                matches: r.goodMatchesCount,
-                score: r.score ? r.score.toFixed(3) : '0'
-            }));
-            console.log('[FeatureDetector] ✅ DETECTED TARGETS:', detectedTargets);
+        if (Logger.debugEnabled) {
+            const successCount = results.filter(r => r.success).length;
+            const failCount = results.filter(r => !r.success).length;
+            Logger.debug('[FeatureDetector] ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━');
+            Logger.debug('[FeatureDetector] 📊 DETECTION CYCLE COMPLETE:', {
+                totalTargets: targets.length,
+                targetsChecked: targetsToMatch.length,
+                detected: successCount,
+                failed: failCount,
+                successRate: `${((successCount / results.length) * 100).toFixed(1)}%`
+            });
+            if (successCount > 0) {
+                const detectedTargets = results.filter(r => r.success).map(r => ({
+                    id: r.targetId,
+                    matches: r.goodMatchesCount,
+                    score: r.score ? r.score.toFixed(3) : '0'
+                }));
+                Logger.debug('[FeatureDetector] ✅ DETECTED TARGETS:', detectedTargets);
+            }
+            Logger.debug('[FeatureDetector] ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━');
         }
-        console.log('[FeatureDetector] ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━');
 
         // Clean up frame features
         if (frameFeatures.keypoints) frameFeatures.keypoints.delete();
@@ -234,55 +271,79 @@ class FeatureDetector {
 
     /**
      * Extract keypoints and descriptors from frame (done once per frame)
+     * @param {cv.Mat} frame - Processing frame or a region view of it
+     * @param {Object} budget - Optional {maxFeatures, pyramidLevels, scratch}
+     *   overriding the quality tier; scratch names the pool buffers so region
+     *   and full-frame detections do not reallocate each other's
      */
-    extractFrameFeatures(frame) {
+    extractFrameFeatures(frame, budget = null) {
+        // Grayscale input frames are borrowed; intermediates are pool scratch Mats
         let frameGray = null;
         let frameKeypoints = null;
         let frameDescriptors = null;
+        const scratch = budget?.scratch || 'detect';
 
         try {
-            this.profiler?.startTimer('detect_gray_conversion');
-            frameGray = new cv.Mat();
-            cv.cvtColor(frame, frameGray, cv.COLOR_RGBA2GRAY);
-            this.profiler?.endTimer('detect_gray_conversion');
+            if (frame.channels() === 1) {
+                frameGray = frame;
+            } else {
+                this.profiler?.startTimer(PerformanceProfiler.Span.DETECT_GRAY_CONVERSION);
+                frameGray = this.pool.scratch(`${scratch}_gray`);
+                cv.cvtColor(frame, frameGray, cv.COLOR_RGBA2GRAY);
+                this.profiler?.endTimer(PerformanceProfiler.Span.DETECT_GRAY_CONVERSION);
+            }
 
             // Preprocessing pipeline for better feature quality
             if (AppConfig.framePreprocessing.useCLAHE) {
-                this.profiler?.startTimer('detect_preprocessing');
+                this.profiler?.startTimer(PerformanceProfiler.Span.DETECT_PREPROCESSING);
 
                 let processingMat = frameGray;
 
                 // Optional Gaussian blur to reduce noise
                 if (AppConfig.framePreprocessing.useBlur) {
-                    const blurred = new cv.Mat();
+                    const blurred = this.pool.scratch(`${scratch}_blur`);
                     const kernelSize = AppConfig.framePreprocessing.blurKernelSize || 3;
                     const sigma = AppConfig.framePreprocessing.blurSigma || 0.5;
                     cv.GaussianBlur(processingMat, blurred, new cv.Size(kernelSize, kernelSize), sigma);
                     processingMat = blurred;
                 }
 
-                // Apply CLAHE for contrast enhancement
-                const clahe = new cv.CLAHE(2.0, new cv.Size(8, 8));
-                const enhanced = new cv.Mat();
+                // Apply CLAHE for contrast enhancement (instance cached per parameters)
+                const clahe = this.pool.getObject('clahe_2.0_8x8', () => new cv.CLAHE(2.0, new cv.Size(8, 8)));
+                const enhanced = this.pool.scratch(`${scratch}_clahe`);
                 clahe.apply(processingMat, enhanced);
 
-                // Clean up intermediate results
-                if (AppConfig.framePreprocessing.useBlur) {
-                    processingMat.delete(); // Delete blurred mat
-                }
-                frameGray.delete(); // Delete original
                 frameGray = enhanced; // Use enhanced version
-                clahe.delete();
 
-                this.profiler?.endTimer('detect_preprocessing');
+                this.profiler?.endTimer(PerformanceProfiler.Span.DETECT_PREPROCESSING);
             }
 
             frameKeypoints = new cv.KeyPointVector();
             frameDescriptors = new cv.Mat();
 
-            this.profiler?.startTimer('detect_keypoints');
+            // Pyramid depth follows the quality tier (QualityGovernor)
+            const pyramidLevels = budget?.pyramidLevels || this.state?.pyramidLevels || AppConfig.orb.nlevels;
+            if (pyramidLevels !== this.pyramidLevels) {
+                this.detector.setNLevels(pyramidLevels);
+                this.pyramidLevels = pyramidLevels;
+            }
+
+            // ORB keeps the strongest keypoints natively (retainBest per pyramid
+            // level), so the tier's feature budget needs no JS pass; the grid
+            // mode over-detects and spreads the budget over the frame instead
+            const maxFeatures = budget?.maxFeatures || this.state?.maxFeatures || AppConfig.orb.nfeatures;
+            const keypointGrid = AppConfig.detection.keypointGrid || 0;
+            const requested = keypointGrid > 0
+                ? Math.ceil(maxFeatures * (AppConfig.detection.keypointOversample || 1))
+                : maxFeatures;
+            if (requested !== this.maxFeatures) {
+                this.detector.setMaxFeatures(requested);
+                this.maxFeatures = requested;
+            }
+
+            this.profiler?.startTimer(PerformanceProfiler.Span.DETECT_KEYPOINTS);
             this.detector.detect(frameGray, frameKeypoints);
-            this.profiler?.endTimer('detect_keypoints');
+            this.profiler?.endTimer(PerformanceProfiler.Span.DETECT_KEYPOINTS);
 
             // Diagnostic logging for low feature detection
             if (frameKeypoints.size() < 50) {
@@ -300,52 +361,159 @@ class FeatureDetector {
             }
 
             if (frameKeypoints.size() > 0) {
-                this.profiler?.startTimer('detect_limit_features');
-                const maxFeatures = this.state?.maxFeatures || AppConfig.orb.nfeatures;
-                const keypointsArray = [];
-
-                for (let i = 0; i < frameKeypoints.size(); i++) {
-                    keypointsArray.push(frameKeypoints.get(i));
+                if (keypointGrid > 0 && frameKeypoints.size() > maxFeatures) {
+                    this.profiler?.startTimer(PerformanceProfiler.Span.DETECT_LIMIT_FEATURES);
+                    frameKeypoints = this.retainGrid(frameKeypoints, maxFeatures, keypointGrid,
+                                                     frameGray.cols, frameGray.rows);
+                    this.profiler?.endTimer(PerformanceProfiler.Span.DETECT_LIMIT_FEATURES);
                 }
 
-                keypointsArray.sort((a, b) => b.response - a.response);
-
-                const limited = keypointsArray.slice(0, Math.min(maxFeatures, keypointsArray.length));
-
-                frameKeypoints.delete();
-                frameKeypoints = new cv.KeyPointVector();
-                for (const kp of limited) {
-                    frameKeypoints.push_back(kp);
-                }
-                this.profiler?.endTimer('detect_limit_features');
-
-                this.profiler?.startTimer('detect_compute_descriptors');
+                this.profiler?.startTimer(PerformanceProfiler.Span.DETECT_COMPUTE_DESCRIPTORS);
                 this.descriptor.compute(frameGray, frameKeypoints, frameDescriptors);
-                this.profiler?.endTimer('detect_compute_descriptors');
+                this.profiler?.endTimer(PerformanceProfiler.Span.DETECT_COMPUTE_DESCRIPTORS);
             }
 
-            const keypointPoints = this.keypointsToPoints(frameKeypoints);
-
+            // Single read of the keypoints, after compute dropped any
             return {
                 keypoints: frameKeypoints,
                 descriptors: frameDescriptors,
-                keypointPoints: keypointPoints
+                points: this.pointArray(frameKeypoints)
             };
         } catch (error) {
             console.error('Error extracting frame features:', error);
             if (frameKeypoints) frameKeypoints.delete();
             if (frameDescriptors) frameDescriptors.delete();
             return null;
+        }
+    }
+
+    /**
+     * Re-detect one tracked target inside its predicted quad: the frame is
+     * cropped to the quad's bounds grown by roiMargin, detected with a budget
+     * fitted to the crop and matched against that target alone
+     * @param {cv.Mat} frame - Processing frame
+     * @param {Object} target - Runtime target with referenceData
+     * @param {Array} corners - Predicted corners [{x, y} x4] in frame pixels
+     * @returns {Object} matchTarget result (corners in frame pixels)
+     */
+    detectTargetInRegion(frame, target, corners) {
+        const region = this.regionBudget(corners, target.referenceData, frame.cols, frame.rows);
+        if (!region) {
+            return {
+                targetId: target.id,
+                targetLabel: target.label,
+                success: false,
+                reason: 'Predicted region outside the frame'
+            };
+        }
+
+        let view = null;
+        let frameFeatures = null;
+
+        try {
+            view = frame.roi(region.rect);
+            frameFeatures = this.extractFrameFeatures(view, region);
+            if (!frameFeatures) {
+                return {
+                    targetId: target.id,
+                    targetLabel: target.label,
+                    success: false,
+                    reason: 'Failed to extract region features'
+                };
+            }
+
+            // Region keypoints into frame pixels, so corners come out in the frame
+            const points = frameFeatures.points;
+            for (let i = 0; i < points.length; i += 2) {
+                points[i] += region.rect.x;
+                points[i + 1] += region.rect.y;
+            }
+
+            return {
+                targetId: target.id,
+                targetLabel: target.label,
+                ...this.matchTarget(frameFeatures, target.referenceData),
+                region: region.rect
+            };
         } finally {
-            if (frameGray) frameGray.delete();
+            if (frameFeatures) {
+                frameFeatures.keypoints.delete();
+                frameFeatures.descriptors.delete();
+            }
+            if (view) view.delete();
         }
     }
 
+    /**
+     * Crop and detection budget for a region re-detection
+     *
+     * The feature budget follows the crop's share of the frame (at least
+     * roiMinFeatures). Pyramid levels are those whose scale can still meet
+     * one of the reference's: with the target at scale s of its reference
+     * image, frame level k matches reference level k - log(s) / log(scaleFactor).
+     * @returns {Object|null} {rect, maxFeatures, pyramidLevels, scratch}
+     */
+    regionBudget(corners, referenceData, width, height) {
+        if (!corners || corners.length !== 4 || !referenceData?.image) return null;
+
+        let minX = Infinity;
+        let minY = Infinity;
+        let maxX = -Infinity;
+        let maxY = -Infinity;
+        let area = 0;
+        for (let i = 0; i < 4; i++) {
+            const p = corners[i];
+            const q = corners[(i + 1) % 4];
+            if (!Number.isFinite(p.x) || !Number.isFinite(p.y)) return null;
+            minX = Math.min(minX, p.x);
+            minY = Math.min(minY, p.y);
+            maxX = Math.max(maxX, p.x);
+            maxY = Math.max(maxY, p.y);
+            area += p.x * q.y - q.x * p.y;
+        }
+        area = Math.abs(area) / 2;
+
+        const margin = AppConfig.detection.roiMargin;
+        const marginX = (maxX - minX) * margin;
+        const marginY = (maxY - minY) * margin;
+        const x0 = Math.max(0, Math.floor(minX - marginX));
+        const y0 = Math.max(0, Math.floor(minY - marginY));
+        const x1 = Math.min(width, Math.ceil(maxX + marginX));
+        const y1 = Math.min(height, Math.ceil(maxY + marginY));
+
+        // Too small for ORB's border and patch to leave anything
+        const minSide = 2 * (AppConfig.orb.edgeThreshold + AppConfig.orb.patchSize);
+        if (x1 - x0 < minSide || y1 - y0 < minSide || area <= 0) return null;
+
+        const tierFeatures = this.state?.maxFeatures || AppConfig.orb.nfeatures;
+        const share = ((x1 - x0) * (y1 - y0)) / (width * height);
+        const maxFeatures = Math.min(tierFeatures,
+            Math.max(AppConfig.detection.roiMinFeatures, Math.round(tierFeatures * share)));
+
+        const tierLevels = this.state?.pyramidLevels || AppConfig.orb.nlevels;
+        const scale = Math.sqrt(area / (referenceData.image.cols * referenceData.image.rows));
+        const usefulLevels = Math.ceil(AppConfig.orb.nlevels +
+            Math.log(scale) / Math.log(AppConfig.orb.scaleFactor)) + 1;
+        const pyramidLevels = Math.max(1, Math.min(tierLevels, usefulLevels));
+
+        return {
+            rect: new cv.Rect(x0, y0, x1 - x0, y1 - y0),
+            maxFeatures,
+            pyramidLevels,
+            scratch: 'detect_roi'
+        };
+    }
+
     /**
      * Match pre-extracted frame features against a target
+     * @param {Object} frameFeatures - From extractFrameFeatures
+     * @param {Object} referenceData - Target keypoints / descriptors / image
+     * @param {Object} matchSet - BatchedMatcher result holding this target, or
+     *   null to match the target on its own
+     * @param {number} index - Target's index in matchSet
      */
-    matchTarget(frameFeatures, referenceData) {
-        if (!referenceData || !referenceData.keypoints || !referenceData.descriptors) {
+    matchTarget(frameFeatures, referenceData, matchSet = null, index = 0) {
+        if (!referenceData || !referenceData.count) {
             return { success: false, reason: 'Reference data not available' };
         }
 
@@ -353,7 +521,7 @@ class FeatureDetector {
             success: false,
             reason: null,
             corners: null,
-            keypoints: frameFeatures.keypointPoints,
+            keypoints: frameFeatures.points, // Flat [x0, y0, ...]
             matchKeypoints: [],
             goodMatchKeypoints: [],
             matchesCount: 0,
@@ -362,9 +530,6 @@ class FeatureDetector {
             homography: null
         };
 
-        let matcher = null;
-        let matches = null;
-        let goodMatches = null;
         let homography = null;
         let refPointsMat = null;
         let framePointsMat = null;
@@ -372,205 +537,140 @@ class FeatureDetector {
         let transformedCorners = null;
 
         try {
-            if (frameFeatures.keypoints.size() <= 10 ||
-                referenceData.keypoints.size() <= 10 ||
-                !frameFeatures.descriptors || frameFeatures.descriptors.empty() ||
-                !referenceData.descriptors || referenceData.descriptors.empty() ||
-                frameFeatures.descriptors.rows <= 0 || referenceData.descriptors.rows <= 0 ||
-                frameFeatures.descriptors.cols !== referenceData.descriptors.cols) {
-
-                console.log('[FeatureDetector] ❌ PRE-MATCH CHECK FAILED:', {
-                    frameKeypoints: frameFeatures.keypoints.size(),
-                    refKeypoints: referenceData.keypoints.size(),
-                    frameDescriptors: frameFeatures.descriptors ? frameFeatures.descriptors.rows : 0,
-                    refDescriptors: referenceData.descriptors ? referenceData.descriptors.rows : 0,
-                    frameDescCols: frameFeatures.descriptors ? frameFeatures.descriptors.cols : 0,
-                    refDescCols: referenceData.descriptors ? referenceData.descriptors.cols : 0
-                });
+            if (index < 0 || !BatchedMatcher.canMatch(frameFeatures, referenceData)) {
+                if (Logger.debugEnabled) {
+                    Logger.debug('[FeatureDetector] ❌ PRE-MATCH CHECK FAILED:', {
+                        frameKeypoints: frameFeatures.keypoints.size(),
+                        refKeypoints: referenceData.count,
+                        frameDescriptors: frameFeatures.descriptors ? frameFeatures.descriptors.rows : 0,
+                        refDescriptors: referenceData.count,
+                        frameDescCols: frameFeatures.descriptors ? frameFeatures.descriptors.cols : 0,
+                        refDescCols: referenceData.descriptorSize
+                    });
+                }
                 result.reason = 'Insufficient keypoints or descriptor mismatch';
                 return result;
             }
 
-            // Reuse the shared matcher instead of creating a new one
-            matcher = this.matcher;
+            if (!matchSet) {
+                matchSet = this.singleMatcher.match(
+                    frameFeatures.descriptors,
+                    [referenceData],
+                    AppConfig.detection.ratioThreshold
+                );
+                index = 0;
+            }
 
-            let knnMatches = new cv.DMatchVectorVector();
+            const { frameIndex, refIndex, distance, good } = matchSet;
+            const start = matchSet.offsets[index];
+            const end = matchSet.offsets[index + 1];
+            const framePts = frameFeatures.points;
+            const frameCount = framePts.length / 2;
 
             const matchPoints = [];
             const goodMatchPoints = [];
+            let matchesCount = 0;
+
+            for (let i = start; i < end; i++) {
+                const f = frameIndex[i];
+                if (f < 0) continue;
+                matchesCount++;
+                if (f >= frameCount || Number.isNaN(framePts[f * 2])) continue;
+                const point = { x: framePts[f * 2], y: framePts[f * 2 + 1] };
+                matchPoints.push(point);
+                if (good[i]) goodMatchPoints.push(point);
+            }
 
-            try {
-                this.profiler?.startTimer('detect_knn_match');
-                matcher.knnMatch(referenceData.descriptors, frameFeatures.descriptors, knnMatches, 2);
-                this.profiler?.endTimer('detect_knn_match');
-
-                this.profiler?.startTimer('detect_filter_matches');
-                matches = new cv.DMatchVector();
-                goodMatches = new cv.DMatchVector();
-
-                const ratioThreshold = AppConfig.detection.ratioThreshold;
-
-                for (let i = 0; i < knnMatches.size(); i++) {
-                    try {
-                        const matchPair = knnMatches.get(i);
-                        if (!matchPair || matchPair.size() < 1) continue;
-
-                        const firstMatch = matchPair.get(0);
-                        if (firstMatch) {
-                            matches.push_back(firstMatch);
-                            this.pushMatchPoint(frameFeatures.keypoints, firstMatch.trainIdx, matchPoints);
-                        }
-
-                        if (matchPair.size() >= 2) {
-                            const secondMatch = matchPair.get(1);
-                            if (this.passesRatio(firstMatch, secondMatch, ratioThreshold)) {
-                                goodMatches.push_back(firstMatch);
-                                this.pushMatchPoint(frameFeatures.keypoints, firstMatch.trainIdx, goodMatchPoints);
-                            }
-                        }
-                    } catch (err) {
-                        // Skip problematic match entries
-                    }
-                }
-                this.profiler?.endTimer('detect_filter_matches');
-
-                // Log match statistics
-                console.log('[FeatureDetector] 📊 MATCH STATISTICS:', {
-                    totalMatches: matches.size(),
-                    goodMatches: goodMatches.size(),
-                    ratioTestPassRate: matches.size() > 0
-                        ? `${((goodMatches.size() / matches.size()) * 100).toFixed(1)}%`
+            if (Logger.debugEnabled) {
+                Logger.debug('[FeatureDetector] 📊 MATCH STATISTICS:', {
+                    totalMatches: matchesCount,
+                    goodMatches: matchSet.goodCounts[index],
+                    ratioTestPassRate: matchesCount > 0
+                        ? `${((matchSet.goodCounts[index] / matchesCount) * 100).toFixed(1)}%`
                         : '0%',
-                    ratioThreshold: ratioThreshold
+                    ratioThreshold: AppConfig.detection.ratioThreshold
                 });
 
                 // Calculate distance statistics for good matches
-                if (goodMatches.size() > 0) {
-                    const distances = [];
-                    for (let i = 0; i < goodMatches.size(); i++) {
-                        const match = goodMatches.get(i);
-                        if (match && Number.isFinite(match.distance)) {
-                            distances.push(match.distance);
-                        }
-                    }
-
-                    if (distances.length > 0) {
-                        distances.sort((a, b) => a - b);
-                        const minDist = distances[0];
-                        const maxDist = distances[distances.length - 1];
-                        const avgDist = distances.reduce((a, b) => a + b, 0) / distances.length;
-                        const medianDist = distances[Math.floor(distances.length / 2)];
-
-                        console.log('[FeatureDetector] 📏 DISTANCE STATS:', {
-                            min: minDist.toFixed(2),
-                            max: maxDist.toFixed(2),
-                            avg: avgDist.toFixed(2),
-                            median: medianDist.toFixed(2)
-                        });
-                    }
+                const distances = [];
+                for (let i = start; i < end; i++) {
+                    if (good[i] && Number.isFinite(distance[i])) distances.push(distance[i]);
                 }
 
-                knnMatches.delete();
-            } catch (error) {
-                console.error('[FeatureDetector] ❌ ERROR in KNN matching:', error);
-
-                matches = new cv.DMatchVector();
-                matcher.match(referenceData.descriptors, frameFeatures.descriptors, matches);
-
-                goodMatches = new cv.DMatchVector();
-                if (matches.size() > 0) {
-                    const distances = [];
-                    for (let i = 0; i < matches.size(); i++) {
-                        try {
-                            const match = matches.get(i);
-                            if (match && Number.isFinite(match.distance)) {
-                                distances.push(match.distance);
-                            }
-                        } catch (err) {}
-                    }
-
-                    if (distances.length > 0) {
-                        distances.sort((a, b) => a - b);
-                        const threshold = Math.min(100, AppConfig.detection.distanceThresholdMultiplier * distances[0]);
-
-                        for (let i = 0; i < matches.size(); i++) {
-                            try {
-                                const match = matches.get(i);
-                                if (match && Number.isFinite(match.distance) && match.distance <= threshold) {
-                                    goodMatches.push_back(match);
-                                    this.pushMatchPoint(frameFeatures.keypoints, match.trainIdx, goodMatchPoints);
-                                } else if (match) {
-                                    this.pushMatchPoint(frameFeatures.keypoints, match.trainIdx, matchPoints);
-                                }
-                            } catch (err) {}
-                        }
-                    }
+                if (distances.length > 0) {
+                    distances.sort((a, b) => a - b);
+                    Logger.debug('[FeatureDetector] 📏 DISTANCE STATS:', {
+                        min: distances[0].toFixed(2),
+                        max: distances[distances.length - 1].toFixed(2),
+                        avg: (distances.reduce((a, b) => a + b, 0) / distances.length).toFixed(2),
+                        median: distances[Math.floor(distances.length / 2)].toFixed(2)
+                    });
                 }
             }
 
             result.matchKeypoints = matchPoints;
             result.goodMatchKeypoints = goodMatchPoints;
-            result.matchesCount = matches ? matches.size() : 0;
-            result.goodMatchesCount = goodMatches ? goodMatches.size() : 0;
-
-            console.log('[FeatureDetector] 🎯 MATCH COUNTS:', {
-                totalMatches: result.matchesCount,
-                goodMatches: result.goodMatchesCount,
-                minRequiredForHomography: AppConfig.detection.minMatchesForHomography
-            });
-
-            if (goodMatches && goodMatches.size() >= AppConfig.detection.minMatchesForHomography) {
-                this.profiler?.startTimer('detect_homography');
-                const referencePoints = [];
-                const framePoints = [];
-
-                for (let i = 0; i < goodMatches.size(); i++) {
-                    try {
-                        const match = goodMatches.get(i);
-                        if (!match) continue;
-
-                        const refIndex = match.queryIdx;
-                        const frameIndex = match.trainIdx;
-
-                        if (refIndex < 0 || refIndex >= referenceData.keypoints.size()) continue;
-                        if (frameIndex < 0 || frameIndex >= frameFeatures.keypoints.size()) continue;
-
-                        const refKeypoint = referenceData.keypoints.get(refIndex);
-                        const frameKeypoint = frameFeatures.keypoints.get(frameIndex);
-
-                        if (!refKeypoint?.pt || !frameKeypoint?.pt) continue;
-
-                        const { x: rx, y: ry } = refKeypoint.pt;
-                        const { x: fx, y: fy } = frameKeypoint.pt;
+            result.matchesCount = matchesCount;
+            result.goodMatchesCount = matchSet.goodCounts[index];
+
+            if (Logger.debugEnabled) {
+                Logger.debug('[FeatureDetector] 🎯 MATCH COUNTS:', {
+                    totalMatches: result.matchesCount,
+                    goodMatches: result.goodMatchesCount,
+                    minRequiredForHomography: AppConfig.detection.minMatchesForHomography
+                });
+            }
 
-                        if (!Number.isFinite(rx) || !Number.isFinite(ry) ||
-                            !Number.isFinite(fx) || !Number.isFinite(fy)) {
-                            continue;
-                        }
+            if (result.goodMatchesCount >= AppConfig.detection.minMatchesForHomography) {
+                this.profiler?.startTimer(PerformanceProfiler.Span.DETECT_HOMOGRAPHY);
+                const refPts = referenceData.points;
+                const refCount = refPts.length / 2;
+                const referencePoints = new Float32Array(result.goodMatchesCount * 2);
+                const framePoints = new Float32Array(result.goodMatchesCount * 2);
+                let pairs = 0;
+
+                for (let i = start; i < end; i++) {
+                    if (!good[i]) continue;
+
+                    const r = refIndex[i];
+                    const f = frameIndex[i];
+                    if (r < 0 || r >= refCount || f < 0 || f >= frameCount) continue;
+
+                    const rx = refPts[r * 2];
+                    const ry = refPts[r * 2 + 1];
+                    const fx = framePts[f * 2];
+                    const fy = framePts[f * 2 + 1];
+                    if (!Number.isFinite(rx) || !Number.isFinite(ry) ||
+                        !Number.isFinite(fx) || !Number.isFinite(fy)) {
+                        continue;
+                    }
 
-                        referencePoints.push(rx, ry);
-                        framePoints.push(fx, fy);
-                    } catch (err) {}
+                    referencePoints[pairs * 2] = rx;
+                    referencePoints[pairs * 2 + 1] = ry;
+                    framePoints[pairs * 2] = fx;
+                    framePoints[pairs * 2 + 1] = fy;
+                    pairs++;
                 }
 
-                if (referencePoints.length >= 16 && framePoints.length >= 16) {
-                    const numPointPairs = referencePoints.length / 2;
-                    console.log('[FeatureDetector] 🔷 HOMOGRAPHY INPUT:', {
-                        pointPairs: numPointPairs,
-                        refPoints: referencePoints.length / 2,
-                        framePoints: framePoints.length / 2
-                    });
+                if (pairs >= 8) {
+                    if (Logger.debugEnabled) {
+                        Logger.debug('[FeatureDetector] 🔷 HOMOGRAPHY INPUT:', { pointPairs: pairs });
+                    }
 
-                    refPointsMat = cv.matFromArray(referencePoints.length / 2, 1, cv.CV_32FC2, referencePoints);
-                    framePointsMat = cv.matFromArray(framePoints.length / 2, 1, cv.CV_32FC2, framePoints);
+                    refPointsMat = new cv.Mat(pairs, 1, cv.CV_32FC2);
+                    refPointsMat.data32F.set(referencePoints.subarray(0, pairs * 2));
+                    framePointsMat = new cv.Mat(pairs, 1, cv.CV_32FC2);
+                    framePointsMat.data32F.set(framePoints.subarray(0, pairs * 2));
 
                     homography = cv.findHomography(refPointsMat, framePointsMat, cv.RANSAC, 4.0);
 
                     if (homography && !homography.empty()) {
-                        console.log('[FeatureDetector] ✅ HOMOGRAPHY COMPUTED:', {
-                            matrixSize: `${homography.rows}x${homography.cols}`,
-                            isEmpty: homography.empty()
-                        });
+                        if (Logger.debugEnabled) {
+                            Logger.debug('[FeatureDetector] ✅ HOMOGRAPHY COMPUTED:', {
+                                matrixSize: `${homography.rows}x${homography.cols}`,
+                                isEmpty: homography.empty()
+                            });
+                        }
                         cornerPoints = new cv.Mat(4, 1, cv.CV_32FC2);
 
                         if (cornerPoints.data32F && cornerPoints.data32F.length >= 8) {
@@ -590,65 +690,67 @@ class FeatureDetector {
 
                             const corners = this.extractCorners(transformedCorners);
                             if (corners) {
-                                console.log('[FeatureDetector] ✅ CORNERS EXTRACTED:', {
-                                    topLeft: `(${corners[0].x.toFixed(1)}, ${corners[0].y.toFixed(1)})`,
-                                    topRight: `(${corners[1].x.toFixed(1)}, ${corners[1].y.toFixed(1)})`,
-                                    bottomRight: `(${corners[2].x.toFixed(1)}, ${corners[2].y.toFixed(1)})`,
-                                    bottomLeft: `(${corners[3].x.toFixed(1)}, ${corners[3].y.toFixed(1)})`
-                                });
+                                if (Logger.debugEnabled) {
+                                    Logger.debug('[FeatureDetector] ✅ CORNERS EXTRACTED:', {
+                                        topLeft: `(${corners[0].x.toFixed(1)}, ${corners[0].y.toFixed(1)})`,
+                                        topRight: `(${corners[1].x.toFixed(1)}, ${corners[1].y.toFixed(1)})`,
+                                        bottomRight: `(${corners[2].x.toFixed(1)}, ${corners[2].y.toFixed(1)})`,
+                                        bottomLeft: `(${corners[3].x.toFixed(1)}, ${corners[3].y.toFixed(1)})`
+                                    });
+                                }
                                 result.corners = corners;
                                 result.success = true;
                                 result.homography = homography;
                             } else {
-                                console.log('[FeatureDetector] ❌ CORNER EXTRACTION FAILED: Invalid corner coordinates');
+                                Logger.debug('[FeatureDetector] ❌ CORNER EXTRACTION FAILED: Invalid corner coordinates');
                             }
                         }
                     } else {
-                        console.log('[FeatureDetector] ❌ HOMOGRAPHY FAILED: Empty or invalid matrix');
+                        Logger.debug('[FeatureDetector] ❌ HOMOGRAPHY FAILED: Empty or invalid matrix');
                     }
                 } else {
-                    console.log('[FeatureDetector] ❌ HOMOGRAPHY SKIPPED:', {
-                        reason: 'Insufficient point pairs',
-                        refPoints: referencePoints.length / 2,
-                        framePoints: framePoints.length / 2,
-                        minRequired: 8
-                    });
+                    if (Logger.debugEnabled) {
+                        Logger.debug('[FeatureDetector] ❌ HOMOGRAPHY SKIPPED:', {
+                            reason: 'Insufficient point pairs',
+                            pointPairs: pairs,
+                            minRequired: 8
+                        });
+                    }
                 }
-                this.profiler?.endTimer('detect_homography');
+                this.profiler?.endTimer(PerformanceProfiler.Span.DETECT_HOMOGRAPHY);
             } else {
-                console.log('[FeatureDetector] ⚠️  HOMOGRAPHY SKIPPED:', {
-                    reason: 'Insufficient good matches',
-                    goodMatches: goodMatches ? goodMatches.size() : 0,
-                    minRequired: 12
-                });
+                if (Logger.debugEnabled) {
+                    Logger.debug('[FeatureDetector] ⚠️  HOMOGRAPHY SKIPPED:', {
+                        reason: 'Insufficient good matches',
+                        goodMatches: result.goodMatchesCount,
+                        minRequired: AppConfig.detection.minMatchesForHomography
+                    });
+                }
             }
 
-            if (referenceData.keypoints.size() > 0) {
-                result.score = result.goodMatchesCount / referenceData.keypoints.size();
-            }
+            result.score = result.goodMatchesCount / referenceData.count;
 
             if (!result.success) {
                 result.reason = result.reason || 'Insufficient matches';
             }
 
             // Log final detection result summary
-            console.log(`[FeatureDetector] ${result.success ? '✅ DETECTION SUCCESS' : '❌ DETECTION FAILED'}:`, {
-                success: result.success,
-                totalMatches: result.matchesCount,
-                goodMatches: result.goodMatchesCount,
-                score: result.score ? result.score.toFixed(3) : '0.000',
-                hasCorners: !!result.corners,
-                reason: result.reason || 'Success'
-            });
+            if (Logger.debugEnabled) {
+                Logger.debug(`[FeatureDetector] ${result.success ? '✅ DETECTION SUCCESS' : '❌ DETECTION FAILED'}:`, {
+                    success: result.success,
+                    totalMatches: result.matchesCount,
+                    goodMatches: result.goodMatchesCount,
+                    score: result.score ? result.score.toFixed(3) : '0.000',
+                    hasCorners: !!result.corners,
+                    reason: result.reason || 'Success'
+                });
+            }
 
             return result;
         } catch (error) {
             console.error('Error matching target:', error);
             return { success: false, reason: error.message };
         } finally {
-            // Don't delete matcher - it's shared across all targets
-            if (matches) matches.delete();
-            if (goodMatches) goodMatches.delete();
             if (homography) homography.delete();
             if (refPointsMat) refPointsMat.delete();
             if (framePointsMat) framePointsMat.delete();
@@ -657,34 +759,91 @@ class FeatureDetector {
         }
     }
 
-    keypointsToPoints(vector) {
-        if (!vector) return [];
-        const points = [];
-        for (let i = 0; i < vector.size(); i++) {
-            try {
-                const kp = vector.get(i);
-                if (kp?.pt && Number.isFinite(kp.pt.x) && Number.isFinite(kp.pt.y)) {
-                    points.push({ x: kp.pt.x, y: kp.pt.y });
-                }
-            } catch (err) {}
+    /**
+     * Keep `count` keypoints spread over a grid x grid layout: every cell keeps
+     * its strongest up to an equal share, the rest of the budget goes to the
+     * strongest leftovers. Ordering uses native Float64Array sorts of packed
+     * (cell, inverted response, index) keys, not a JS comparator.
+     * @param {cv.KeyPointVector} vector - Detected keypoints (deleted when replaced)
+     * @returns {cv.KeyPointVector} Retained keypoints in detection order
+     */
+    retainGrid(vector, count, grid, width, height) {
+        const size = vector.size();
+        const INDEX = 0x20000; // 17 index bits
+        const RESPONSE = 0x1000000; // 24 response bits
+        if (size > INDEX) return vector;
+
+        const keypoints = new Array(size);
+        let maxResponse = 0;
+        for (let i = 0; i < size; i++) {
+            const kp = vector.get(i);
+            keypoints[i] = kp;
+            if (kp.response > maxResponse) maxResponse = kp.response;
         }
-        return points;
-    }
 
-    passesRatio(first, second, ratio) {
-        if (!first || !second) return false;
-        if (!Number.isFinite(first.distance) || !Number.isFinite(second.distance)) return false;
-        return first.distance < ratio * second.distance;
+        const scale = maxResponse > 0 ? (RESPONSE - 1) / maxResponse : 0;
+        const cellW = width / grid;
+        const cellH = height / grid;
+        const keys = new Float64Array(size);
+        for (let i = 0; i < size; i++) {
+            const kp = keypoints[i];
+            const cellX = Math.min(grid - 1, Math.max(0, Math.floor(kp.pt.x / cellW)));
+            const cellY = Math.min(grid - 1, Math.max(0, Math.floor(kp.pt.y / cellH)));
+            const inverted = RESPONSE - 1 - Math.round(Math.max(0, kp.response) * scale);
+            keys[i] = ((cellY * grid + cellX) * RESPONSE + inverted) * INDEX + i;
+        }
+        keys.sort();
+
+        const quota = Math.floor(count / (grid * grid));
+        const selected = new Uint8Array(size);
+        const leftovers = new Float64Array(size);
+        let leftoverCount = 0;
+        let kept = 0;
+        let cell = -1;
+        let inCell = 0;
+        for (let k = 0; k < size; k++) {
+            const key = keys[k];
+            const keyCell = Math.floor(key / (RESPONSE * INDEX));
+            if (keyCell !== cell) {
+                cell = keyCell;
+                inCell = 0;
+            }
+            if (inCell < quota) {
+                selected[key % INDEX] = 1;
+                inCell++;
+                kept++;
+            } else {
+                leftovers[leftoverCount++] = key % (RESPONSE * INDEX); // Drop the cell
+            }
+        }
+
+        const rest = leftovers.subarray(0, leftoverCount).sort();
+        for (let k = 0; k < rest.length && kept < count; k++) {
+            selected[rest[k] % INDEX] = 1;
+            kept++;
+        }
+
+        const retained = new cv.KeyPointVector();
+        for (let i = 0; i < size; i++) {
+            if (selected[i]) retained.push_back(keypoints[i]);
+        }
+        vector.delete();
+        return retained;
     }
 
-    pushMatchPoint(frameKeypoints, index, bucket) {
-        try {
-            if (!frameKeypoints || index < 0 || index >= frameKeypoints.size()) return;
-            const kp = frameKeypoints.get(index);
-            if (kp?.pt && Number.isFinite(kp.pt.x) && Number.isFinite(kp.pt.y)) {
-                bucket.push({ x: kp.pt.x, y: kp.pt.y });
-            }
-        } catch (err) {}
+    /**
+     * Keypoint coordinates as flat [x0, y0, x1, y1, ...] (NaN where invalid)
+     */
+    pointArray(vector) {
+        const count = vector ? vector.size() : 0;
+        const points = new Float32Array(count * 2);
+        for (let i = 0; i < count; i++) {
+            const kp = vector.get(i);
+            const valid = kp?.pt && Number.isFinite(kp.pt.x) && Number.isFinite(kp.pt.y);
+            points[i * 2] = valid ? kp.pt.x : NaN;
+            points[i * 2 + 1] = valid ? kp.pt.y : NaN;
+        }
+        return points;
     }
 
     extractCorners(transformedCorners) {
@@ -716,6 +875,14 @@ class FeatureDetector {
             this.descriptor.delete();
             this.descriptor = null;
         }
+        if (this.batchedMatcher) {
+            this.batchedMatcher.release();
+            this.batchedMatcher = null;
+        }
+        if (this.singleMatcher) {
+            this.singleMatcher.release();
+            this.singleMatcher = null;
+        }
         if (this.matcher) {
             this.matcher.delete();
             this.matcher = null;
@@ -0,0 +1,146 @@
+/**
+ * ReferenceCache - Target reference data kept as typed arrays, with the
+ * descriptor Mats the matcher needs materialized on demand
+ *
+ * Every target holds its descriptors as one Uint8Array and its keypoints as
+ * flat [x0, y0, ...] coordinates in the JS heap. The cv.Mat is created the
+ * first time a detection asks for it (a vocabulary candidate, the tracked
+ * target) and kept in an LRU bounded by AppConfig.reference.residentBudgetMB
+ * of WASM heap. Eviction only happens in trim(), which callers run between
+ * frames, so Mats handed out during a detection stay valid until it ends.
+ */
+class ReferenceCache {
+  /**
+   * @param {number} budgetBytes - WASM heap for resident descriptor Mats
+   */
+  constructor(budgetBytes = ReferenceCache.defaultBudget()) {
+    this.budgetBytes = budgetBytes;
+    this.resident = new Map(); // ReferenceData -> bytes, oldest first
+    this.residentBytes = 0;
+
+    this.stats = {
+      hits: 0,
+      misses: 0,
+      evictions: 0
+    };
+  }
+
+  static defaultBudget() {
+    return (AppConfig.reference?.residentBudgetMB ?? 8) * 1024 * 1024;
+  }
+
+  /**
+   * Compact reference data for one target
+   * @param {ArrayLike<number>} descriptors - Flat descriptor bytes
+   * @param {number} descriptorSize - Bytes per descriptor
+   * @param {ArrayLike<number>} points - Flat keypoint coordinates
+   * @param {Object} image - {cols, rows} of the reference image
+   * @returns {ReferenceData}
+   */
+  create(descriptors, descriptorSize, points, image) {
+    // Typed arrays from the database are kept as they are, not copied
+    return new ReferenceData(
+      this,
+      descriptors instanceof Uint8Array ? descriptors : Uint8Array.from(descriptors),
+      descriptorSize,
+      points instanceof Float32Array ? points : Float32Array.from(points),
+      image
+    );
+  }
+
+  /**
+   * Descriptor Mat of a target, materialized if it is not resident
+   * @param {ReferenceData} reference
+   * @returns {cv.Mat}
+   */
+  descriptorsOf(reference) {
+    if (reference.mat) {
+      this.stats.hits++;
+      // Re-inserted as most recent
+      this.resident.delete(reference);
+      this.resident.set(reference, reference.bytes.length);
+      return reference.mat;
+    }
+
+    this.stats.misses++;
+    const rows = reference.count;
+    const mat = new cv.Mat(rows, rows > 0 ? reference.descriptorSize : 0, cv.CV_8U);
+    if (rows > 0) mat.data.set(reference.bytes);
+
+    reference.mat = mat;
+    this.resident.set(reference, reference.bytes.length);
+    this.residentBytes += reference.bytes.length;
+    return mat;
+  }
+
+  /**
+   * Evict least recently used Mats until the resident set fits the budget
+   */
+  trim() {
+    for (const reference of this.resident.keys()) {
+      if (this.residentBytes <= this.budgetBytes) break;
+      this.evict(reference);
+      this.stats.evictions++;
+    }
+  }
+
+  /**
+   * Free a target's Mat; its typed arrays stay for the next materialization
+   * @param {ReferenceData} reference
+   */
+  evict(reference) {
+    if (!this.resident.has(reference)) return;
+
+    this.resident.delete(reference);
+    this.residentBytes -= reference.bytes.length;
+    reference.mat.delete();
+    reference.mat = null;
+  }
+
+  clear() {
+    for (const reference of Array.from(this.resident.keys())) {
+      this.evict(reference);
+    }
+  }
+
+  getStats() {
+    const lookups = this.stats.hits + this.stats.misses;
+    return {
+      ...this.stats,
+      hitRate: lookups > 0 ? this.stats.hits / lookups : 0,
+      resident: this.resident.size,
+      residentMB: this.residentBytes / 1048576,
+      budgetMB: this.budgetBytes / 1048576
+    };
+  }
+}
+
+/**
+ * One target's reference data: `descriptors` materializes through the cache,
+ * `points` and `count` never touch the WASM heap
+ */
+class ReferenceData {
+  constructor(cache, bytes, descriptorSize, points, image) {
+    this.cache = cache;
+    this.bytes = bytes;
+    this.descriptorSize = descriptorSize;
+    this.count = descriptorSize > 0 ? bytes.length / descriptorSize : 0;
+    this.points = points; // Flat coordinates for the matcher
+    this.image = image; // Dimensions for the corner calculation
+    this.mat = null;
+  }
+
+  get descriptors() {
+    return this.cache.descriptorsOf(this);
+  }
+
+  release() {
+    this.cache.evict(this);
+  }
+}
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.ReferenceCache = ReferenceCache;
+  window.ReferenceData = ReferenceData;
+}
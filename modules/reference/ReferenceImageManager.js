@@ -4,7 +4,8 @@
  */
 class ReferenceImageManager {
     constructor(uiManager = null) {
-        this.ui = document.getElementById('statusMessage');
+        // No DOM inside the vision worker
+        this.ui = typeof document !== 'undefined' ? document.getElementById('statusMessage') : null;
         this.uiManager = uiManager || null;
         this.targets = new Map();
         this.targetOrder = [];
@@ -12,6 +13,9 @@ class ReferenceImageManager {
         this.nextId = 1;
         this.zipLoader = null;
         this.usingZipAlbum = false;
+
+        // Descriptor Mats are materialized only for targets detection asks for
+        this.referenceCache = new ReferenceCache();
     }
 
     onChange(listener) {
@@ -98,8 +102,9 @@ class ReferenceImageManager {
             let albumSource = source;
 
             // If no source provided, try to get from URL parameter
+            let albumManager = null;
             if (!albumSource) {
-                const albumManager = new AlbumManager();
+                albumManager = new AlbumManager();
 
                 // Check if there's an album code in the URL
                 const albumCode = albumManager.getAlbumCodeFromURL();
@@ -125,7 +130,7 @@ class ReferenceImageManager {
                             }
                             this.updateStatus(msg);
                         }
-                    });
+                    }, { streaming: AppConfig.album.streaming });
 
                     albumSource = albumBlob;
                     console.log('Album downloaded successfully');
@@ -165,15 +170,20 @@ class ReferenceImageManager {
             // Load and build database from zip
             const database = await this.zipLoader.loadFromZip(albumSource);
 
-            console.log(`Loading ${database.targets.length} targets from album...`);
-
-            // Convert database format to runtime targets
-            for (const targetData of database.targets) {
-                const target = this._convertToRuntimeTarget(targetData, database);
-                this.targets.set(target.id, target);
-                this.targetOrder.push(target.id);
-
-                console.log(`Loaded target: ${target.id} (${target.numFeatures} features)`);
+            this.loadFromDatabase(database);
+
+            // Keep the album for the next visit: its extracted files where the
+            // album cache exists, else the whole zip (streamed ones fetched again)
+            const streamed = typeof albumSource === 'string';
+            const fromCache = typeof CachedAlbum !== 'undefined' && albumSource instanceof CachedAlbum;
+            if (albumManager && !fromCache && (!streamed || AppConfig.album.cacheInBackground)) {
+                albumManager.cacheAlbumContents(this.albumCode, this.zipLoader).then(cached => {
+                    if (!cached && streamed) {
+                        albumManager.cacheAlbumInBackground(this.albumCode, albumSource);
+                    }
+                });
+            } else {
+                this.zipLoader.takeCacheableEntries(); // Frees the zip they read from
             }
 
             this.usingZipAlbum = true;
@@ -192,35 +202,33 @@ class ReferenceImageManager {
     }
 
     /**
-     * Convert database format to runtime target format
+     * Register runtime targets from an exported database
+     * Shared by the zip loader and the vision worker
+     * @param {Object} database - Database in VocabularyBuilder export format
+     *   (flat descriptor / keypoint typed arrays)
+     * @returns {Array} Runtime targets
      */
-    _convertToRuntimeTarget(targetData, database) {
-        // Convert keypoints to KeyPointVector
-        const keypoints = new cv.KeyPointVector();
-        for (const [x, y] of targetData.keypoints) {
-            // OpenCV.js doesn't expose KeyPoint constructor, create object manually
-            const kp = {
-                pt: { x, y },
-                size: 7,
-                angle: -1,
-                response: 0,
-                octave: 0,
-                class_id: -1
-            };
-            keypoints.push_back(kp);
-        }
+    loadFromDatabase(database) {
+        console.log(`Loading ${database.targets.length} targets from album...`);
 
-        // Convert descriptors to cv.Mat
-        const descriptorSize = database.metadata.descriptor_bytes;
-        const numDescriptors = targetData.descriptors.length;
-        const descriptors = new cv.Mat(numDescriptors, descriptorSize, cv.CV_8U);
+        // Convert database format to runtime targets
+        for (const targetData of database.targets) {
+            const target = this._convertToRuntimeTarget(targetData, database);
+            this.targets.set(target.id, target);
+            this.targetOrder.push(target.id);
 
-        for (let i = 0; i < numDescriptors; i++) {
-            for (let j = 0; j < descriptorSize; j++) {
-                descriptors.ucharPtr(i, j)[0] = targetData.descriptors[i][j];
-            }
+            console.log(`Loaded target: ${target.id} (${target.numFeatures} features)`);
         }
 
+        return this.getTargets();
+    }
+
+    /**
+     * Convert database format to runtime target format
+     * Keypoints ([x0, y0, x1, y1, ...]) and descriptor bytes stay typed arrays;
+     * the matcher's Mat is created by the reference cache on first use
+     */
+    _convertToRuntimeTarget(targetData, database) {
         // Create a mock image object with dimensions (needed for corner calculation)
         const imageMeta = targetData.image_meta || { width: 640, height: 480 };
         const mockImage = {
@@ -233,13 +241,15 @@ class ReferenceImageManager {
             filename: targetData.filename,
             numFeatures: targetData.num_features,
             videoUrl: targetData.videoUrl,
+            videoDeferred: !!targetData.videoDeferred,
             bow: targetData.bow,
             bow_tfidf: targetData.bow_tfidf,
-            referenceData: {
-                keypoints,
-                descriptors,
-                image: mockImage  // Add mock image with dimensions
-            },
+            referenceData: this.referenceCache.create(
+                targetData.descriptors,
+                database.metadata.descriptor_bytes,
+                targetData.keypoints,
+                mockImage
+            ),
             runtime: {
                 status: 'idle',
                 lastSeen: null,
@@ -260,6 +270,35 @@ class ReferenceImageManager {
     }
 
 
+    /**
+     * Load a target's deferred video (streamed album) on first use
+     * @param {string} id - Target id
+     * @returns {Promise<string|null>} Video URL
+     */
+    requestVideo(id) {
+        const target = this.targets.get(id);
+        if (!target || target.videoUrl || !target.videoDeferred || !this.zipLoader) {
+            return Promise.resolve(target ? target.videoUrl || null : null);
+        }
+
+        // Called every frame while the target is selected - share one request
+        if (!target.videoRequest) {
+            target.videoRequest = this.zipLoader.resolveVideoUrl(id)
+                .then(videoUrl => {
+                    // Still deferred on failure or backoff, so a later call retries
+                    if (videoUrl) {
+                        target.videoUrl = videoUrl;
+                        target.videoDeferred = false;
+                    }
+                    return videoUrl;
+                })
+                .finally(() => {
+                    target.videoRequest = null;
+                });
+        }
+        return target.videoRequest;
+    }
+
     updateTargetRuntime(id, updates = {}) {
         const target = this.targets.get(id);
         if (!target) return;
@@ -292,6 +331,7 @@ class ReferenceImageManager {
         }
         this.targets.clear();
         this.targetOrder = [];
+        this.referenceCache.clear();
 
         // Clean up zip loader resources
         if (this.zipLoader) {
@@ -305,18 +345,22 @@ class ReferenceImageManager {
     cleanupTargetResources(target) {
         if (!target || !target.referenceData) return;
 
-        const { keypoints, descriptors, image } = target.referenceData;
-
-        // Clean up OpenCV objects
+        // Frees the descriptor Mat if it is resident
         try {
-            if (keypoints && keypoints.delete) keypoints.delete();
-            if (descriptors && descriptors.delete) descriptors.delete();
-            if (image && image.delete) image.delete();
+            target.referenceData.release();
         } catch (error) {
             console.warn('Error cleaning up target resources:', error);
         }
     }
 
+    /**
+     * Evict descriptor Mats beyond AppConfig.reference.residentBudgetMB,
+     * least recently matched first; run between frames
+     */
+    trimReferenceCache() {
+        this.referenceCache.trim();
+    }
+
     updateStatus(message) {
         if (this.ui) {
             this.ui.textContent = message;
@@ -3,6 +3,12 @@
  *
  * Renders both tracking rectangles and video overlays using Three.js WebGL.
  * Uses ViewportManager for centralized dimension management.
+ *
+ * Video textures are only re-uploaded when their element presents a new
+ * frame (THREE.VideoTexture uses requestVideoFrameCallback). In single-pass
+ * mode (AppConfig.rendering.singlePassComposite) the background plane's
+ * shader also draws the selected target's video, warped by the inverse
+ * homography of its four corners, so no per-target plane geometry is built.
  */
 class ARRenderer {
   constructor(canvasId, cameraVideo, viewportManager, options = {}) {
@@ -11,6 +17,9 @@ class ARRenderer {
     this.viewportManager = viewportManager;
     this.enabled = options.enabled !== false;
     this.showTrackingRects = options.showTrackingRects !== false;
+    this.singlePass = options.singlePassComposite !== undefined
+      ? options.singlePassComposite
+      : AppConfig.rendering.singlePassComposite;
 
     // Three.js components
     this.scene = null;
@@ -22,6 +31,12 @@ class ARRenderer {
     this.backgroundTexture = null;
     this.lastCameraFrame = null; // Store last camera frame for sync
 
+    // Single-pass mode: VideoTexture per overlay video element, and the
+    // video (if any) composited this frame
+    this.compositeTextures = new Map(); // HTMLVideoElement -> THREE.VideoTexture
+    this.compositeVideo = null; // {video, corners}
+    this.compositeHomography = new Float64Array(9);
+
     // Target objects: targetId -> {videoPlane, trackingLine}
     this.targetObjects = new Map();
 
@@ -96,11 +111,27 @@ class ARRenderer {
    */
   createBackgroundPlane() {
     const geometry = new THREE.PlaneGeometry(1, 1);
-    const material = new THREE.MeshBasicMaterial({
-      side: THREE.DoubleSide,
-      depthTest: false,
-      depthWrite: false
-    });
+    const material = this.singlePass
+      ? new THREE.ShaderMaterial({
+        uniforms: {
+          uCamera: { value: null },
+          uCameraReady: { value: 0 },
+          uVideo: { value: null },
+          uVideoVisible: { value: 0 },
+          uInvHomography: { value: new THREE.Matrix3() },
+          uWSign: { value: 1 }
+        },
+        vertexShader: ARRenderer.COMPOSITE_VERTEX_SHADER,
+        fragmentShader: ARRenderer.COMPOSITE_FRAGMENT_SHADER,
+        side: THREE.DoubleSide,
+        depthTest: false,
+        depthWrite: false
+      })
+      : new THREE.MeshBasicMaterial({
+        side: THREE.DoubleSide,
+        depthTest: false,
+        depthWrite: false
+      });
 
     this.backgroundPlane = new THREE.Mesh(geometry, material);
     this.backgroundPlane.position.z = -1; // Behind everything else
@@ -252,22 +283,25 @@ class ARRenderer {
         console.log('[ARRenderer] Creating VideoTexture from camera video element');
 
         this.backgroundTexture = new THREE.VideoTexture(this.cameraVideo);
-        // High-quality texture filtering for better upscaling
-        this.backgroundTexture.minFilter = THREE.LinearMipmapLinearFilter;
+        // The feed is drawn at (or above) its own resolution, so a mip chain
+        // would only be regenerated for nothing on every camera frame
+        this.backgroundTexture.minFilter = THREE.LinearFilter;
         this.backgroundTexture.magFilter = THREE.LinearFilter;
-        this.backgroundTexture.generateMipmaps = true;
-        // Enable anisotropic filtering for sharper textures at angles
-        const maxAnisotropy = this.renderer.capabilities.getMaxAnisotropy();
-        this.backgroundTexture.anisotropy = Math.min(4, maxAnisotropy);
+        this.backgroundTexture.generateMipmaps = false;
         this.backgroundTexture.flipY = false;  // Flip Y axis to correct video orientation
         this.backgroundTexture.colorSpace = THREE.SRGBColorSpace;
-        this.backgroundPlane.material.map = this.backgroundTexture;
-        this.backgroundPlane.material.needsUpdate = true;
+        if (this.singlePass) {
+          this.backgroundPlane.material.uniforms.uCamera.value = this.backgroundTexture;
+          this.backgroundPlane.material.uniforms.uCameraReady.value = 1;
+        } else {
+          this.backgroundPlane.material.map = this.backgroundTexture;
+          this.backgroundPlane.material.needsUpdate = true;
+        }
 
         // Update background plane scale with video dimensions
         this.updateBackgroundPlane();
       }
-      // VideoTexture updates automatically - no needsUpdate required!
+      // VideoTexture uploads on requestVideoFrameCallback - no needsUpdate required!
     } catch (error) {
       console.error('[ARRenderer] Error updating camera background:', error);
       console.error('[ARRenderer] Error stack:', error.stack);
@@ -301,6 +335,7 @@ class ARRenderer {
 
     // Track which targets are active
     const activeTargets = new Set();
+    this.compositeVideo = null;
 
     // Update/create objects for each tracked target
     for (const result of trackingResults) {
@@ -347,20 +382,19 @@ class ARRenderer {
         const video = this.videoManager.getVideo(result.targetId);
         if (video) {
           if (video.readyState >= 2) {
-            this.updateVideoPlane(targetObj.videoPlane, video, scaledCorners);
-            targetObj.videoPlane.visible = true;
+            this.showVideo(targetObj, video, scaledCorners);
           } else {
             // Video not ready yet - show loading state
-            targetObj.videoPlane.visible = false;
+            this.hideVideo(targetObj);
             console.warn(`[ARRenderer] ⏳ Video not ready (readyState: ${video.readyState})`);
           }
         } else {
-          targetObj.videoPlane.visible = false;
+          this.hideVideo(targetObj);
           console.warn(`[ARRenderer] ❌ No video element found for ${result.targetId}`);
         }
       } else {
         // Not selected - hide video
-        targetObj.videoPlane.visible = false;
+        this.hideVideo(targetObj);
       }
 
       // Update tracking rectangle
@@ -375,7 +409,7 @@ class ARRenderer {
     // Hide objects for non-active targets and pause videos
     for (const [targetId, targetObj] of this.targetObjects) {
       if (!activeTargets.has(targetId)) {
-        targetObj.videoPlane.visible = false;
+        this.hideVideo(targetObj);
         targetObj.trackingLine.visible = false;
         // Pause video when target is lost
         this.videoManager.pauseVideo(targetId);
@@ -390,11 +424,17 @@ class ARRenderer {
     for (const targetId of activeTargets) {
       const targetObj = this.targetObjects.get(targetId);
       if (targetObj) {
-        targetObj.videoPlane.geometry.attributes.position.needsUpdate = true;
+        if (targetObj.videoPlane) {
+          targetObj.videoPlane.geometry.attributes.position.needsUpdate = true;
+        }
         targetObj.trackingLine.geometry.attributes.position.needsUpdate = true;
       }
     }
 
+    if (this.singlePass) {
+      this.updateComposite();
+    }
+
     // Render scene
     this.renderer.render(this.scene, this.camera);
   }
@@ -405,16 +445,19 @@ class ARRenderer {
   createTargetObjects(targetId) {
     console.log('[ARRenderer] Creating objects for target:', targetId);
 
-    // Create video plane
-    const planeGeometry = new THREE.PlaneGeometry(1, 1);
-    const planeMaterial = new THREE.MeshBasicMaterial({
-      color: 0xffffff,
-      side: THREE.DoubleSide,
-      transparent: false
-    });
-    const videoPlane = new THREE.Mesh(planeGeometry, planeMaterial);
-    videoPlane.visible = false;
-    this.scene.add(videoPlane);
+    // Create video plane (single-pass mode draws video in the background pass)
+    let videoPlane = null;
+    if (!this.singlePass) {
+      const planeGeometry = new THREE.PlaneGeometry(1, 1);
+      const planeMaterial = new THREE.MeshBasicMaterial({
+        color: 0xffffff,
+        side: THREE.DoubleSide,
+        transparent: false
+      });
+      videoPlane = new THREE.Mesh(planeGeometry, planeMaterial);
+      videoPlane.visible = false;
+      this.scene.add(videoPlane);
+    }
 
     // Create tracking line
     const lineGeometry = new THREE.BufferGeometry();
@@ -428,12 +471,105 @@ class ARRenderer {
     return { videoPlane, trackingLine };
   }
 
+  /**
+   * Show a target's video at its corners this frame
+   */
+  showVideo(targetObj, video, corners) {
+    if (this.singlePass) {
+      this.compositeVideo = { video, corners };
+      return;
+    }
+    this.updateVideoPlane(targetObj.videoPlane, video, corners);
+    targetObj.videoPlane.visible = true;
+  }
+
+  hideVideo(targetObj) {
+    if (targetObj.videoPlane) {
+      targetObj.videoPlane.visible = false;
+    }
+  }
+
+  /**
+   * Point the composite shader at this frame's video and corners
+   */
+  updateComposite() {
+    const uniforms = this.backgroundPlane.material.uniforms;
+    const composite = this.compositeVideo;
+
+    if (!composite || !this.computeInverseHomography(composite.corners, this.compositeHomography)) {
+      uniforms.uVideoVisible.value = 0;
+      return;
+    }
+
+    let texture = this.compositeTextures.get(composite.video);
+    if (!texture) {
+      texture = new THREE.VideoTexture(composite.video);
+      texture.minFilter = THREE.LinearFilter;
+      texture.magFilter = THREE.LinearFilter;
+      texture.colorSpace = THREE.SRGBColorSpace;
+      this.compositeTextures.set(composite.video, texture);
+    }
+
+    const m = this.compositeHomography;
+    uniforms.uInvHomography.value.set(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8]);
+    uniforms.uVideo.value = texture;
+    uniforms.uVideoVisible.value = 1;
+
+    // Points behind the quad's horizon map to w of the other sign
+    const cx = (composite.corners[0].x + composite.corners[2].x) / 2;
+    const cy = (composite.corners[0].y + composite.corners[2].y) / 2;
+    uniforms.uWSign.value = (m[6] * cx + m[7] * cy + m[8]) >= 0 ? 1 : -1;
+  }
+
+  /**
+   * Inverse of the unit-square -> quad homography (Heckbert), i.e. the map
+   * from world coordinates to video (u, v), up to scale
+   * @param {Array<{x, y}>} corners - [TL, TR, BR, BL] in world coordinates
+   * @param {Float64Array} out - Row-major 3x3
+   * @returns {boolean} False for degenerate quads
+   */
+  computeInverseHomography(corners, out) {
+    const [p0, p1, p2, p3] = corners;
+    const dx1 = p1.x - p2.x;
+    const dx2 = p3.x - p2.x;
+    const dx3 = p0.x - p1.x + p2.x - p3.x;
+    const dy1 = p1.y - p2.y;
+    const dy2 = p3.y - p2.y;
+    const dy3 = p0.y - p1.y + p2.y - p3.y;
+
+    const den = dx1 * dy2 - dx2 * dy1;
+    if (Math.abs(den) < 1e-9) return false;
+
+    const g = (dx3 * dy2 - dx2 * dy3) / den;
+    const h = (dx1 * dy3 - dx3 * dy1) / den;
+    const a = p1.x - p0.x + g * p1.x;
+    const b = p3.x - p0.x + h * p3.x;
+    const c = p0.x;
+    const d = p1.y - p0.y + g * p1.y;
+    const e = p3.y - p0.y + h * p3.y;
+    const f = p0.y;
+
+    // Adjugate of [[a b c] [d e f] [g h 1]]
+    out[0] = e - f * h;
+    out[1] = c * h - b;
+    out[2] = b * f - c * e;
+    out[3] = f * g - d;
+    out[4] = a - c * g;
+    out[5] = c * d - a * f;
+    out[6] = d * h - e * g;
+    out[7] = b * g - a * h;
+    out[8] = a * e - b * d;
+
+    return true;
+  }
+
   /**
    * Update video plane transform
    */
   updateVideoPlane(plane, video, corners) {
     try {
-      // Update texture
+      // Update texture (VideoTexture re-uploads by itself when the video
+      // presents a new frame)
       if (!plane.material.map || plane.material.map.image !== video) {
         if (plane.material.map) {
           plane.material.map.dispose();
@@ -445,11 +581,6 @@ class ARRenderer {
         plane.material.needsUpdate = true;
       }
 
-      // Update texture
-      if (plane.material.map) {
-        plane.material.map.needsUpdate = true;
-      }
-
       // Calculate center
       const centerX = (corners[0].x + corners[1].x + corners[2].x + corners[3].x) / 4;
       const centerY = (corners[0].y + corners[1].y + corners[2].y + corners[3].y) / 4;
@@ -514,13 +645,15 @@ class ARRenderer {
   removeTarget(targetId) {
     const targetObj = this.targetObjects.get(targetId);
     if (targetObj) {
-      this.scene.remove(targetObj.videoPlane);
       this.scene.remove(targetObj.trackingLine);
 
-      targetObj.videoPlane.geometry.dispose();
-      targetObj.videoPlane.material.dispose();
-      if (targetObj.videoPlane.material.map) {
-        targetObj.videoPlane.material.map.dispose();
+      if (targetObj.videoPlane) {
+        this.scene.remove(targetObj.videoPlane);
+        targetObj.videoPlane.geometry.dispose();
+        targetObj.videoPlane.material.dispose();
+        if (targetObj.videoPlane.material.map) {
+          targetObj.videoPlane.material.map.dispose();
+        }
       }
 
       targetObj.trackingLine.geometry.dispose();
@@ -564,6 +697,11 @@ class ARRenderer {
       this.removeTarget(targetId);
     }
 
+    for (const texture of this.compositeTextures.values()) {
+      texture.dispose();
+    }
+    this.compositeTextures.clear();
+
     // Clean up background
     if (this.backgroundTexture) {
       this.backgroundTexture.dispose();
@@ -581,6 +719,46 @@ class ARRenderer {
   }
 }
 
+ARRenderer.COMPOSITE_VERTEX_SHADER = `
+  varying vec2 vUv;
+  varying vec2 vWorld;
+
+  void main() {
+    vUv = uv;
+    vWorld = (modelMatrix * vec4(position, 1.0)).xy;
+    gl_Position = projectionMatrix * modelViewMatrix * vec4(position, 1.0);
+  }
+`;
+
+ARRenderer.COMPOSITE_FRAGMENT_SHADER = `
+  uniform sampler2D uCamera;
+  uniform float uCameraReady;
+  uniform sampler2D uVideo;
+  uniform float uVideoVisible;
+  uniform mat3 uInvHomography;
+  uniform float uWSign;
+
+  varying vec2 vUv;
+  varying vec2 vWorld;
+
+  void main() {
+    vec4 color = uCameraReady > 0.5 ? texture2D(uCamera, vUv) : vec4(0.0, 0.0, 0.0, 1.0);
+
+    if (uVideoVisible > 0.5) {
+      vec3 q = uInvHomography * vec3(vWorld, 1.0);
+      if (q.z * uWSign > 0.0) {
+        vec2 st = q.xy / q.z;
+        if (all(greaterThanEqual(st, vec2(0.0))) && all(lessThanEqual(st, vec2(1.0)))) {
+          color = texture2D(uVideo, vec2(st.x, 1.0 - st.y));
+        }
+      }
+    }
+
+    gl_FragColor = color;
+    #include <colorspace_fragment>
+  }
+`;
+
 // Make available globally
 if (typeof window !== 'undefined') {
   window.ARRenderer = ARRenderer;
@@ -4,14 +4,38 @@
  * Features:
  * - Video element pooling for memory efficiency
  * - Preloading and error handling
- * - Automatic cleanup for lost targets
+ * - Predictive prefetch: targets are scored by vocabulary similarity and
+ *   recent sightings, both fading with likelihoodHalfLifeMs; the likeliest
+ *   prefetchCount videos are pre-buffered within decodedBudgetMB
+ * - Cleanup by that score: paused videos of unlikely targets are released
+ *   after cleanupDelay, and the least likely first when over budget
  */
 class VideoManager {
   constructor(options = {}) {
+    const config = (typeof AppConfig !== 'undefined' && AppConfig.video) || {};
     this.maxPoolSize = options.maxPoolSize || 5;
     this.cleanupDelay = options.cleanupDelay || 3000; // 3s after lost
     this.muted = options.muted !== false; // Default muted
 
+    this.prefetchCount = options.prefetchCount ?? config.prefetchCount ?? 2;
+    this.prebufferSeconds = options.prebufferSeconds ?? config.prebufferSeconds ?? 2;
+    this.decodedBudget = (options.decodedBudgetMB ?? config.decodedBudgetMB ?? 96) * 1048576;
+    this.halfLifeMs = options.likelihoodHalfLifeMs ?? config.likelihoodHalfLifeMs ?? 4000;
+    this.minLikelihood = options.minLikelihood ?? config.minLikelihood ?? 0.05;
+
+    // Likelihood inputs: targetId -> {similarity, similarityAt, seenAt}
+    this.history = new Map();
+    this.nextPrefetchAt = 0;
+    this.prefetching = new Set(); // targetIds whose prefetch URL is still resolving
+
+    // Time to a playable video once a target was selected
+    this.stats = {
+      prefetched: 0,
+      prefetchHits: 0,
+      onDemand: 0,
+      lastWaitMs: 0
+    };
+
     // Video pool: available videos for reuse
     this.videoPool = [];
 
@@ -60,6 +84,16 @@ class VideoManager {
       }
     }
 
+    return this.loadForTarget(targetId, videoUrl);
+  }
+
+  /**
+   * Load a target's video into a pooled element and register it
+   * @private
+   */
+  loadForTarget(targetId, videoUrl, prefetch = false) {
+    const startTime = performance.now();
+
     // Create a promise for this load operation
     const loadPromise = (async () => {
       // Get video from pool or create new
@@ -75,13 +109,21 @@ class VideoManager {
       console.log('[VideoManager] Loading video from URL:', videoUrl);
       await this.loadVideo(video, videoUrl);
 
+      if (prefetch) {
+        await this.bufferAhead(video, this.prebufferSeconds);
+      } else {
+        this.stats.onDemand++;
+        this.stats.lastWaitMs = performance.now() - startTime;
+      }
+
       // Update registration with actual video
       this.activeVideos.set(targetId, {
         video,
         url: videoUrl,
         lastSeen: Date.now(),
         loadPromise: null,
-        preloaded: false // Mark as not preloaded (loaded on-demand)
+        preloaded: false, // Mark as not preloaded (loaded on-demand)
+        prefetched: prefetch // Loaded ahead of selection; counts once as a hit
       });
 
       console.log('[VideoManager] Video loaded and registered for target:', targetId);
@@ -91,9 +133,42 @@ class VideoManager {
     // Register immediately with the load promise to prevent duplicate loads
     this.activeVideos.set(targetId, { loadPromise });
 
+    // A failed load must not leave the placeholder behind
+    loadPromise.catch(() => {
+      if (this.activeVideos.get(targetId)?.loadPromise === loadPromise) {
+        this.activeVideos.delete(targetId);
+      }
+    });
+
     return loadPromise;
   }
 
+  /**
+   * Wait until the first `seconds` are buffered (or the whole video / 5 s)
+   * @private
+   */
+  bufferAhead(video, seconds) {
+    const target = Math.min(seconds, video.duration || seconds);
+    const buffered = () => video.buffered.length > 0 &&
+      video.buffered.start(0) <= 0.1 && video.buffered.end(0) >= target;
+    if (seconds <= 0 || buffered()) return Promise.resolve();
+
+    return new Promise(resolve => {
+      const done = () => {
+        clearTimeout(timeout);
+        video.removeEventListener('progress', onProgress);
+        video.removeEventListener('canplaythrough', done);
+        resolve();
+      };
+      const onProgress = () => {
+        if (buffered()) done();
+      };
+      const timeout = setTimeout(done, 5000);
+      video.addEventListener('progress', onProgress);
+      video.addEventListener('canplaythrough', done);
+    });
+  }
+
   /**
    * Create new video element
    * @returns {HTMLVideoElement}
@@ -105,6 +180,7 @@ class VideoManager {
     video.setAttribute('crossorigin', 'anonymous'); // Enable CORS for WebGL textures
     video.muted = this.muted;
     video.loop = true;
+    video.preload = 'auto'; // Prefetched videos buffer ahead while paused
     video.style.display = 'none';
     document.body.appendChild(video);
 
@@ -218,6 +294,11 @@ class VideoManager {
       if (active.preloaded) {
         active.preloaded = false;
       }
+      if (active.prefetched) {
+        active.prefetched = false;
+        this.stats.prefetchHits++;
+        this.stats.lastWaitMs = 0;
+      }
 
       if (active.video.paused) {
         active.video.play().catch(e => {
@@ -245,6 +326,7 @@ class VideoManager {
    * @param {string} targetId
    */
   updateTargetSeen(targetId) {
+    this.noteSeen(targetId);
     const active = this.activeVideos.get(targetId);
     if (active && !active.loadPromise && active.video) {
       active.lastSeen = Date.now();
@@ -269,7 +351,8 @@ class VideoManager {
   }
 
   /**
-   * Cleanup timer - removes videos for lost targets
+   * Cleanup timer - releases videos of unlikely targets, then the least
+   * likely paused ones while over the decoded budget
    */
   startCleanupTimer() {
     if (this.cleanupTimer) return;
@@ -282,10 +365,11 @@ class VideoManager {
         // Skip entries that are still loading or don't have lastSeen
         if (active.loadPromise || !active.lastSeen) continue;
 
-        // Skip preloaded videos - they should stay loaded until used
+        // Skip preloaded videos - they stay until the budget needs the space
         if (active.preloaded) continue;
 
-        if (now - active.lastSeen > this.cleanupDelay) {
+        if (now - active.lastSeen > this.cleanupDelay &&
+            this.likelihood(targetId, now) < this.minLikelihood) {
           toRemove.push(targetId);
         }
       }
@@ -293,9 +377,172 @@ class VideoManager {
       for (const targetId of toRemove) {
         this.releaseVideo(targetId);
       }
+
+      this.fitBudget(0, now);
     }, 1000); // Check every second
   }
 
+  /**
+   * Record the vocabulary ranking of a detection
+   * @param {Array<{targetId: string, score: number}>} candidates
+   */
+  noteCandidates(candidates) {
+    if (!candidates) return;
+
+    const now = Date.now();
+    for (const { targetId, score } of candidates) {
+      const entry = this.historyFor(targetId);
+      // Keep the stronger of the new score and the faded old one
+      if (score >= this.decay(entry.similarity, entry.similarityAt, now)) {
+        entry.similarity = score;
+        entry.similarityAt = now;
+      }
+    }
+  }
+
+  /**
+   * Record that a target was detected or tracked
+   * @param {string} targetId
+   */
+  noteSeen(targetId) {
+    this.historyFor(targetId).seenAt = Date.now();
+  }
+
+  /**
+   * @private
+   */
+  historyFor(targetId) {
+    let entry = this.history.get(targetId);
+    if (!entry) {
+      entry = { similarity: 0, similarityAt: 0, seenAt: 0 };
+      this.history.set(targetId, entry);
+    }
+    return entry;
+  }
+
+  /**
+   * @private
+   */
+  decay(value, at, now) {
+    if (!at) return 0;
+    return value * Math.pow(0.5, (now - at) / this.halfLifeMs);
+  }
+
+  /**
+   * How likely a target is to need its video soon, in [0, 1]: the faded
+   * vocabulary similarity or the faded last sighting, whichever is higher
+   * @param {string} targetId
+   * @param {number} now - Date.now()
+   * @returns {number}
+   */
+  likelihood(targetId, now = Date.now()) {
+    const entry = this.history.get(targetId);
+    if (!entry) return 0;
+    return Math.max(
+      this.decay(Math.min(1, entry.similarity), entry.similarityAt, now),
+      this.decay(1, entry.seenAt, now)
+    );
+  }
+
+  /**
+   * Pre-buffer the videos of the likeliest targets; called per tracker update
+   * and throttled here
+   * @param {Array} targets - Runtime targets (id, videoUrl, videoDeferred)
+   * @param {Function} resolveUrl - (target) => Promise<videoUrl> for deferred videos
+   */
+  prefetch(targets, resolveUrl = null) {
+    const now = Date.now();
+    if (this.prefetchCount <= 0 || now < this.nextPrefetchAt) return;
+    this.nextPrefetchAt = now + 250;
+
+    const ranked = targets
+      .map(target => ({ target, score: this.likelihood(target.id, now) }))
+      .filter(entry => entry.score >= this.minLikelihood)
+      .sort((a, b) => b.score - a.score)
+      .slice(0, this.prefetchCount);
+
+    for (const { target, score } of ranked) {
+      if (this.activeVideos.has(target.id) || this.prefetching.has(target.id)) continue;
+      if (!target.videoUrl && !(target.videoDeferred && resolveUrl)) continue;
+
+      // Room for one more video, made only by releasing less likely ones
+      if (!this.fitBudget(VideoManager.estimateDecodedBytes(null), now, score)) break;
+
+      this.prefetching.add(target.id);
+      const url = target.videoUrl ? Promise.resolve(target.videoUrl) : resolveUrl(target);
+      url.then(videoUrl => {
+        if (videoUrl && !this.activeVideos.has(target.id)) {
+          this.stats.prefetched++;
+          return this.loadForTarget(target.id, videoUrl, true);
+        }
+        return null;
+      }).catch(error => {
+        console.warn(`[VideoManager] Prefetch failed for ${target.id}:`, error);
+      }).finally(() => {
+        this.prefetching.delete(target.id);
+      });
+    }
+  }
+
+  /**
+   * Release paused videos, least likely first, until `extraBytes` more fit
+   * the decoded budget; only videos scoring below `maxScore` are released
+   * @private
+   * @returns {boolean} Whether the budget has room
+   */
+  fitBudget(extraBytes, now, maxScore = Infinity) {
+    let used = this.decodedBytes();
+    if (used + extraBytes <= this.decodedBudget) return true;
+
+    const candidates = [];
+    for (const [targetId, active] of this.activeVideos) {
+      if (active.loadPromise || !active.video || !active.video.paused) continue;
+      const score = active.preloaded ? 0 : this.likelihood(targetId, now);
+      if (score < maxScore) candidates.push({ targetId, score, video: active.video });
+    }
+    candidates.sort((a, b) => a.score - b.score);
+
+    for (const { targetId, video } of candidates) {
+      if (used + extraBytes <= this.decodedBudget) break;
+      used -= VideoManager.estimateDecodedBytes(video);
+      this.releaseVideo(targetId);
+    }
+    return used + extraBytes <= this.decodedBudget;
+  }
+
+  /**
+   * Estimated decoded memory of the loaded videos
+   * @returns {number} Bytes
+   */
+  decodedBytes() {
+    let bytes = 0;
+    for (const active of this.activeVideos.values()) {
+      bytes += VideoManager.estimateDecodedBytes(active.video || null);
+    }
+    return bytes;
+  }
+
+  /**
+   * A paused video holds a few decoded YUV frames plus an RGBA texture,
+   * about 10 bytes per pixel; 720p is assumed before metadata arrives
+   * @param {HTMLVideoElement|null} video
+   * @returns {number} Bytes
+   */
+  static estimateDecodedBytes(video) {
+    const width = (video && video.videoWidth) || 1280;
+    const height = (video && video.videoHeight) || 720;
+    return width * height * 10;
+  }
+
+  getStats() {
+    return {
+      ...this.stats,
+      loaded: this.activeVideos.size,
+      decodedMB: this.decodedBytes() / 1048576,
+      budgetMB: this.decodedBudget / 1048576
+    };
+  }
+
   /**
    * Release video back to pool
    * @param {string} targetId
@@ -339,11 +586,25 @@ class VideoManager {
   }
 
   /**
-   * Preload videos for all targets
+   * Preload the videos of the likeliest targets (album order when nothing
+   * was seen yet), up to prefetchCount and the decoded budget
    * @param {Array} targets - Array of target objects with videoUrl
    */
   async preloadVideos(targets) {
-    const preloadPromises = targets.map(async (target) => {
+    const now = Date.now();
+    const playable = targets.filter(target => target.videoUrl && !target.videoDeferred);
+    const selected = playable
+      .map((target, index) => ({ target, index, score: this.likelihood(target.id, now) }))
+      .sort((a, b) => b.score - a.score || a.index - b.index)
+      .slice(0, Math.max(1, Math.min(this.prefetchCount,
+        Math.floor(this.decodedBudget / VideoManager.estimateDecodedBytes(null)))))
+      .map(entry => entry.target);
+
+    const preloadPromises = selected.map(async (target) => {
+      if (target.videoDeferred) {
+        // Streamed album: loaded when the target is first detected
+        return;
+      }
       if (!target.videoUrl) {
         console.warn(`[VideoManager] Target ${target.id} has no videoUrl`);
         return;
@@ -390,6 +651,7 @@ class VideoManager {
       }
     }
     this.videoPool = [];
+    this.prefetching.clear();
   }
 }
 
@@ -47,6 +47,9 @@ class OpticalFlowTracker {
 
         // Per-target tracking state (maps targetId -> state)
         this.trackingStates = new Map();
+
+        // Scratch Mats for every per-call buffer (no allocations in steady state)
+        this.pool = MatPool.shared();
     }
 
     /**
@@ -103,7 +106,12 @@ class OpticalFlowTracker {
                 Q: 0.5,
                 // Measurement noise - lower means more trust in measurements
                 R: 0.1,
-                initialized: false
+                // Share of each position correction folded into velocity
+                V: 0.5,
+                initialized: false,
+                // Time of the last update and smoothed interval between updates (ms)
+                updatedAt: 0,
+                interval: 0
             });
         }
         return filters;
@@ -117,15 +125,149 @@ class OpticalFlowTracker {
     }
 
     /**
-     * Track a target between frames with state-of-the-art robustness
-     * @param {cv.Mat} prevFrame - Previous frame
-     * @param {cv.Mat} currentFrame - Current frame
-     * @param {Array<cv.Point>} prevCorners - Previous corner positions
-     * @param {string} targetId - Target identifier for maintaining state
-     * @returns {Object} Tracking result with success flag, corners, quality metrics
+     * Return a grayscale view of a frame, converting RGBA frames
+     * @returns {cv.Mat} The frame itself if already single-channel, else a scratch Mat
      */
-    track(prevFrame, currentFrame, prevCorners, targetId = 'default') {
-        const result = {
+    toGray(frame, scratchName) {
+        if (frame.channels() === 1) return frame;
+
+        const gray = this.pool.scratch(scratchName);
+        cv.cvtColor(frame, gray, cv.COLOR_RGBA2GRAY);
+        return gray;
+    }
+
+    /**
+     * Reuse the tracked inliers from the previous call as this frame's
+     * starting points while there are enough of them
+     * @returns {Array<number>|null} Flat [x, y, ...] or null to re-seed
+     */
+    reusePersistentPoints(trackState) {
+        const points = trackState.trackedPoints;
+        if (!points) return null;
+
+        const framesSinceRefresh = trackState.framesSinceDetection - trackState.lastFeatureRefresh;
+        if (points.length / 2 < AppConfig.tracking.minPersistentPoints ||
+            framesSinceRefresh >= this.params.featureRefreshInterval) {
+            return null;
+        }
+
+        return Array.from(points);
+    }
+
+    /**
+     * Keep the points flagged by a RANSAC inlier mask
+     * @param {Array<number>} points - Flat [x, y, ...]
+     * @param {cv.Mat} inlierMask - One byte per point
+     * @returns {Float32Array}
+     */
+    collectInlierPoints(points, inlierMask) {
+        const count = points.length / 2;
+        if (!inlierMask || inlierMask.empty() || inlierMask.rows !== count) {
+            return Float32Array.from(points);
+        }
+
+        const inliers = [];
+        for (let i = 0; i < count; i++) {
+            if (inlierMask.data[i] === 1) {
+                inliers.push(points[i * 2], points[i * 2 + 1]);
+            }
+        }
+        return Float32Array.from(inliers);
+    }
+
+    /**
+     * Detect well-distributed corners inside target quadrilaterals. All
+     * quads share one mask and one goodFeaturesToTrack call; the corners are
+     * then split by quad.
+     * @param {cv.Mat} prevGray
+     * @param {Array<Array<cv.Point>>} cornersList - One quad per target
+     * @returns {Array<Array<number>|null>} Flat [x, y, ...] per quad, null if too few
+     */
+    seedFeaturePoints(prevGray, cornersList) {
+        // Create a mask for feature detection inside the quadrilaterals
+        const prevMask = this.pool.scratch('flow_mask');
+        prevMask.create(prevGray.rows, prevGray.cols, cv.CV_8UC1);
+        prevMask.setTo(new cv.Scalar(0));
+        const { roi, roiCorners } = this.pool.getObject('flow_roi', () => {
+            // MatVector shares the roi buffer, so updating roi updates the polygon
+            const polygon = new cv.Mat(4, 1, cv.CV_32SC2);
+            const vector = new cv.MatVector();
+            vector.push_back(polygon);
+            return {
+                roi: polygon,
+                roiCorners: vector,
+                delete() { vector.delete(); polygon.delete(); }
+            };
+        });
+        for (const prevCorners of cornersList) {
+            for (let i = 0; i < 4; i++) {
+                roi.data32S[i * 2] = Math.round(prevCorners[i].x);
+                roi.data32S[i * 2 + 1] = Math.round(prevCorners[i].y);
+            }
+            cv.fillPoly(prevMask, roiCorners, new cv.Scalar(255));
+        }
+
+        // Detect good features inside the quadrilaterals
+        // Detect more features initially, then filter for spatial distribution
+        const maxFlowFeatures = AppConfig.opticalFlow.maxFlowFeatures;
+        const featurePointsRaw = this.pool.scratch('flow_features_raw');
+        cv.goodFeaturesToTrack(
+            prevGray,
+            featurePointsRaw,
+            maxFlowFeatures * 2 * cornersList.length, // Detect 2x features for better spatial selection
+            this.params.featureQualityLevel,
+            this.params.featureMinDistance,
+            prevMask
+        );
+
+        return cornersList.map(prevCorners => {
+            const targetPoints = cornersList.length === 1
+                ? featurePointsRaw
+                : this.featuresInsideQuad(featurePointsRaw, prevCorners, maxFlowFeatures * 2);
+
+            if (!targetPoints || targetPoints.rows < 8) {
+                return null;
+            }
+
+            // Apply spatial distribution filtering to ensure even coverage
+            const featurePoints = this.filterFeaturesWithSpatialDistribution(
+                targetPoints,
+                prevCorners,
+                this.params.spatialGridSize
+            );
+
+            if (!featurePoints || featurePoints.rows < 8) {
+                return null;
+            }
+
+            return Array.from(featurePoints.data32F.subarray(0, featurePoints.rows * 2));
+        });
+    }
+
+    /**
+     * The strongest corners of a shared detection that fall inside one quad
+     * @param {cv.Mat} featurePoints - goodFeaturesToTrack output, strongest first
+     * @param {Array<cv.Point>} corners
+     * @param {number} maxCount
+     * @returns {cv.Mat} Pool scratch buffer, valid until the next call
+     */
+    featuresInsideQuad(featurePoints, corners, maxCount) {
+        const data = featurePoints.data32F;
+        const inside = [];
+        for (let i = 0; i < featurePoints.rows && inside.length < maxCount * 2; i++) {
+            if (this.isPointInPolygon(corners, data[i * 2], data[i * 2 + 1])) {
+                inside.push(data[i * 2], data[i * 2 + 1]);
+            }
+        }
+        return this.pool.fromArray('flow_features_target', inside.length / 2, cv.CV_32FC2, inside);
+    }
+
+    /**
+     * Empty tracking result
+     * @private
+     */
+    createTrackResult() {
+        return {
             success: false,
             corners: null,
             flowStatus: null,
@@ -141,83 +283,97 @@ class OpticalFlowTracker {
                 overallScore: 0
             }
         };
+    }
 
-        if (!prevFrame || !currentFrame || !prevCorners || prevCorners.length !== 4) {
-            return result;
-        }
-
-        // Get tracking state for this target
-        const trackState = this.getTrackingState(targetId);
-        trackState.framesSinceDetection++;
-
-        let prevGray = new cv.Mat();
-        let currentGray = new cv.Mat();
-        cv.cvtColor(prevFrame, prevGray, cv.COLOR_RGBA2GRAY);
-        cv.cvtColor(currentFrame, currentGray, cv.COLOR_RGBA2GRAY);
+    /**
+     * Track a target between frames with state-of-the-art robustness
+     * @param {cv.Mat} prevFrame - Previous frame (RGBA or grayscale)
+     * @param {cv.Mat} currentFrame - Current frame (RGBA or grayscale)
+     * @param {Array<cv.Point>} prevCorners - Previous corner positions
+     * @param {string} targetId - Target identifier for maintaining state
+     * @returns {Object} Tracking result with success flag, corners, quality metrics
+     */
+    track(prevFrame, currentFrame, prevCorners, targetId = 'default') {
+        return this.trackMany(prevFrame, currentFrame, [{ targetId, corners: prevCorners }])[0];
+    }
 
-        // Create a mask for feature detection inside the quadrilateral
-        let prevMask = new cv.Mat.zeros(prevGray.rows, prevGray.cols, cv.CV_8UC1);
-        let roiCorners = new cv.MatVector();
-        let roi = new cv.Mat(4, 1, cv.CV_32SC2);
-        for (let i = 0; i < 4; i++) {
-            roi.data32S[i * 2] = Math.round(prevCorners[i].x);
-            roi.data32S[i * 2 + 1] = Math.round(prevCorners[i].y);
+    /**
+     * Track several targets between the same two frames. The frames are
+     * converted once, re-seeded targets share one feature detection, and the
+     * points of all targets go through a single forward and a single backward
+     * calcOpticalFlowPyrLK call, so each frame's pyramid is built once no
+     * matter how many targets are tracked. Homographies and validation stay
+     * per target.
+     * @param {cv.Mat} prevFrame - Frame every target was last measured in
+     * @param {cv.Mat} currentFrame - Current frame (RGBA or grayscale)
+     * @param {Array<{targetId: string, corners: Array<cv.Point>}>} requests
+     * @returns {Array<Object>} One track() result per request, in order
+     */
+    trackMany(prevFrame, currentFrame, requests) {
+        const results = requests.map(() => this.createTrackResult());
+        if (!prevFrame || !currentFrame) {
+            return results;
         }
-        roiCorners.push_back(roi);
-        cv.fillPoly(prevMask, roiCorners, new cv.Scalar(255));
-        roi.delete(); roiCorners.delete();
-
-        // Detect good features inside the quadrilateral
-        // Detect more features initially, then filter for spatial distribution
-        const maxFlowFeatures = AppConfig.opticalFlow.maxFlowFeatures;
-        let featurePointsRaw = new cv.Mat();
-        cv.goodFeaturesToTrack(
-            prevGray,
-            featurePointsRaw,
-            maxFlowFeatures * 2, // Detect 2x features for better spatial selection
-            this.params.featureQualityLevel,
-            this.params.featureMinDistance,
-            prevMask
-        );
 
-        if (!featurePointsRaw || featurePointsRaw.rows < 8) {
-            // Not enough points – return empty result
-            prevGray.delete(); currentGray.delete(); prevMask.delete();
-            featurePointsRaw.delete();
-            return result;
+        const entries = [];
+        requests.forEach((request, i) => {
+            if (!request.corners || request.corners.length !== 4) return;
+
+            // Get tracking state for this target
+            const trackState = this.getTrackingState(request.targetId);
+            trackState.framesSinceDetection++;
+            entries.push({ result: results[i], trackState, prevCorners: request.corners });
+        });
+        if (entries.length === 0) {
+            return results;
         }
 
-        // Apply spatial distribution filtering to ensure even coverage
-        let featurePoints = this.filterFeaturesWithSpatialDistribution(
-            featurePointsRaw,
-            prevCorners,
-            this.params.spatialGridSize
-        );
-
-        // Clean up raw features if a new filtered matrix was created
-        if (featurePoints !== featurePointsRaw) {
-            featurePointsRaw.delete();
+        // Grayscale frames (shared capture path) are used as-is
+        // All Mats below are pool scratch buffers and are never deleted here
+        const prevGray = this.toGray(prevFrame, 'flow_prev_gray');
+        const currentGray = this.toGray(currentFrame, 'flow_current_gray');
+
+        // Carry last frame's inliers forward; re-seed only when they run low
+        // or on featureRefreshInterval
+        const seeding = [];
+        for (const entry of entries) {
+            entry.points = this.reusePersistentPoints(entry.trackState);
+            if (!entry.points) seeding.push(entry);
+        }
+        if (seeding.length > 0) {
+            const seeded = this.seedFeaturePoints(prevGray, seeding.map(entry => entry.prevCorners));
+            seeding.forEach((entry, i) => {
+                entry.points = seeded[i];
+                if (entry.points) {
+                    entry.trackState.lastFeatureRefresh = entry.trackState.framesSinceDetection;
+                }
+            });
         }
 
-        if (!featurePoints || featurePoints.rows < 8) {
-            // Not enough points after filtering – return empty result
-            prevGray.delete(); currentGray.delete(); prevMask.delete();
-            if (featurePoints) featurePoints.delete();
-            return result;
+        // Targets with too few points keep an empty result
+        const flowing = entries.filter(entry => entry.points);
+        if (flowing.length === 0) {
+            return results;
         }
 
-        // Convert feature points to an array and store for visualization
-        let pointsToTrack = [];
-        for (let i = 0; i < featurePoints.rows; i++) {
-            pointsToTrack.push(featurePoints.data32F[i * 2], featurePoints.data32F[i * 2 + 1]);
+        // Concatenate every target's points; entry.offset/count address its slice
+        let total = 0;
+        for (const entry of flowing) {
+            entry.result.prevFeaturePoints = this.pointsArrayToPoints(entry.points);
+            entry.offset = total;
+            entry.count = entry.points.length / 2;
+            total += entry.count;
+        }
+        const pointsToTrack = new Float32Array(total * 2);
+        for (const entry of flowing) {
+            pointsToTrack.set(entry.points, entry.offset * 2);
         }
-        result.prevFeaturePoints = this.pointsArrayToPoints(pointsToTrack);
 
         // Create matrices for tracking
-        let prevPoints = cv.matFromArray(featurePoints.rows, 1, cv.CV_32FC2, pointsToTrack);
-        let nextPoints = new cv.Mat();
-        let status = new cv.Mat();
-        let err = new cv.Mat();
+        const prevPoints = this.pool.fromArray('flow_prev_points', total, cv.CV_32FC2, pointsToTrack);
+        const nextPoints = this.pool.scratch('flow_next_points');
+        const status = this.pool.scratch('flow_status');
+        const err = this.pool.scratch('flow_err');
 
         // Forward optical flow: previous -> current
         cv.calcOpticalFlowPyrLK(
@@ -233,9 +389,9 @@ class OpticalFlowTracker {
         );
 
         // Backward optical flow: current -> previous
-        let backPoints = new cv.Mat();
-        let backStatus = new cv.Mat();
-        let backErr = new cv.Mat();
+        const backPoints = this.pool.scratch('flow_back_points');
+        const backStatus = this.pool.scratch('flow_back_status');
+        const backErr = this.pool.scratch('flow_back_err');
         cv.calcOpticalFlowPyrLK(
             currentGray,
             prevGray,
@@ -248,6 +404,35 @@ class OpticalFlowTracker {
             this.params.criteria
         );
 
+        // Filter every target before estimating any homography: the views
+        // below are invalidated if a later allocation grows the WASM heap
+        const flow = {
+            prev: prevPoints.data32F,
+            next: nextPoints.data32F,
+            back: backPoints.data32F,
+            status: status.data,
+            backStatus: backStatus.data
+        };
+        for (const entry of flowing) {
+            this.filterFlowPoints(entry, flow);
+        }
+
+        for (const entry of flowing) {
+            this.estimateMotion(entry);
+        }
+
+        return results;
+    }
+
+    /**
+     * Keep one target's points that pass the forward-backward check
+     * @private
+     * @param {Object} entry - trackMany() entry; gains prevFiltered/nextFiltered
+     * @param {Object} flow - Typed views of the batched flow output
+     */
+    filterFlowPoints(entry, flow) {
+        const { result, trackState, offset, count } = entry;
+
         // Adaptive forward-backward error threshold based on quality history
         const avgQuality = trackState.qualityHistory.length > 0
             ? trackState.qualityHistory.reduce((a, b) => a + b, 0) / trackState.qualityHistory.length
@@ -259,43 +444,41 @@ class OpticalFlowTracker {
         }
 
         // Filter points by forward-backward error with quality scoring
-        let prevPtsFiltered = [];
-        let nextPtsFiltered = [];
-        let fbErrors = [];
-        let validCount = 0;
-        let nextVisualPoints = [];
-
-        for (let i = 0; i < status.rows; i++) {
-            let forwardTracked = status.data[i] === 1;
-            let backwardTracked = backStatus.data[i] === 1;
+        const prevPtsFiltered = [];
+        const nextPtsFiltered = [];
+        const fbErrors = [];
+        const nextVisualPoints = [];
+
+        for (let i = offset; i < offset + count; i++) {
+            const forwardTracked = flow.status[i] === 1;
+            const backwardTracked = flow.backStatus[i] === 1;
             if (forwardTracked && backwardTracked) {
-                let dx = prevPoints.data32F[i*2] - backPoints.data32F[i*2];
-                let dy = prevPoints.data32F[i*2+1] - backPoints.data32F[i*2+1];
-                let fbError = Math.sqrt(dx*dx + dy*dy);
+                const dx = flow.prev[i*2] - flow.back[i*2];
+                const dy = flow.prev[i*2+1] - flow.back[i*2+1];
+                const fbError = Math.sqrt(dx*dx + dy*dy);
 
                 // Additional check: flow magnitude (reject outliers with extreme motion)
-                let flowDx = nextPoints.data32F[i*2] - prevPoints.data32F[i*2];
-                let flowDy = nextPoints.data32F[i*2+1] - prevPoints.data32F[i*2+1];
-                let flowMagnitude = Math.sqrt(flowDx*flowDx + flowDy*flowDy);
+                const flowDx = flow.next[i*2] - flow.prev[i*2];
+                const flowDy = flow.next[i*2+1] - flow.prev[i*2+1];
+                const flowMagnitude = Math.sqrt(flowDx*flowDx + flowDy*flowDy);
 
                 // Reject if FB error is high or flow is unreasonably large
                 if (fbError <= fbThreshold && flowMagnitude < AppConfig.tracking.maxFlowMagnitude) {
-                    prevPtsFiltered.push(prevPoints.data32F[i*2], prevPoints.data32F[i*2+1]);
-                    nextPtsFiltered.push(nextPoints.data32F[i*2], nextPoints.data32F[i*2+1]);
+                    prevPtsFiltered.push(flow.prev[i*2], flow.prev[i*2+1]);
+                    nextPtsFiltered.push(flow.next[i*2], flow.next[i*2+1]);
                     fbErrors.push(fbError);
-                    validCount++;
                 }
             }
             // Save all next points for visualization
-            if (status.data[i] === 1) {
-                nextVisualPoints.push(new cv.Point(nextPoints.data32F[i*2], nextPoints.data32F[i*2+1]));
+            if (flow.status[i] === 1) {
+                nextVisualPoints.push(new cv.Point(flow.next[i*2], flow.next[i*2+1]));
             }
         }
         result.nextFeaturePoints = nextVisualPoints;
-        result.flowStatus = new Uint8Array(status.data.slice());
+        result.flowStatus = flow.status.slice(offset, offset + count);
 
         // Calculate tracking quality metrics
-        const inlierRatio = validCount / status.rows;
+        const inlierRatio = fbErrors.length / count;
         const fbErrorMean = fbErrors.length > 0
             ? fbErrors.reduce((a, b) => a + b, 0) / fbErrors.length
             : 999;
@@ -304,6 +487,22 @@ class OpticalFlowTracker {
         result.qualityMetrics.inlierRatio = inlierRatio;
         result.qualityMetrics.fbErrorMean = fbErrorMean;
 
+        entry.prevFiltered = prevPtsFiltered;
+        entry.nextFiltered = nextPtsFiltered;
+    }
+
+    /**
+     * Estimate one target's homography from its filtered points, then
+     * validate and apply the transformed corners
+     * @private
+     * @param {Object} entry - trackMany() entry after filterFlowPoints()
+     */
+    estimateMotion(entry) {
+        const { result, trackState, prevCorners } = entry;
+        const prevPtsFiltered = entry.prevFiltered;
+        const nextPtsFiltered = entry.nextFiltered;
+        const { inlierRatio, fbErrorMean } = result.qualityMetrics;
+
         // Adaptive minimum inlier count based on tracking history
         const minInliers = trackState.consecutivePoorFrames > 0
             ? this.params.minInliersStrict
@@ -319,21 +518,16 @@ class OpticalFlowTracker {
                 result.shouldRedetect = true;
             }
 
-            // Clean up and return
-            prevGray.delete(); currentGray.delete(); prevMask.delete();
-            featurePoints.delete(); prevPoints.delete(); nextPoints.delete();
-            status.delete(); err.delete();
-            backPoints.delete(); backStatus.delete(); backErr.delete();
-            return result;
+            return;
         }
 
         // Reset poor frame counter on good tracking
         trackState.consecutivePoorFrames = 0;
 
         // Compute homography based on filtered points using RANSAC
-        let prevPointsMat = cv.matFromArray(prevPtsFiltered.length/2, 1, cv.CV_32FC2, prevPtsFiltered);
-        let nextPointsMat = cv.matFromArray(nextPtsFiltered.length/2, 1, cv.CV_32FC2, nextPtsFiltered);
-        let inlierMask = new cv.Mat();
+        const prevPointsMat = this.pool.fromArray('flow_prev_inliers', prevPtsFiltered.length / 2, cv.CV_32FC2, prevPtsFiltered);
+        const nextPointsMat = this.pool.fromArray('flow_next_inliers', nextPtsFiltered.length / 2, cv.CV_32FC2, nextPtsFiltered);
+        const inlierMask = this.pool.scratch('flow_inlier_mask');
         let homography = cv.findHomography(
             prevPointsMat,
             nextPointsMat,
@@ -354,12 +548,10 @@ class OpticalFlowTracker {
 
         // If homography is valid, transform and validate corners
         if (homography && !homography.empty() && ransacInliers >= this.params.minInliers) {
-            let cornerPoints = new cv.Mat(4, 1, cv.CV_32FC2);
-            for (let i = 0; i < 4; i++) {
-                cornerPoints.data32F[i*2] = prevCorners[i].x;
-                cornerPoints.data32F[i*2+1] = prevCorners[i].y;
-            }
-            let transformedCorners = new cv.Mat();
+            const cornerPoints = this.pool.fromArray(
+                'flow_corners', 4, cv.CV_32FC2, prevCorners.flatMap(p => [p.x, p.y])
+            );
+            const transformedCorners = this.pool.scratch('flow_transformed_corners');
             cv.perspectiveTransform(cornerPoints, transformedCorners, homography);
 
             // Validate and extract transformed corners
@@ -420,6 +612,9 @@ class OpticalFlowTracker {
                             result.shouldRedetect = true;
                         }
 
+                        // Persist RANSAC inliers as the next frame's starting points
+                        trackState.trackedPoints = this.collectInlierPoints(nextPtsFiltered, inlierMask);
+
                         result.corners = smoothedCorners;
                         result.success = true;
                     } else {
@@ -431,8 +626,6 @@ class OpticalFlowTracker {
                     }
                 }
             }
-            cornerPoints.delete();
-            transformedCorners.delete();
         } else {
             // Homography estimation failed
             trackState.consecutivePoorFrames++;
@@ -441,18 +634,11 @@ class OpticalFlowTracker {
             }
         }
 
-        // Clean up all resources
-        prevGray.delete(); currentGray.delete(); prevMask.delete();
-        featurePoints.delete(); prevPoints.delete(); nextPoints.delete();
-        status.delete(); err.delete(); backPoints.delete();
-        backStatus.delete(); backErr.delete(); prevPointsMat.delete(); nextPointsMat.delete();
-        inlierMask.delete();
+        // Scratch buffers stay in the pool; only the homography is per call
         if (homography && result.success === false) {
             // Only delete if we're not storing it in history
             homography.delete();
         }
-
-        return result;
     }
 
     /**
@@ -541,7 +727,7 @@ class OpticalFlowTracker {
             filteredData.push(feature.x, feature.y);
         }
 
-        return cv.matFromArray(selectedFeatures.length, 1, cv.CV_32FC2, filteredData);
+        return this.pool.fromArray('flow_features_filtered', selectedFeatures.length, cv.CV_32FC2, filteredData);
     }
 
     // Generate additional tracking points inside the quadrilateral for better tracking
@@ -685,8 +871,11 @@ class OpticalFlowTracker {
 
     /**
      * Apply Kalman filtering to smooth corner positions
+     * @param {Array<{x, y}>} corners - Measured corners
+     * @param {Array} kalmanFilters - From initializeKalmanFilters
+     * @param {number} timestamp - performance.now() of the measurement
      */
-    applyKalmanSmoothing(corners, kalmanFilters) {
+    applyKalmanSmoothing(corners, kalmanFilters, timestamp = performance.now()) {
         const smoothedCorners = [];
 
         for (let i = 0; i < 4; i++) {
@@ -697,6 +886,7 @@ class OpticalFlowTracker {
                 // Initialize filter with first measurement
                 filter.x = [measurement[0], measurement[1], 0, 0];
                 filter.initialized = true;
+                filter.updatedAt = timestamp;
                 smoothedCorners.push(new cv.Point(measurement[0], measurement[1]));
             } else {
                 // Prediction step
@@ -720,14 +910,19 @@ class OpticalFlowTracker {
                 filter.x[0] = predicted_x + K_x * (measurement[0] - predicted_x);
                 filter.x[1] = predicted_y + K_y * (measurement[1] - predicted_y);
 
-                // Update velocity based on change
-                filter.x[2] = (filter.x[0] - predicted_x) / dt;
-                filter.x[3] = (filter.x[1] - predicted_y) / dt;
+                // Correct velocity by part of the position correction
+                filter.x[2] += filter.V * (filter.x[0] - predicted_x) / dt;
+                filter.x[3] += filter.V * (filter.x[1] - predicted_y) / dt;
 
                 // Update covariance
                 filter.P[0][0] *= (1 - K_x);
                 filter.P[1][1] *= (1 - K_y);
 
+                // One step per update: remember how long a step really is
+                const elapsed = timestamp - filter.updatedAt;
+                filter.interval = filter.interval ? filter.interval * 0.8 + elapsed * 0.2 : elapsed;
+                filter.updatedAt = timestamp;
+
                 smoothedCorners.push(new cv.Point(filter.x[0], filter.x[1]));
             }
         }
@@ -735,6 +930,28 @@ class OpticalFlowTracker {
         return smoothedCorners;
     }
 
+    /**
+     * Extrapolate Kalman-filtered corners to a time after their last update
+     * (constant velocity), e.g. for render frames between tracker frames
+     * @param {Array} kalmanFilters - Filters fed by applyKalmanSmoothing
+     * @param {number} timestamp - performance.now() to predict for
+     * @param {number} maxLeadMs - Never extrapolate further than this
+     * @param {Array<{x, y}>} out - Four points, written in place
+     * @returns {Array<{x, y}>} out
+     */
+    predictKalmanCorners(kalmanFilters, timestamp, maxLeadMs, out) {
+        for (let i = 0; i < 4; i++) {
+            const filter = kalmanFilters[i];
+            const lead = filter.interval > 0
+                ? Math.min(Math.max(timestamp - filter.updatedAt, 0), maxLeadMs) / filter.interval
+                : 0;
+
+            out[i].x = filter.x[0] + filter.x[2] * lead;
+            out[i].y = filter.x[1] + filter.x[3] * lead;
+        }
+        return out;
+    }
+
     /**
      * Validate geometry changes between frames
      */
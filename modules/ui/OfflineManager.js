@@ -20,6 +20,8 @@ class OfflineManager {
     window.addEventListener('online', () => this.handleOnline());
     window.addEventListener('offline', () => this.handleOffline());
 
+    this.registerServiceWorker();
+
     // Initialize cache manager
     if (window.CacheManager) {
       try {
@@ -41,6 +43,21 @@ class OfflineManager {
     this.addCacheInfoToPanel();
   }
 
+  /**
+   * Register sw.js, which serves albums from the album cache with Range
+   * support; it controls the page from its first activation on
+   */
+  async registerServiceWorker() {
+    if (!AppConfig.album.serviceWorker || !('serviceWorker' in navigator)) return;
+
+    try {
+      await navigator.serviceWorker.register('sw.js');
+      console.log('[OfflineManager] Service worker registered');
+    } catch (error) {
+      console.error('[OfflineManager] Service worker registration failed:', error);
+    }
+  }
+
   /**
    * Create offline status element
    */
@@ -241,6 +258,9 @@ class OfflineManager {
     if (!this.cacheManager) return false;
 
     try {
+      const contentCache = this.cacheManager.contentCache;
+      if (contentCache && await contentCache.getAlbum(albumCode)) return true;
+
       const cachedAlbum = await this.cacheManager.getAlbum(albumCode);
       return cachedAlbum !== null;
     } catch (error) {
@@ -36,6 +36,7 @@ class UIManager {
         this.maxFeaturesValue = byId('maxFeaturesValue');
         this.opticalFlowBadge = byId('opticalFlowBadge');
         this.fpsValue = byId('fpsValue');
+        this.qualityTierValue = byId('qualityTier');
         this.targetStatusList = byId('targetStatusList');
         this.databaseInfo = byId('databaseInfo');
         this.profileButton = byId('profileButton');
@@ -339,6 +340,10 @@ class UIManager {
                 const filename = this.tracker.debugExporter.downloadJSON();
                 success = true;
                 message = `Downloaded: ${filename}`;
+            } else if (choice === 'trace') {
+                const filename = this.tracker.debugExporter.downloadTrace();
+                success = true;
+                message = `Downloaded: ${filename}`;
             }
 
             // Show success/error message
@@ -426,6 +431,12 @@ class UIManager {
                         font-weight: 500;">
                         Download as JSON
                     </button>
+                    <button id="debugTraceBtn" style="padding: 12px;
+                        background: #f59e0b; color: white; border: none;
+                        border-radius: 8px; cursor: pointer; font-size: 15px;
+                        font-weight: 500;">
+                        Download Performance Trace
+                    </button>
                     <button id="debugCancelBtn" style="padding: 12px;
                         background: #f3f4f6; color: #1a1a1a; border: none;
                         border-radius: 8px; cursor: pointer; font-size: 15px;
@@ -457,6 +468,11 @@ class UIManager {
                 resolve('json');
             };
 
+            document.getElementById('debugTraceBtn').onclick = () => {
+                cleanup();
+                resolve('trace');
+            };
+
             document.getElementById('debugCancelBtn').onclick = () => {
                 cleanup();
                 resolve('cancel');
@@ -637,7 +653,12 @@ class UIManager {
         }
     }
 
-    updateFPS(fpsValue) {
+    /**
+     * @param {number} fpsValue - Processed frames per second
+     * @param {Object} frameStats - FrameScheduler.getStats(), adds the camera
+     *   rate and latency when the frame metadata provides them
+     */
+    updateFPS(fpsValue, frameStats = null) {
         if (!this.fpsValue) return;
 
         if (!Number.isFinite(fpsValue) || fpsValue <= 0) {
@@ -646,7 +667,34 @@ class UIManager {
         }
 
         const rounded = Math.round(fpsValue);
-        this.fpsValue.textContent = `${rounded} fps`;
+        let text = frameStats && frameStats.cameraFps > 0
+            ? `${rounded}/${Math.round(frameStats.cameraFps)} fps`
+            : `${rounded} fps`;
+        if (frameStats && frameStats.latencyMs > 0) {
+            text += ` · ${Math.round(frameStats.latencyMs)} ms`;
+        }
+        this.fpsValue.textContent = text;
+    }
+
+    /**
+     * Show the quality governor's tier and keep the tunable sliders in sync
+     * @param {Object} status - QualityGovernor.getStatus()
+     */
+    updateQualityTier(status) {
+        const { state } = this.tracker;
+
+        if (this.qualityTierValue) {
+            this.qualityTierValue.textContent =
+                `${status.tier} (${status.tierIndex + 1}/${status.tierCount}) · ${state.maxDimension}px`;
+        }
+        if (this.detectionIntervalSlider) {
+            this.detectionIntervalSlider.value = state.detectionInterval;
+        }
+        this.updateDetectionIntervalValue(state.detectionInterval);
+        if (this.maxFeaturesSlider) {
+            this.maxFeaturesSlider.value = state.maxFeatures;
+        }
+        this.updateMaxFeaturesValue(state.maxFeatures);
     }
 
     highlightReferencePicker() {
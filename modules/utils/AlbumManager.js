@@ -2,7 +2,8 @@
  * AlbumManager.js
  *
  * Handles album code validation and downloading from storage via backend proxy
- * Integrates IndexedDB caching for offline support and performance
+ * Integrates caching for offline support and performance: extracted albums
+ * in AlbumContentCache where available, whole zips in IndexedDB otherwise
  */
 
 class AlbumManager {
@@ -12,6 +13,7 @@ class AlbumManager {
 
     // Initialize cache manager
     this.cacheManager = null;
+    this.zipCacheHit = false; // Album came from the IndexedDB zip store
     this.initCacheManager();
   }
 
@@ -189,9 +191,12 @@ class AlbumManager {
    * Get album zip from URL parameter
    * Checks cache first, downloads if not cached
    * @param {Function} onProgress - Progress callback (optional)
-   * @returns {Promise<Blob>} Album zip blob
+   * @param {Object} options - {streaming}: on a cache miss return the
+   *   download URL instead of downloading (ZipDatabaseLoader range-reads it)
+   * @returns {Promise<CachedAlbum|Blob|string>} Extracted cached album, album
+   *   zip blob, or its URL when streaming
    */
-  async getAlbumFromURL(onProgress = null) {
+  async getAlbumFromURL(onProgress = null, options = {}) {
     try {
       // Get encrypted code from URL
       const encryptedCode = this.getAlbumCodeFromURL();
@@ -213,8 +218,24 @@ class AlbumManager {
           });
         }
 
+        const contentCache = this.cacheManager.contentCache;
+        const cachedAlbum = contentCache ? await contentCache.getAlbum(encryptedCode) : null;
+        if (cachedAlbum) {
+          console.log('[AlbumManager] Using extracted cached album');
+          if (onProgress) {
+            onProgress({
+              stage: 'cache',
+              progress: 100,
+              message: 'Loaded from cache',
+              cached: true
+            });
+          }
+          return cachedAlbum;
+        }
+
         const cachedZip = await this.cacheManager.getAlbum(encryptedCode);
         if (cachedZip) {
+          this.zipCacheHit = true;
           console.log('[AlbumManager] Using cached album');
           if (onProgress) {
             onProgress({
@@ -240,6 +261,10 @@ class AlbumManager {
 
       const downloadUrl = await this.getDownloadURL(encryptedCode);
 
+      if (options.streaming) {
+        return downloadUrl;
+      }
+
       // Download the zip file
       if (onProgress) {
         onProgress({
@@ -259,8 +284,9 @@ class AlbumManager {
         }
       });
 
-      // Store in cache for future use
-      if (this.cacheManager) {
+      // Store in cache for future use (extracted albums are stored by
+      // cacheAlbumContents once loaded)
+      if (this.cacheManager && !this.cacheManager.contentCache) {
         if (onProgress) {
           onProgress({
             stage: 'caching',
@@ -283,6 +309,57 @@ class AlbumManager {
       throw error;
     }
   }
+
+  /**
+   * Store a loaded album's files in AlbumContentCache, so the next visit
+   * reads them without downloading or unzipping; a zip cached in IndexedDB
+   * by an earlier version is dropped once its contents are stored
+   * @param {string} encryptedCode
+   * @param {ZipDatabaseLoader} loader - Loader that read the album
+   * @returns {Promise<boolean>} false when the album cache is unavailable
+   */
+  async cacheAlbumContents(encryptedCode, loader) {
+    if (!this.cacheManager && window.CacheManager) {
+      await this.initCacheManager();
+    }
+    const contentCache = this.cacheManager && this.cacheManager.contentCache;
+    if (!contentCache) {
+      loader.takeCacheableEntries(); // Frees the zip they read from
+      return false;
+    }
+
+    try {
+      await contentCache.storeEntries(encryptedCode, loader.takeCacheableEntries());
+      if (this.zipCacheHit) {
+        await this.cacheManager.deleteAlbum(encryptedCode);
+      }
+      console.log('[AlbumManager] Album contents saved to cache');
+    } catch (error) {
+      console.error('[AlbumManager] Album contents caching failed:', error);
+    }
+    return true;
+  }
+
+  /**
+   * Download a streamed album whole and cache it, so the next visit (and
+   * offline use) reads it from IndexedDB
+   * @param {string} encryptedCode
+   * @param {string} url - Download URL from getDownloadURL
+   */
+  async cacheAlbumInBackground(encryptedCode, url) {
+    if (!this.cacheManager && window.CacheManager) {
+      await this.initCacheManager();
+    }
+    if (!this.cacheManager) return;
+
+    try {
+      const zipBlob = await this.downloadAlbumZip(url);
+      await this.cacheManager.storeAlbum(encryptedCode, zipBlob);
+      console.log('[AlbumManager] Streamed album saved to cache');
+    } catch (error) {
+      console.error('[AlbumManager] Background album caching failed:', error);
+    }
+  }
 }
 
 // Make available globally
@@ -115,15 +115,19 @@ class DebugExporter {
       isProcessing: state.isProcessing,
       isTracking: state.isTracking,
       fps: state.fps,
+      frameTiming: this.tracker.frameScheduler ? this.tracker.frameScheduler.getStats() : null,
       useOpticalFlow: state.useOpticalFlow,
       detectionInterval: state.detectionInterval,
       frameCount: state.frameCount,
       maxFeatures: state.maxFeatures,
       maxDimension: state.maxDimension,
+      pyramidLevels: state.pyramidLevels,
+      qualityTier: this.tracker.governor ? this.tracker.governor.getStatus() : null,
       visualizeFlowPoints: state.visualizeFlowPoints,
       drawKeypoints: state.drawKeypoints,
       activeVideoTarget: state.activeVideoTarget,
-      trackedTargetsCount: state.trackedTargets?.size || 0
+      trackedTargetsCount: state.trackedTargets?.size || 0,
+      matPool: this.tracker.getMatPoolStats ? this.tracker.getMatPoolStats() : null
     };
   }
 
@@ -177,6 +181,13 @@ class DebugExporter {
     return this.tracker.profiler.getMetrics();
   }
 
+  /**
+   * Timeline of the last complete frame
+   */
+  getFrameTrace() {
+    return this.tracker?.profiler ? this.tracker.profiler.getFrameTrace() : [];
+  }
+
   /**
    * Collect OpenCV build information
    */
@@ -203,6 +214,8 @@ class DebugExporter {
       threadsSupported: buildInfo.threadsSupported ?? null,
       buildsAvailable: buildInfo.buildsAvailable || null,
       selectedAt: buildInfo.timestamp || null,
+      threads: buildInfo.threads || null,
+      workerBuild: this.tracker?.visionWorker?.buildInfo || null,
       cvReady: Boolean(cvModule),
       cvVersion
     };
@@ -224,6 +237,7 @@ class DebugExporter {
       cameraInfo: this.getCameraInfo(),
       referenceInfo: this.getReferenceInfo(),
       profilingData: this.getProfilingData(),
+      frameTrace: this.getFrameTrace(),
       logs: this.logs.slice(-500) // Include last 500 logs
     };
 
@@ -267,6 +281,13 @@ class DebugExporter {
     text += `Threads Supported: ${ocv.threadsSupported}\n`;
     text += `WASM Supported: ${ocv.wasmSupported}\n`;
     text += `Selected At: ${ocv.selectedAt}\n`;
+    if (ocv.threads) {
+      text += `Threads: ${ocv.threads.count}${ocv.threads.applied ? '' : ' (fixed by build)'}\n`;
+    }
+    if (ocv.workerBuild) {
+      const workerThreads = ocv.workerBuild.threads ? `, ${ocv.workerBuild.threads.count} thread(s)` : '';
+      text += `Vision Worker Build: ${ocv.workerBuild.variant}${workerThreads}\n`;
+    }
     if (ocv.buildsAvailable) {
       text += 'Available Builds:\n';
       Object.entries(ocv.buildsAvailable).forEach(([key, available]) => {
@@ -280,11 +301,29 @@ class DebugExporter {
     text += `Tracking: ${state.isTracking}\n`;
     text += `Processing: ${state.isProcessing}\n`;
     text += `FPS: ${state.fps}\n`;
+    if (state.frameTiming) {
+      const timing = state.frameTiming;
+      text += `Frame Timing: ${timing.mode}, camera ${timing.cameraFps.toFixed(1)} fps, ` +
+              `latency ${timing.latencyMs.toFixed(1)} ms, ${timing.dropped} dropped / ${timing.processed} processed\n`;
+    }
     text += `Optical Flow: ${state.useOpticalFlow}\n`;
     text += `Detection Interval: ${state.detectionInterval}\n`;
     text += `Frame Count: ${state.frameCount}\n`;
     text += `Max Features: ${state.maxFeatures}\n`;
-    text += `Tracked Targets: ${state.trackedTargetsCount}\n\n`;
+    if (state.qualityTier) {
+      const tier = state.qualityTier;
+      text += `Quality Tier: ${tier.tier} (${tier.tierIndex + 1}/${tier.tierCount}), ` +
+              `${state.maxDimension}px, ${state.pyramidLevels} levels, ` +
+              `${tier.lastCostMs}ms / ${tier.frameBudgetMs}ms budget\n`;
+    }
+    text += `Tracked Targets: ${state.trackedTargetsCount}\n`;
+    if (state.matPool) {
+      const pool = state.matPool;
+      text += `Mat Pool (${pool.source}): ${pool.hits} hits / ${pool.misses} misses ` +
+              `(${(pool.hitRate * 100).toFixed(1)}%), ${pool.pooled} pooled, ` +
+              `${pool.scratch} scratch, ${pool.outstanding} outstanding\n`;
+    }
+    text += '\n';
 
     text += '# CAMERA INFO\n';
     const cam = report.cameraInfo;
@@ -317,6 +356,9 @@ class DebugExporter {
         text += `\n${label}:\n`;
         text += `  Avg: ${data.avg.toFixed(2)}ms ` +
                 `(Recent: ${data.recentAvg.toFixed(2)}ms)\n`;
+        text += `  p50: ${data.p50.toFixed(2)}ms | ` +
+                `p95: ${data.p95.toFixed(2)}ms | ` +
+                `p99: ${data.p99.toFixed(2)}ms\n`;
         text += `  Min: ${data.min.toFixed(2)}ms | ` +
                 `Max: ${data.max.toFixed(2)}ms\n`;
         text += `  Count: ${data.count} | ` +
@@ -325,6 +367,18 @@ class DebugExporter {
     }
     text += '\n';
 
+    if (report.frameTrace.length > 0) {
+      text += '# LAST FRAME TRACE\n';
+      const origin = report.frameTrace[0].start;
+      for (const event of report.frameTrace) {
+        const indent = '  '.repeat(event.depth);
+        const detail = event.arg !== undefined ? ` [${event.arg}]` : '';
+        text += `${(event.start - origin).toFixed(2).padStart(8)}ms ${event.track.padEnd(6)} ` +
+                `${indent}${event.label}${detail}: ${event.duration.toFixed(2)}ms\n`;
+      }
+      text += '\n';
+    }
+
     text += '# CONSOLE LOGS (Last 100)\n';
     const recentLogs = report.logs.slice(-100);
     recentLogs.forEach(log => {
@@ -358,6 +412,31 @@ class DebugExporter {
     return filename;
   }
 
+  /**
+   * Download the profiler's trace buffer as Chrome trace-event JSON
+   * (open in chrome://tracing or ui.perfetto.dev)
+   */
+  downloadTrace() {
+    const trace = this.tracker?.profiler
+      ? this.tracker.profiler.toTraceEvents()
+      : { traceEvents: [] };
+    const blob = new Blob([JSON.stringify(trace)], { type: 'application/json' });
+    const url = URL.createObjectURL(blob);
+
+    const timestamp = new Date().toISOString()
+      .replace(/[:.]/g, '-').slice(0, -5);
+    const filename = `stories-ar-trace-${timestamp}.json`;
+
+    const a = document.createElement('a');
+    a.href = url;
+    a.download = filename;
+    a.click();
+
+    URL.revokeObjectURL(url);
+
+    return filename;
+  }
+
   /**
    * Download debug report as text file
    */
@@ -0,0 +1,66 @@
+/**
+ * Logger - Leveled logging for per-frame diagnostics
+ *
+ * Hot-path diagnostics are written as
+ *
+ *   if (Logger.debugEnabled) {
+ *     ...statistics only the log needs...
+ *     Logger.debug('[Module] message', details);
+ *   }
+ *
+ * so nothing is built while the level is above debug, and build.js strips
+ * both the guarded blocks and bare Logger.debug() calls from production
+ * bundles. Running from source (index.html, debug pages) keeps them and
+ * honours AppConfig.logging.level or a ?log=<level> URL parameter.
+ *
+ * Both forms must be statements of their own: a guarded block takes no
+ * `else` / `else if`, and neither may be the braceless body of an
+ * if/else/for/while. build.js fails on those rather than emit a bundle
+ * whose control flow changed.
+ */
+class Logger {
+  /**
+   * @param {string} level - 'debug' | 'info' | 'warn' | 'error' | 'silent'
+   */
+  static setLevel(level) {
+    const value = Logger.LEVELS[level];
+    Logger.level = value === undefined ? Logger.LEVELS.info : value;
+    Logger.debugEnabled = Logger.level <= Logger.LEVELS.debug;
+  }
+
+  /**
+   * Level from the page URL (?log=debug), else from config
+   * @returns {string}
+   */
+  static initialLevel() {
+    if (typeof location !== 'undefined' && typeof URLSearchParams !== 'undefined') {
+      const fromUrl = new URLSearchParams(location.search).get('log');
+      if (fromUrl && Logger.LEVELS[fromUrl] !== undefined) return fromUrl;
+    }
+    return (typeof AppConfig !== 'undefined' && AppConfig.logging && AppConfig.logging.level) || 'info';
+  }
+
+  static debug(...args) {
+    if (Logger.level <= Logger.LEVELS.debug) console.log(...args);
+  }
+
+  static info(...args) {
+    if (Logger.level <= Logger.LEVELS.info) console.log(...args);
+  }
+
+  static warn(...args) {
+    if (Logger.level <= Logger.LEVELS.warn) console.warn(...args);
+  }
+
+  static error(...args) {
+    if (Logger.level <= Logger.LEVELS.error) console.error(...args);
+  }
+}
+
+Logger.LEVELS = { debug: 0, info: 1, warn: 2, error: 3, silent: 4 };
+Logger.setLevel(Logger.initialLevel());
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.Logger = Logger;
+}
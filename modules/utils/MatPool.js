@@ -0,0 +1,205 @@
+/**
+ * MatPool - Reusable OpenCV allocations for the per-frame hot path
+ *
+ * Three kinds of reuse, one shared instance per thread (MatPool.shared()):
+ * - acquire/release: fixed-size Mats keyed by rows x cols x type, for
+ *   buffers whose lifetime spans frames (tracked keyframes, launch frames)
+ * - scratch(name): one persistent Mat per call site, used as an OpenCV
+ *   output argument; OpenCV reuses its buffer while the shape is unchanged
+ * - getObject(key, factory): long-lived helpers such as CLAHE instances
+ *
+ * Every lookup counts as a hit (reused) or a miss (allocated) so steady-state
+ * allocation can be verified from the profiler / debug report.
+ */
+class MatPool {
+  constructor() {
+    this.free = new Map(); // shapeKey -> Mat[]
+    this.scratchMats = new Map(); // name -> Mat
+    this.objects = new Map(); // key -> object with delete()
+    this.maxFreePerShape = 4;
+
+    this.stats = {
+      hits: 0,
+      misses: 0,
+      released: 0,
+      discarded: 0,
+      outstanding: 0
+    };
+  }
+
+  /**
+   * Per-thread shared pool
+   * @returns {MatPool}
+   */
+  static shared() {
+    if (!MatPool.instance) {
+      MatPool.instance = new MatPool();
+    }
+    return MatPool.instance;
+  }
+
+  static shapeKey(rows, cols, type) {
+    return `${rows}x${cols}:${type}`;
+  }
+
+  /**
+   * Get a Mat of the given shape, reusing a released one when available
+   * Contents are undefined; callers overwrite them (copyTo, data.set, ...)
+   * @returns {cv.Mat}
+   */
+  acquire(rows, cols, type) {
+    const list = this.free.get(MatPool.shapeKey(rows, cols, type));
+    this.stats.outstanding++;
+
+    if (list && list.length > 0) {
+      this.stats.hits++;
+      return list.pop();
+    }
+
+    this.stats.misses++;
+    return new cv.Mat(rows, cols, type);
+  }
+
+  /**
+   * Return a Mat obtained from acquire()
+   * @param {cv.Mat} mat
+   */
+  release(mat) {
+    if (!mat || mat.isDeleted()) return;
+
+    this.stats.outstanding = Math.max(0, this.stats.outstanding - 1);
+
+    const key = MatPool.shapeKey(mat.rows, mat.cols, mat.type());
+    let list = this.free.get(key);
+    if (!list) {
+      list = [];
+      this.free.set(key, list);
+    }
+
+    if (list.length >= this.maxFreePerShape) {
+      // Shape churn (e.g. orientation change) - do not hoard old sizes
+      mat.delete();
+      this.stats.discarded++;
+      return;
+    }
+
+    list.push(mat);
+    this.stats.released++;
+  }
+
+  /**
+   * Acquire a Mat and copy a source frame into it
+   * @param {cv.Mat} src
+   * @returns {cv.Mat}
+   */
+  acquireCopy(src) {
+    const mat = this.acquire(src.rows, src.cols, src.type());
+    src.copyTo(mat);
+    return mat;
+  }
+
+  /**
+   * Persistent scratch Mat for one call site. Never delete it; the next
+   * call with the same name returns the same object.
+   * @param {string} name - Unique call-site name
+   * @returns {cv.Mat}
+   */
+  scratch(name) {
+    let mat = this.scratchMats.get(name);
+    if (mat) {
+      this.stats.hits++;
+      return mat;
+    }
+
+    this.stats.misses++;
+    mat = new cv.Mat();
+    this.scratchMats.set(name, mat);
+    return mat;
+  }
+
+  /**
+   * Scratch Mat filled from a flat number array (replaces cv.matFromArray)
+   * @param {string} name - Unique call-site name
+   * @param {number} rows
+   * @param {number} type - e.g. cv.CV_32FC2
+   * @param {Array<number>} values
+   * @returns {cv.Mat}
+   */
+  fromArray(name, rows, type, values) {
+    const mat = this.scratch(name);
+    mat.create(rows, 1, type);
+
+    if (type === cv.CV_32FC2 || type === cv.CV_32FC1) {
+      mat.data32F.set(values);
+    } else if (type === cv.CV_32SC2 || type === cv.CV_32SC1) {
+      mat.data32S.set(values);
+    } else {
+      mat.data.set(values);
+    }
+    return mat;
+  }
+
+  /**
+   * Cached helper object (CLAHE, MatVector, ...) created on first use
+   * @param {string} key - Include any shape/parameters in the key
+   * @param {Function} factory - Creates the object
+   * @returns {*}
+   */
+  getObject(key, factory) {
+    let object = this.objects.get(key);
+    if (object) {
+      this.stats.hits++;
+      return object;
+    }
+
+    this.stats.misses++;
+    object = factory();
+    this.objects.set(key, object);
+    return object;
+  }
+
+  /**
+   * Snapshot of hit/miss counters and pool sizes
+   * @returns {Object}
+   */
+  getStats() {
+    let pooled = 0;
+    for (const list of this.free.values()) {
+      pooled += list.length;
+    }
+
+    const lookups = this.stats.hits + this.stats.misses;
+    return {
+      ...this.stats,
+      hitRate: lookups > 0 ? this.stats.hits / lookups : 0,
+      pooled,
+      scratch: this.scratchMats.size,
+      objects: this.objects.size
+    };
+  }
+
+  /**
+   * Delete every pooled, scratch and cached object
+   */
+  clear() {
+    for (const list of this.free.values()) {
+      for (const mat of list) mat.delete();
+    }
+    this.free.clear();
+
+    for (const mat of this.scratchMats.values()) mat.delete();
+    this.scratchMats.clear();
+
+    for (const object of this.objects.values()) {
+      if (object && typeof object.delete === 'function') object.delete();
+    }
+    this.objects.clear();
+  }
+}
+
+MatPool.instance = null;
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.MatPool = MatPool;
+}
@@ -1,60 +1,263 @@
 /**
  * Performance profiling utility for tracking algorithm bottlenecks
+ *
+ * Spans are identified by small integers from a shared registry
+ * (PerformanceProfiler.Span holds the tracker's labels); string labels are
+ * still accepted and registered on first use. Per-span statistics and a
+ * ring buffer of trace events live in preallocated typed arrays, so a
+ * timer costs two performance.now() calls and a few array writes, and
+ * nothing at all while the profiler is disabled.
+ *
+ * Events carry the frame they were recorded in and their nesting depth,
+ * which gives a per-frame timeline (getFrameTrace) and a Chrome trace-event
+ * export (toTraceEvents, loadable in chrome://tracing or Perfetto).
  */
 class PerformanceProfiler {
-  constructor() {
-    this.metrics = new Map();
-    this.currentTimers = new Map();
+  /**
+   * @param {Object} options - Overrides for AppConfig.profiler
+   */
+  constructor(options = {}) {
+    const config = { ...AppConfig.profiler, ...options };
+
     this.enabled = true;
+    this.userTiming = config.userTiming && typeof performance.measure === 'function';
+
+    // Per-span statistics, indexed by span id
+    const spans = PerformanceProfiler.MAX_SPANS;
+    const history = PerformanceProfiler.HISTORY_SAMPLES;
+    this.starts = new Float64Array(spans);
+    this.startDepths = new Uint8Array(spans);
+    this.running = new Uint8Array(spans);
+    this.counts = new Float64Array(spans);
+    this.totals = new Float64Array(spans);
+    this.mins = new Float64Array(spans).fill(Infinity);
+    this.maxs = new Float64Array(spans).fill(-Infinity);
+    this.history = new Float64Array(spans * history); // Ring of recent durations per span
+    this.historyHead = new Int32Array(spans);
+
+    // Trace ring buffer
+    const capacity = config.traceCapacity;
+    this.traceCapacity = capacity;
+    this.traceSpan = new Int32Array(capacity);
+    this.traceStart = new Float64Array(capacity);
+    this.traceDuration = new Float64Array(capacity);
+    this.traceFrame = new Int32Array(capacity);
+    this.traceDepth = new Uint8Array(capacity);
+    this.traceTrack = new Uint8Array(capacity);
+    this.traceArgs = new Array(capacity);
+    this.traceHead = 0;
+    this.traceSize = 0;
+
+    this.frame = 0;
+    this.depth = 0;
+    this.samples = null; // [[label, start, duration], ...] while collecting (beginSamples)
+  }
+
+  /**
+   * Id for a span label, registering it on first use
+   * @param {string} label
+   * @returns {number}
+   */
+  static register(label) {
+    let id = PerformanceProfiler.spanIds.get(label);
+    if (id === undefined) {
+      id = PerformanceProfiler.spanLabels.length;
+      if (id >= PerformanceProfiler.MAX_SPANS) {
+        console.warn(`[PerformanceProfiler] Too many span labels, ignoring: ${label}`);
+        return -1;
+      }
+      PerformanceProfiler.spanLabels.push(label);
+      PerformanceProfiler.spanIds.set(label, id);
+    }
+    return id;
+  }
+
+  /**
+   * @private
+   */
+  static resolve(span) {
+    return typeof span === 'number' ? span : PerformanceProfiler.register(span);
+  }
+
+  /**
+   * Start a new frame; later events are attributed to it
+   */
+  beginFrame() {
+    if (!this.enabled) return;
+    this.frame++;
+    this.depth = 0;
   }
 
   /**
    * Start timing a specific operation
-   * @param {string} label - Label for the operation
+   * @param {number|string} span - Span id (PerformanceProfiler.Span) or label
    */
-  startTimer(label) {
+  startTimer(span) {
     if (!this.enabled) return;
-    this.currentTimers.set(label, performance.now());
+
+    const id = PerformanceProfiler.resolve(span);
+    if (id < 0) return;
+
+    this.starts[id] = performance.now();
+    this.startDepths[id] = this.depth;
+    this.running[id] = 1;
+    this.depth++;
   }
 
   /**
    * End timing and record the duration
-   * @param {string} label - Label for the operation
+   * @param {number|string} span - Span id (PerformanceProfiler.Span) or label
+   * @param {*} arg - Optional detail kept with the trace event (e.g. target id)
    */
-  endTimer(label) {
+  endTimer(span, arg) {
     if (!this.enabled) return;
 
-    const startTime = this.currentTimers.get(label);
-    if (startTime === undefined) {
-      console.warn(`No timer started for: ${label}`);
+    const id = PerformanceProfiler.resolve(span);
+    if (id < 0) return;
+
+    if (!this.running[id]) {
+      console.warn(`No timer started for: ${PerformanceProfiler.spanLabels[id]}`);
       return;
     }
 
-    const duration = performance.now() - startTime;
-    this.currentTimers.delete(label);
-
-    if (!this.metrics.has(label)) {
-      this.metrics.set(label, {
-        count: 0,
-        total: 0,
-        min: Infinity,
-        max: -Infinity,
-        avg: 0,
-        recent: []
-      });
+    const start = this.starts[id];
+    const duration = performance.now() - start;
+    this.running[id] = 0;
+    this.depth = this.startDepths[id];
+
+    this.recordSpan(id, start, duration, this.depth, PerformanceProfiler.TRACK_MAIN, arg);
+  }
+
+  /**
+   * Record a duration measured elsewhere (e.g. in a worker)
+   * @param {number|string} span - Span id or label
+   * @param {number} duration - Duration in ms
+   * @param {number} start - Start time on this thread's performance.now() clock
+   * @param {number} track - PerformanceProfiler.TRACK_MAIN / TRACK_WORKER
+   */
+  record(span, duration, start = performance.now() - duration, track = PerformanceProfiler.TRACK_MAIN) {
+    if (!this.enabled) return;
+
+    const id = PerformanceProfiler.resolve(span);
+    if (id < 0) return;
+
+    this.recordSpan(id, start, duration, this.depth, track, undefined);
+  }
+
+  /**
+   * @private
+   */
+  recordSpan(id, start, duration, depth, track, arg) {
+    this.counts[id]++;
+    this.totals[id] += duration;
+    if (duration < this.mins[id]) this.mins[id] = duration;
+    if (duration > this.maxs[id]) this.maxs[id] = duration;
+
+    const history = PerformanceProfiler.HISTORY_SAMPLES;
+    const head = this.historyHead[id];
+    this.history[id * history + head] = duration;
+    this.historyHead[id] = head + 1 === history ? 0 : head + 1;
+
+    if (this.traceCapacity > 0) {
+      const slot = this.traceHead;
+      this.traceSpan[slot] = id;
+      this.traceStart[slot] = start;
+      this.traceDuration[slot] = duration;
+      this.traceFrame[slot] = this.frame;
+      this.traceDepth[slot] = depth;
+      this.traceTrack[slot] = track;
+      this.traceArgs[slot] = arg;
+      this.traceHead = slot + 1 === this.traceCapacity ? 0 : slot + 1;
+      if (this.traceSize < this.traceCapacity) this.traceSize++;
+    }
+
+    if (this.userTiming) {
+      performance.measure(PerformanceProfiler.spanLabels[id], { start, duration });
+    }
+
+    if (this.samples) {
+      this.samples.push([PerformanceProfiler.spanLabels[id], start, duration]);
+    }
+  }
+
+  /**
+   * Last n recorded durations of a span, oldest first
+   * @private
+   */
+  recentSamples(id, n) {
+    const history = PerformanceProfiler.HISTORY_SAMPLES;
+    const length = Math.min(n, this.counts[id], history);
+    const samples = new Float64Array(length);
+    let index = this.historyHead[id];
+    for (let i = length - 1; i >= 0; i--) {
+      index = index === 0 ? history - 1 : index - 1;
+      samples[i] = this.history[id * history + index];
     }
+    return samples;
+  }
+
+  /**
+   * Mean of the recent samples of one span
+   * @param {number|string} span
+   * @returns {number|null} null if nothing was recorded
+   */
+  getRecentAverage(span) {
+    const id = PerformanceProfiler.spanIds.get(span) ?? span;
+    if (typeof id !== 'number' || !this.counts[id]) return null;
+
+    const samples = this.recentSamples(id, PerformanceProfiler.RECENT_SAMPLES);
+    let sum = 0;
+    for (let i = 0; i < samples.length; i++) sum += samples[i];
+    return sum / samples.length;
+  }
 
-    const metric = this.metrics.get(label);
-    metric.count++;
-    metric.total += duration;
-    metric.min = Math.min(metric.min, duration);
-    metric.max = Math.max(metric.max, duration);
-    metric.avg = metric.total / metric.count;
-
-    // Keep last 30 samples for trend analysis
-    metric.recent.push(duration);
-    if (metric.recent.length > 30) {
-      metric.recent.shift();
+  /**
+   * Number of samples ever recorded for a span
+   * @param {number|string} span
+   * @returns {number}
+   */
+  getSampleCount(span) {
+    const id = PerformanceProfiler.spanIds.get(span) ?? span;
+    return typeof id === 'number' ? this.counts[id] || 0 : 0;
+  }
+
+  /**
+   * Length of the rolling window behind getRecentAverage
+   * @returns {number}
+   */
+  getWindowSize() {
+    return PerformanceProfiler.RECENT_SAMPLES;
+  }
+
+  /**
+   * Start collecting every duration recorded until takeSamples()
+   */
+  beginSamples() {
+    this.samples = [];
+  }
+
+  /**
+   * Stop collecting and return what was recorded since beginSamples()
+   * @returns {Object} {timeOrigin, spans: [[label, start, duration], ...]}
+   */
+  takeSamples() {
+    const spans = this.samples || [];
+    this.samples = null;
+    return { timeOrigin: performance.timeOrigin, spans };
+  }
+
+  /**
+   * Record samples taken by another thread's profiler (takeSamples output)
+   * @param {Object} samples
+   * @param {number} track - Trace track to show them on
+   */
+  recordSamples(samples, track = PerformanceProfiler.TRACK_WORKER) {
+    if (!this.enabled || !samples || !samples.spans) return;
+
+    // Shift the other thread's clock onto ours
+    const offset = (samples.timeOrigin || performance.timeOrigin) - performance.timeOrigin;
+    for (const [label, start, duration] of samples.spans) {
+      this.record(label, duration, start + offset, track);
     }
   }
 
@@ -63,20 +266,29 @@ class PerformanceProfiler {
    * @returns {Object} Metrics object
    */
   getMetrics() {
+    const round = (value) => Math.round(value * 100) / 100;
     const result = {};
-    for (const [label, data] of this.metrics.entries()) {
+
+    PerformanceProfiler.spanLabels.forEach((label, id) => {
+      const count = this.counts[id];
+      if (!count) return;
+
+      const recent = this.recentSamples(id, PerformanceProfiler.RECENT_SAMPLES);
+      const sorted = this.recentSamples(id, PerformanceProfiler.HISTORY_SAMPLES).sort();
+      const percentile = (p) => sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+
       result[label] = {
-        count: data.count,
-        avg: Math.round(data.avg * 100) / 100,
-        min: Math.round(data.min * 100) / 100,
-        max: Math.round(data.max * 100) / 100,
-        total: Math.round(data.total * 100) / 100,
-        recentAvg: data.recent.length > 0
-          ? Math.round((data.recent.reduce((a, b) => a + b, 0) /
-            data.recent.length) * 100) / 100
-          : 0
+        count,
+        avg: round(this.totals[id] / count),
+        min: round(this.mins[id]),
+        max: round(this.maxs[id]),
+        total: round(this.totals[id]),
+        recentAvg: round(recent.reduce((a, b) => a + b, 0) / recent.length),
+        p50: round(percentile(0.5)),
+        p95: round(percentile(0.95)),
+        p99: round(percentile(0.99))
       };
-    }
+    });
     return result;
   }
 
@@ -94,6 +306,9 @@ class PerformanceProfiler {
       report += `\n${label}:\n`;
       report += `  Avg: ${data.avg.toFixed(2)}ms `;
       report += `(Recent: ${data.recentAvg.toFixed(2)}ms)\n`;
+      report += `  p50: ${data.p50.toFixed(2)}ms | `;
+      report += `p95: ${data.p95.toFixed(2)}ms | `;
+      report += `p99: ${data.p99.toFixed(2)}ms\n`;
       report += `  Min: ${data.min.toFixed(2)}ms | `;
       report += `Max: ${data.max.toFixed(2)}ms\n`;
       report += `  Count: ${data.count} | `;
@@ -103,12 +318,80 @@ class PerformanceProfiler {
     return report;
   }
 
+  /**
+   * Trace events still in the ring buffer, oldest first
+   * @private
+   */
+  forEachTraceEvent(callback) {
+    const first = (this.traceHead - this.traceSize + this.traceCapacity) % this.traceCapacity;
+    for (let i = 0; i < this.traceSize; i++) {
+      callback((first + i) % this.traceCapacity);
+    }
+  }
+
+  /**
+   * Timeline of one frame
+   * @param {number} frame - Frame number (default: the last complete frame)
+   * @returns {Array<Object>} [{label, start, duration, depth, track, arg}] by start time
+   */
+  getFrameTrace(frame = this.frame - 1) {
+    const events = [];
+    this.forEachTraceEvent(slot => {
+      if (this.traceFrame[slot] !== frame) return;
+      events.push({
+        label: PerformanceProfiler.spanLabels[this.traceSpan[slot]],
+        start: this.traceStart[slot],
+        duration: this.traceDuration[slot],
+        depth: this.traceDepth[slot],
+        track: PerformanceProfiler.TRACK_NAMES[this.traceTrack[slot]],
+        arg: this.traceArgs[slot]
+      });
+    });
+    return events.sort((a, b) => a.start - b.start);
+  }
+
+  /**
+   * Trace buffer in Chrome trace-event format ("X" complete events, µs)
+   * @returns {Object} {traceEvents, displayTimeUnit}
+   */
+  toTraceEvents() {
+    const traceEvents = PerformanceProfiler.TRACK_NAMES.map((name, track) => ({
+      name: 'thread_name', ph: 'M', pid: 1, tid: track + 1, args: { name }
+    }));
+
+    this.forEachTraceEvent(slot => {
+      const args = { frame: this.traceFrame[slot] };
+      if (this.traceArgs[slot] !== undefined) args.detail = this.traceArgs[slot];
+
+      traceEvents.push({
+        name: PerformanceProfiler.spanLabels[this.traceSpan[slot]],
+        cat: 'tracker',
+        ph: 'X',
+        ts: Math.round(this.traceStart[slot] * 1000),
+        dur: Math.round(this.traceDuration[slot] * 1000),
+        pid: 1,
+        tid: this.traceTrack[slot] + 1,
+        args
+      });
+    });
+
+    return { traceEvents, displayTimeUnit: 'ms' };
+  }
+
   /**
    * Reset all metrics
    */
   reset() {
-    this.metrics.clear();
-    this.currentTimers.clear();
+    this.running.fill(0);
+    this.counts.fill(0);
+    this.totals.fill(0);
+    this.mins.fill(Infinity);
+    this.maxs.fill(-Infinity);
+    this.historyHead.fill(0);
+    this.traceArgs.fill(undefined);
+    this.traceHead = 0;
+    this.traceSize = 0;
+    this.depth = 0;
   }
 
   /**
@@ -120,6 +403,48 @@ class PerformanceProfiler {
   }
 }
 
+// Span registry shared by every profiler on this thread
+PerformanceProfiler.MAX_SPANS = 128;
+PerformanceProfiler.spanIds = new Map();
+PerformanceProfiler.spanLabels = [];
+
+// Samples kept per span: the recent window for trend analysis, and the
+// longer history percentiles are taken over
+PerformanceProfiler.RECENT_SAMPLES = 30;
+PerformanceProfiler.HISTORY_SAMPLES = 256;
+
+PerformanceProfiler.TRACK_MAIN = 0;
+PerformanceProfiler.TRACK_WORKER = 1;
+PerformanceProfiler.TRACK_NAMES = ['main', 'worker'];
+
+// Preregistered tracker spans (ids are stable for the life of the page)
+PerformanceProfiler.Span = {
+  FRAME_TOTAL: PerformanceProfiler.register('frame_total'),
+  CAPTURE_FRAME: PerformanceProfiler.register('capture_frame'),
+  CAPTURE_LUMA_COPY: PerformanceProfiler.register('capture_luma_copy'),
+  GRAY_CONVERSION: PerformanceProfiler.register('gray_conversion'),
+  DETECTION_TOTAL: PerformanceProfiler.register('detection_total'),
+  DETECTION_LATENCY: PerformanceProfiler.register('detection_latency'),
+  DETECTION_PROPAGATION: PerformanceProfiler.register('detection_propagation'),
+  DETECTION_TARGET: PerformanceProfiler.register('detection_target'),
+  DETECTION_REGION: PerformanceProfiler.register('detection_region'),
+  DETECT_FRAME_FEATURES: PerformanceProfiler.register('detect_frame_features'),
+  DETECT_GRAY_CONVERSION: PerformanceProfiler.register('detect_gray_conversion'),
+  DETECT_PREPROCESSING: PerformanceProfiler.register('detect_preprocessing'),
+  DETECT_KEYPOINTS: PerformanceProfiler.register('detect_keypoints'),
+  DETECT_LIMIT_FEATURES: PerformanceProfiler.register('detect_limit_features'),
+  DETECT_COMPUTE_DESCRIPTORS: PerformanceProfiler.register('detect_compute_descriptors'),
+  DETECT_KNN_MATCH: PerformanceProfiler.register('detect_knn_match'),
+  DETECT_FILTER_MATCHES: PerformanceProfiler.register('detect_filter_matches'),
+  DETECT_HOMOGRAPHY: PerformanceProfiler.register('detect_homography'),
+  VOCABULARY_CANDIDATE_SELECTION: PerformanceProfiler.register('vocabulary_candidate_selection'),
+  OPTICAL_FLOW_TRACKING: PerformanceProfiler.register('optical_flow_tracking'),
+  OPTICAL_FLOW_FALLBACK: PerformanceProfiler.register('optical_flow_fallback'),
+  VISUALIZATION: PerformanceProfiler.register('visualization'),
+  AR_RENDERING: PerformanceProfiler.register('ar_rendering'),
+  WORKER_ROUNDTRIP: PerformanceProfiler.register('worker_roundtrip')
+};
+
 // Make available globally
 if (typeof window !== 'undefined') {
   window.PerformanceProfiler = PerformanceProfiler;
@@ -134,6 +134,53 @@ class Visualizer {
         }
     }
 
+    /**
+     * Draw contour and flow points with the 2D canvas API
+     * Used when frames are processed in the vision worker and no Mat is
+     * available on the main thread; the camera image is not redrawn.
+     */
+    renderOverlay(trackingResult, canvas, flowPoints, flowStatus) {
+        const ctx = canvas ? canvas.getContext('2d') : null;
+        if (!ctx) return;
+
+        ctx.clearRect(0, 0, canvas.width, canvas.height);
+
+        const corners = trackingResult.success && trackingResult.corners ?
+            trackingResult.corners : null;
+
+        if (corners && corners.length === 4) {
+            ctx.strokeStyle = 'rgb(0, 255, 0)';
+            ctx.lineWidth = 3;
+            ctx.beginPath();
+            ctx.moveTo(corners[0].x, corners[0].y);
+            for (let i = 1; i < 4; i++) {
+                ctx.lineTo(corners[i].x, corners[i].y);
+            }
+            ctx.closePath();
+            ctx.stroke();
+        }
+
+        if (!flowPoints) return;
+
+        for (let i = 0; i < flowPoints.length; i++) {
+            const point = flowPoints[i];
+            if (!point) continue;
+
+            const isTracked = flowStatus && flowStatus.length > i && flowStatus[i] === 1;
+            if (!isTracked) {
+                ctx.fillStyle = 'rgb(255, 0, 0)'; // Red for lost points
+            } else if (corners && !this.isPointInPolygon(corners, point.x, point.y)) {
+                ctx.fillStyle = 'rgb(255, 255, 0)'; // Yellow if outside
+            } else {
+                ctx.fillStyle = 'rgb(0, 255, 0)'; // Green if inside
+            }
+
+            ctx.beginPath();
+            ctx.arc(point.x, point.y, 3, 0, Math.PI * 2);
+            ctx.fill();
+        }
+    }
+
     drawFlowPoints(frame, points, flowStatus, corners) {
         try {
             if (!points || points.length === 0) return;
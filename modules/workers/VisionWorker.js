@@ -0,0 +1,525 @@
+/**
+ * VisionWorker - Dedicated worker running detection and optical flow
+ *
+ * Owns a private OpenCV.js instance (selected through opencv_builds/loader.js)
+ * and a TrackingPipeline. The main thread transfers camera frames as
+ * VideoFrame/ImageBitmap and receives corners, scores and runtime status
+ * updates back, so rendering never waits on ORB+TEBLID.
+ *
+ * The same script runs in two roles, selected by the ?role= query:
+ *   tracking  (default) Full pipeline; spawns a detection worker when
+ *                       AppConfig.detection.pipelined is set
+ *   detection           Detector only; fed RGBA pixels by the tracking worker
+ *
+ * Protocol (main -> worker):
+ *   { type: 'targets', database }              Build runtime targets + vocabulary
+ *   { type: 'frame', frameId, source, width, height, settings }
+ *   { type: 'frame', frameId, pixels, width, height, channels, settings }
+ *   { type: 'reset' }                           Drop all tracking state
+ * Protocol (worker -> main):
+ *   { type: 'ready', buildInfo } | { type: 'error', message }
+ *   { type: 'targetsLoaded', count }
+ *   { type: 'result', frameId, width, height, results, statusUpdates, ... }
+ */
+
+// Builds usable from a worker. The threaded build is added when
+// AppConfig.opencv.workerThreads is set; loader.js points its pthreads at
+// opencv.js (they would otherwise start from this script's URL).
+const OPENCV_THREADED_WORKER_PATH = '../../opencv_builds/threadsSimd/opencv.js';
+const OPENCV_WORKER_PATHS = {
+  minimal: '../../opencv_builds/minimal/manifest.json',
+  simd: '../../opencv_builds/simd/opencv.js',
+  wasm: '../../opencv_builds/wasm/opencv.js'
+};
+
+// Module sources needed by the pipeline (already present in bundled builds)
+const VISION_WORKER_DEPENDENCIES = [
+  '../../config.js',
+  '../utils/Logger.js',
+  '../utils/PerformanceProfiler.js',
+  '../utils/MatPool.js',
+  '../database/FlatVocabularyTree.js',
+  '../database/VocabularyTreeQuery.js',
+  '../reference/ReferenceCache.js',
+  '../reference/ReferenceImageManager.js',
+  '../detection/BatchedMatcher.js',
+  '../detection/FeatureDetector.js',
+  '../tracking/OpticalFlowTracker.js',
+  '../core/TrackingPipeline.js',
+  'VisionWorkerClient.js'
+];
+
+class VisionWorker {
+  constructor(scope) {
+    this.scope = scope;
+    this.role = VisionWorker.getRole(scope);
+    this.isReady = false;
+
+    // Pipeline-facing state (mirrors the subset of ImageTracker.state it uses)
+    this.state = null;
+    this.profiler = null;
+    this.referenceManager = null;
+    this.detector = null;
+    this.opticalFlow = null;
+    this.pipeline = null;
+    this.vocabularyQuery = null;
+
+    // Background detection worker (tracking role, pipelined mode)
+    this.detectionClient = null;
+    this.backgroundCandidates = null;
+    this.backgroundTimings = null; // Detection worker samples awaiting the next reply
+
+    // Reused frame upload surface (drawImage fallback)
+    this.canvas = null;
+    this.context = null;
+
+    // Persistent grayscale capture buffers in the WASM heap
+    this.planeBuffer = null; // All planes of the last VideoFrame, luma first
+    this.lumaView = null; // Header over the luma rows of planeBuffer
+    this.grayFrame = null; // Grayscale frame at processing size
+    this.lumaCopyFailed = false;
+
+    // Runtime status updates collected during a frame
+    this.pendingStatus = [];
+
+    // Messages are held until OpenCV and the pipeline are up
+    this.ready = this.initialize();
+    this.scope.onmessage = (event) => this.handleMessage(event.data);
+  }
+
+  /**
+   * Load dependencies and OpenCV, then announce readiness
+   */
+  async initialize() {
+    try {
+      if (typeof TrackingPipeline === 'undefined') {
+        this.scope.importScripts(...VISION_WORKER_DEPENDENCIES);
+      }
+      this.scope.importScripts(
+        '../../opencv_builds/wasm-feature-detect.js',
+        '../../opencv_builds/loader.js'
+      );
+
+      const paths = { ...OPENCV_WORKER_PATHS };
+      if (AppConfig.opencv.workerThreads) {
+        paths.threadsSimd = OPENCV_THREADED_WORKER_PATH;
+      }
+
+      await new Promise((resolve, reject) => {
+        loadOpenCV(paths, resolve).catch(reject);
+      });
+
+      // Loader defines cv as a factory function or promise - resolve it
+      const cvModule = await (typeof cv === 'function' ? cv() : cv);
+      this.scope.cv = cvModule;
+      configureOpenCVThreads(cvModule, AppConfig.opencv.threads);
+
+      this.createPipeline();
+      this.isReady = true;
+
+      if (this.role === 'tracking' && AppConfig.detection.pipelined) {
+        this.startDetectionWorker();
+      }
+
+      this.post({ type: 'ready', buildInfo: this.scope.__opencvBuildInfo || null });
+    } catch (error) {
+      console.error('[VisionWorker] Initialization failed:', error);
+      this.post({ type: 'error', message: error.message || String(error) });
+    }
+  }
+
+  /**
+   * Create detector, optical flow and pipeline around worker-local state
+   */
+  createPipeline() {
+    this.state = {
+      isTracking: true,
+      frameCount: 0,
+      detectionInterval: AppConfig.detection.detectionInterval,
+      useOpticalFlow: true,
+      maxFeatures: AppConfig.orb.nfeatures,
+      pyramidLevels: AppConfig.orb.nlevels,
+      trackedTargets: new Map(),
+      activeVideoTarget: null
+    };
+
+    // Spans are forwarded with each result; the main thread keeps the trace
+    this.profiler = new PerformanceProfiler({ traceCapacity: 0 });
+    this.referenceManager = new ReferenceImageManager();
+    this.detector = new FeatureDetector(this.state, this.profiler, null);
+    this.opticalFlow = new OpticalFlowTracker(this.state);
+    this.pipeline = new TrackingPipeline(
+      this.state,
+      this.detector,
+      this.opticalFlow,
+      this.profiler,
+      {
+        onTargetStatus: (targetId, updates) => {
+          this.pendingStatus.push({ targetId, updates });
+        },
+        backgroundDetector: this.role === 'tracking' ? {
+          isAvailable: () => !!(this.detectionClient &&
+                                this.detectionClient.isReady &&
+                                this.detectionClient.hasTargets),
+          detect: (frame) => this.detectInBackground(frame)
+        } : null
+      }
+    );
+  }
+
+  /**
+   * Spawn the detection-role worker; until it is ready the pipeline keeps
+   * detecting synchronously
+   */
+  startDetectionWorker() {
+    // Nested workers are not available everywhere
+    if (typeof Worker === 'undefined') return;
+
+    try {
+      this.detectionClient = new VisionWorkerClient({
+        scriptUrl: VisionWorkerClient.roleUrl(this.scope.location.href, 'detection')
+      });
+      this.detectionClient.start().catch(error => this.disableDetectionWorker(error));
+    } catch (error) {
+      this.disableDetectionWorker(error);
+    }
+  }
+
+  disableDetectionWorker(error) {
+    if (!this.detectionClient) return;
+
+    console.warn('[VisionWorker] Background detection disabled:', error);
+    this.detectionClient.terminate();
+    this.detectionClient = null;
+  }
+
+  /**
+   * Run detection for a frame in the detection worker
+   * @param {cv.Mat} frame - RGBA frame (copied before this returns)
+   * @returns {Promise<Array>|null} Serialized detection results
+   */
+  detectInBackground(frame) {
+    const request = this.detectionClient.detectFrame(frame, {
+      maxFeatures: this.state.maxFeatures,
+      pyramidLevels: this.state.pyramidLevels
+    });
+    if (!request) return null;
+
+    return request.then(reply => {
+      if (reply.error) throw new Error(reply.error);
+      if (reply.candidates) this.backgroundCandidates = reply.candidates;
+      // Forwarded with the next frame's samples, so the governor sees detection cost
+      if (reply.timings) this.backgroundTimings = reply.timings;
+      return reply.results;
+    });
+  }
+
+  async handleMessage(message) {
+    if (!message || !message.type) return;
+
+    await this.ready;
+
+    switch (message.type) {
+      case 'targets':
+        if (this.isReady) this.loadTargets(message.database);
+        break;
+      case 'frame':
+        this.processFrame(message);
+        break;
+      case 'reset':
+        if (this.isReady) {
+          this.pipeline.reset();
+          this.pendingStatus = [];
+        }
+        break;
+      default:
+        console.warn('[VisionWorker] Unknown message type:', message.type);
+    }
+  }
+
+  /**
+   * Convert the serialized database into runtime targets and vocabulary
+   * @param {Object} database - Exported database (VocabularyBuilder format)
+   */
+  loadTargets(database) {
+    try {
+      this.pipeline.reset();
+      this.pendingStatus = [];
+      this.referenceManager.clearTargets();
+      this.referenceManager.loadFromDatabase(database);
+
+      const vocabulary = database.vocabulary;
+      if (vocabulary?.words && vocabulary?.idf_weights) {
+        this.vocabularyQuery = new VocabularyTreeQuery(
+          vocabulary.words,
+          vocabulary.idf_weights,
+          vocabulary.flat_tree || vocabulary.tree || null,
+          vocabulary.inverted_index || null
+        );
+        this.detector.setVocabularyQuery(this.vocabularyQuery);
+      }
+
+      if (this.detectionClient) {
+        const client = this.detectionClient;
+        client.start()
+          .then(() => client.loadTargets(database))
+          .catch(error => this.disableDetectionWorker(error));
+      }
+
+      this.post({ type: 'targetsLoaded', count: this.referenceManager.getTargets().length });
+    } catch (error) {
+      console.error('[VisionWorker] Failed to load targets:', error);
+      this.post({ type: 'error', message: error.message || String(error) });
+    }
+  }
+
+  /**
+   * Upload a transferred frame, run the pipeline and post results
+   */
+  async processFrame(message) {
+    const { frameId, source, pixels, width, height, channels, settings } = message;
+    let frame = null;
+    let ownsFrame = false;
+    const startTime = performance.now();
+
+    try {
+      if (!this.isReady) {
+        this.post({ type: 'result', frameId, width, height, results: [], statusUpdates: [] });
+        return;
+      }
+
+      this.applySettings(settings);
+
+      // Spans of this frame go back to the main thread's profiler; the
+      // detection role only times detection, frame_total is the tracker's
+      const detectionRole = this.role === 'detection';
+      this.profiler.beginSamples();
+      if (this.backgroundTimings) {
+        this.profiler.recordSamples(this.backgroundTimings, PerformanceProfiler.TRACK_WORKER);
+        this.backgroundTimings = null;
+      }
+      if (!detectionRole) this.profiler.startTimer(PerformanceProfiler.Span.FRAME_TOTAL);
+
+      if (source) {
+        // Grayscale buffer shared by detection and optical flow
+        frame = await this.captureGray(source, width, height);
+      } else {
+        frame = VisionWorker.wrapPixels(pixels, width, height, channels);
+        ownsFrame = true;
+      }
+
+      const targets = this.referenceManager.getTargets();
+      this.detector.candidateScores = null;
+      let results;
+      if (detectionRole) {
+        this.profiler.startTimer(PerformanceProfiler.Span.DETECTION_TOTAL);
+        results = this.detector.detectMultipleTargets(frame, targets);
+        this.profiler.endTimer(PerformanceProfiler.Span.DETECTION_TOTAL);
+      } else {
+        results = this.pipeline.processFrame(frame, targets);
+      }
+      this.referenceManager.trimReferenceCache();
+      if (!detectionRole) this.profiler.endTimer(PerformanceProfiler.Span.FRAME_TOTAL);
+
+      const statusUpdates = this.pendingStatus;
+      this.pendingStatus = [];
+
+      // Vocabulary ranking of a detection run in this frame or merged from the background
+      const candidates = this.detector.candidateScores || this.backgroundCandidates;
+      this.backgroundCandidates = null;
+
+      this.post({
+        type: 'result',
+        frameId,
+        width,
+        height,
+        results: results.map(result => VisionWorker.serializeResult(result)),
+        statusUpdates,
+        candidates,
+        frameCount: this.state.frameCount,
+        trackedTargetIds: this.pipeline.getTrackedTargetIds(),
+        poolStats: MatPool.shared().getStats(),
+        timings: this.profiler.takeSamples(),
+        processingTime: performance.now() - startTime
+      });
+    } catch (error) {
+      console.error('[VisionWorker] Frame processing failed:', error);
+      this.post({ type: 'result', frameId, width, height, results: [], statusUpdates: [], error: error.message });
+    } finally {
+      if (source && typeof source.close === 'function') {
+        source.close();
+      }
+      if (frame && ownsFrame) frame.delete();
+    }
+  }
+
+  /**
+   * Copy main-thread tunables into worker state
+   */
+  applySettings(settings = {}) {
+    const keys = ['activeVideoTarget', 'detectionInterval', 'useOpticalFlow', 'maxFeatures', 'pyramidLevels'];
+    for (const key of keys) {
+      if (settings[key] !== undefined) {
+        this.state[key] = settings[key];
+      }
+    }
+  }
+
+  /**
+   * Produce the grayscale processing frame for a transferred source.
+   * VideoFrames in a YUV format have their luma plane copied straight into
+   * the WASM heap; other sources go through the canvas and one color
+   * conversion.
+   * @returns {Promise<cv.Mat>} Borrowed Mat, valid until the next frame
+   */
+  async captureGray(source, width, height) {
+    if (!this.lumaCopyFailed && VisionWorker.hasLumaPlane(source)) {
+      try {
+        return await this.copyLuma(source, width, height);
+      } catch (error) {
+        console.warn('[VisionWorker] VideoFrame.copyTo failed, using canvas capture:', error);
+        this.lumaCopyFailed = true;
+      }
+    }
+
+    const rgba = this.uploadFrame(source, width, height);
+    this.grayFrame = VisionWorker.ensureMat(this.grayFrame, height, width, cv.CV_8UC1);
+    cv.cvtColor(rgba, this.grayFrame, cv.COLOR_RGBA2GRAY);
+    return this.grayFrame;
+  }
+
+  /**
+   * Copy a YUV VideoFrame into the persistent plane buffer and return its
+   * luma plane, resized to the processing size if needed
+   * @returns {Promise<cv.Mat>}
+   */
+  async copyLuma(source, width, height) {
+    const rect = source.visibleRect;
+    const lumaWidth = rect.width;
+    const lumaHeight = rect.height;
+
+    // Default copyTo layout packs planes tightly, luma first with stride = width
+    const rows = Math.ceil(source.allocationSize({ rect }) / lumaWidth);
+    if (!this.planeBuffer || this.planeBuffer.rows !== rows || this.planeBuffer.cols !== lumaWidth) {
+      if (this.lumaView) this.lumaView.delete();
+      if (this.planeBuffer) this.planeBuffer.delete();
+      this.planeBuffer = new cv.Mat(rows, lumaWidth, cv.CV_8UC1);
+      this.lumaView = this.planeBuffer.roi(new cv.Rect(0, 0, lumaWidth, lumaHeight));
+    }
+
+    this.profiler.startTimer(PerformanceProfiler.Span.CAPTURE_LUMA_COPY);
+    await source.copyTo(this.planeBuffer.data, { rect });
+    this.profiler.endTimer(PerformanceProfiler.Span.CAPTURE_LUMA_COPY);
+
+    if (lumaWidth === width && lumaHeight === height) {
+      return this.lumaView;
+    }
+
+    this.grayFrame = VisionWorker.ensureMat(this.grayFrame, height, width, cv.CV_8UC1);
+    cv.resize(this.lumaView, this.grayFrame, new cv.Size(width, height), 0, 0, cv.INTER_LINEAR);
+    return this.grayFrame;
+  }
+
+  /**
+   * Whether a source is a VideoFrame whose first plane is 8-bit luma
+   * @returns {boolean}
+   */
+  static hasLumaPlane(source) {
+    const lumaFormats = ['I420', 'I420A', 'I422', 'I422A', 'I444', 'I444A', 'NV12'];
+    return typeof VideoFrame !== 'undefined' &&
+           source instanceof VideoFrame &&
+           lumaFormats.includes(source.format);
+  }
+
+  /**
+   * Reuse a Mat if it already has the requested shape, else reallocate
+   * @returns {cv.Mat}
+   */
+  static ensureMat(mat, rows, cols, type) {
+    if (mat && mat.rows === rows && mat.cols === cols && mat.type() === type) {
+      return mat;
+    }
+    if (mat) mat.delete();
+    return new cv.Mat(rows, cols, type);
+  }
+
+  /**
+   * Draw a VideoFrame/ImageBitmap into the reusable OffscreenCanvas and read
+   * it into a scratch RGBA Mat
+   * @returns {cv.Mat} Borrowed Mat, valid until the next frame
+   */
+  uploadFrame(source, width, height) {
+    if (!this.canvas) {
+      this.canvas = new OffscreenCanvas(width, height);
+      this.context = this.canvas.getContext('2d', { willReadFrequently: true, alpha: false });
+    }
+    if (this.canvas.width !== width || this.canvas.height !== height) {
+      this.canvas.width = width;
+      this.canvas.height = height;
+    }
+
+    this.context.drawImage(source, 0, 0, width, height);
+    const imageData = this.context.getImageData(0, 0, width, height);
+
+    const rgba = MatPool.shared().scratch('capture_rgba');
+    rgba.create(height, width, cv.CV_8UC4);
+    rgba.data.set(imageData.data);
+    return rgba;
+  }
+
+  /**
+   * Wrap a transferred RGBA or grayscale buffer in a Mat
+   * @returns {cv.Mat}
+   */
+  static wrapPixels(pixels, width, height, channels = 4) {
+    const frame = new cv.Mat(height, width, channels === 1 ? cv.CV_8UC1 : cv.CV_8UC4);
+    frame.data.set(new Uint8Array(pixels));
+    return frame;
+  }
+
+  /**
+   * Worker role from the script URL query (?role=detection)
+   * @returns {string}
+   */
+  static getRole(scope) {
+    const search = scope && scope.location ? scope.location.search : '';
+    const role = new URLSearchParams(search).get('role');
+    return role === 'detection' ? 'detection' : 'tracking';
+  }
+
+  /**
+   * Strip OpenCV handles and heavy debug arrays so results can be cloned
+   * @param {Object} result - Detection or optical flow result
+   * @returns {Object}
+   */
+  static serializeResult(result) {
+    const toPoints = (points) => points
+      ? points.map(p => ({ x: p.x, y: p.y }))
+      : null;
+
+    return {
+      targetId: result.targetId,
+      targetLabel: result.targetLabel,
+      success: !!result.success,
+      reason: result.reason || null,
+      corners: toPoints(result.corners),
+      score: result.score ?? null,
+      matchesCount: result.matchesCount ?? null,
+      goodMatchesCount: result.goodMatchesCount ?? null,
+      trackingQuality: result.trackingQuality ?? null,
+      shouldRedetect: !!result.shouldRedetect,
+      prevFeaturePoints: toPoints(result.prevFeaturePoints),
+      nextFeaturePoints: toPoints(result.nextFeaturePoints),
+      flowStatus: result.flowStatus || null
+    };
+  }
+
+  post(message, transfer = []) {
+    this.scope.postMessage(message, transfer);
+  }
+}
+
+// Worker entry point
+if (typeof WorkerGlobalScope !== 'undefined' && self instanceof WorkerGlobalScope) {
+  self.visionWorker = new VisionWorker(self);
+}
@@ -0,0 +1,262 @@
+/**
+ * VisionWorkerClient - Main-thread proxy for VisionWorker
+ *
+ * Spawns the detection/tracking worker, forwards the target database once it
+ * is built, and submits one camera frame at a time. Frames are transferred
+ * (VideoFrame or ImageBitmap), never copied, and results arrive as plain
+ * serializable objects.
+ */
+class VisionWorkerClient {
+  constructor(options = {}) {
+    this.scriptUrl = options.scriptUrl || AppConfig.worker.scriptUrl;
+    this.initTimeout = options.initTimeout || AppConfig.worker.initTimeout;
+
+    this.worker = null;
+    this.isReady = false;
+    this.hasTargets = false;
+    this.buildInfo = null;
+
+    // Only one frame in flight; later frames are dropped rather than queued
+    this.busy = false;
+    this.nextFrameId = 1;
+    this.pendingFrame = null; // {frameId, resolve, reject}
+    this.pendingTargets = null; // {resolve, reject}
+    this.readyPromise = null;
+  }
+
+  /**
+   * Check browser support for the worker path
+   * @returns {boolean}
+   */
+  static isSupported() {
+    return typeof Worker !== 'undefined' &&
+           typeof OffscreenCanvas !== 'undefined' &&
+           (typeof VideoFrame !== 'undefined' || typeof createImageBitmap !== 'undefined');
+  }
+
+  /**
+   * Build the script URL for a worker role ('tracking' or 'detection')
+   * @param {string} scriptUrl - Base worker script URL
+   * @param {string} role
+   * @returns {string}
+   */
+  static roleUrl(scriptUrl, role) {
+    const base = String(scriptUrl).split('?')[0];
+    return role === 'tracking' ? base : `${base}?role=${role}`;
+  }
+
+  /**
+   * Start the worker and wait for its OpenCV instance
+   * @returns {Promise<Object>} Build info of the OpenCV variant loaded in the worker
+   */
+  start() {
+    if (this.readyPromise) return this.readyPromise;
+
+    this.readyPromise = new Promise((resolve, reject) => {
+      const timer = setTimeout(() => {
+        reject(new Error('Vision worker initialization timeout'));
+      }, this.initTimeout);
+
+      try {
+        this.worker = new Worker(this.scriptUrl);
+      } catch (error) {
+        clearTimeout(timer);
+        reject(error);
+        return;
+      }
+
+      this.worker.onmessage = (event) => {
+        const message = event.data;
+        if (message.type === 'ready') {
+          clearTimeout(timer);
+          this.isReady = true;
+          this.buildInfo = message.buildInfo;
+          console.log('[VisionWorkerClient] Worker ready:', message.buildInfo?.variant);
+          resolve(message.buildInfo);
+          return;
+        }
+        this.handleMessage(message, (error) => {
+          clearTimeout(timer);
+          reject(error);
+        });
+      };
+
+      this.worker.onerror = (event) => {
+        console.error('[VisionWorkerClient] Worker error:', event.message);
+        clearTimeout(timer);
+        const error = new Error(event.message || 'Vision worker error');
+        // A crash after startup leaves no worker to send frames to
+        this.isReady = false;
+        this.failPending(error);
+        reject(error);
+      };
+    });
+
+    return this.readyPromise;
+  }
+
+  /**
+   * Dispatch non-ready worker messages
+   * @private
+   */
+  handleMessage(message, onInitError) {
+    switch (message.type) {
+      case 'error':
+        console.error('[VisionWorkerClient] Worker reported error:', message.message);
+        if (!this.isReady) {
+          onInitError(new Error(message.message));
+        } else if (this.pendingTargets) {
+          this.pendingTargets.reject(new Error(message.message));
+          this.pendingTargets = null;
+        }
+        break;
+      case 'targetsLoaded':
+        this.hasTargets = true;
+        if (this.pendingTargets) {
+          this.pendingTargets.resolve(message.count);
+          this.pendingTargets = null;
+        }
+        break;
+      case 'result':
+        if (this.pendingFrame && this.pendingFrame.frameId === message.frameId) {
+          const pending = this.pendingFrame;
+          this.pendingFrame = null;
+          this.busy = false;
+          pending.resolve(message);
+        }
+        break;
+      default:
+        console.warn('[VisionWorkerClient] Unknown message type:', message.type);
+    }
+  }
+
+  /**
+   * Send the exported target database to the worker
+   * @param {Object} database - VocabularyBuilder export (targets + vocabulary)
+   * @returns {Promise<number>} Number of targets loaded in the worker
+   */
+  loadTargets(database) {
+    if (!this.worker) {
+      return Promise.reject(new Error('Vision worker not started'));
+    }
+
+    return new Promise((resolve, reject) => {
+      this.pendingTargets = { resolve, reject };
+      this.worker.postMessage({ type: 'targets', database: VisionWorkerClient.stripDatabase(database) });
+    });
+  }
+
+  /**
+   * Submit one frame for detection/tracking
+   * @param {{source: VideoFrame|ImageBitmap, width: number, height: number}} frame
+   * @param {Object} settings - Tracker tunables (activeVideoTarget, detectionInterval, ...)
+   * @returns {Promise<Object>|null} Result message, or null when a frame is already in flight
+   */
+  processFrame(frame, settings = {}) {
+    if (!this.isReady || !this.hasTargets || this.busy) {
+      if (frame?.source?.close) frame.source.close();
+      return null;
+    }
+
+    return this.submitFrame({
+      source: frame.source,
+      width: frame.width,
+      height: frame.height,
+      settings
+    }, [frame.source]);
+  }
+
+  /**
+   * Submit a Mat for detection (used by the tracking worker to feed the
+   * background detection worker). The pixels are copied once and the copy
+   * is transferred.
+   * @param {cv.Mat} frame - Grayscale or RGBA frame
+   * @param {Object} settings - Tracker tunables
+   * @returns {Promise<Object>|null} Result message, or null when busy
+   */
+  detectFrame(frame, settings = {}) {
+    if (!this.isReady || !this.hasTargets || this.busy) {
+      return null;
+    }
+
+    const byteLength = frame.rows * frame.cols * frame.channels();
+    const pixels = frame.data.slice(0, byteLength).buffer;
+    return this.submitFrame({
+      pixels,
+      width: frame.cols,
+      height: frame.rows,
+      channels: frame.channels(),
+      settings
+    }, [pixels]);
+  }
+
+  /**
+   * Post a frame message and wait for its result
+   * @private
+   */
+  submitFrame(payload, transfer) {
+    const frameId = this.nextFrameId++;
+    this.busy = true;
+
+    return new Promise((resolve, reject) => {
+      this.pendingFrame = { frameId, resolve, reject };
+      this.worker.postMessage({ type: 'frame', frameId, ...payload }, transfer);
+    });
+  }
+
+  /**
+   * Drop all tracking state in the worker (e.g. when tracking stops)
+   */
+  reset() {
+    if (this.worker) {
+      this.worker.postMessage({ type: 'reset' });
+    }
+  }
+
+  /**
+   * Reject any outstanding request
+   * @private
+   */
+  failPending(error) {
+    if (this.pendingFrame) {
+      this.pendingFrame.reject(error);
+      this.pendingFrame = null;
+    }
+    if (this.pendingTargets) {
+      this.pendingTargets.reject(error);
+      this.pendingTargets = null;
+    }
+    this.busy = false;
+  }
+
+  /**
+   * Remove main-thread-only fields (blob URLs) before cloning to the worker
+   * @param {Object} database
+   * @returns {Object}
+   */
+  static stripDatabase(database) {
+    return {
+      ...database,
+      targets: database.targets.map(({ videoUrl, ...target }) => target)
+    };
+  }
+
+  /**
+   * Terminate the worker
+   */
+  terminate() {
+    this.failPending(new Error('Vision worker terminated'));
+    if (this.worker) {
+      this.worker.terminate();
+      this.worker = null;
+    }
+    this.isReady = false;
+    this.hasTargets = false;
+    this.readyPromise = null;
+  }
+}
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.VisionWorkerClient = VisionWorkerClient;
+}
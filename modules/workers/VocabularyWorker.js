@@ -0,0 +1,178 @@
+/**
+ * VocabularyWorker - One member of the vocabulary build pool
+ *
+ * Runs on a dedicated Web Worker and serves two kinds of jobs for
+ * VocabularyBuilder (via VocabularyWorkerPool):
+ * - extract: ORB + TEBLID features for one grayscale target image
+ * - assign: the k-means assignment step for a slice of a descriptor
+ *   dataset. With cross-origin isolation the dataset and assignments live
+ *   in SharedArrayBuffers and are never copied after registration.
+ *
+ * OpenCV is loaded on the first extract job so clustering-only workers
+ * stay light.
+ */
+
+// Builds usable from a worker (the threaded build spawns its own pool)
+const OPENCV_WORKER_PATHS = {
+  minimal: '../../opencv_builds/minimal/manifest.json',
+  simd: '../../opencv_builds/simd/opencv.js',
+  wasm: '../../opencv_builds/wasm/opencv.js'
+};
+
+// Module sources needed by the build jobs (already present in bundled builds)
+const VOCABULARY_WORKER_DEPENDENCIES = [
+  '../../config.js',
+  '../database/VocabularyBuilder.js'
+];
+
+class VocabularyWorker {
+  constructor(scope) {
+    this.scope = scope;
+    this.builder = null;
+    this.opencvReady = null;
+    this.datasets = new Map(); // datasetId -> {descriptors, descriptorSize, assignments, shared}
+
+    this.ready = this.initialize();
+    this.scope.onmessage = (event) => this.handleMessage(event.data);
+  }
+
+  /**
+   * Load the builder sources and announce readiness
+   */
+  async initialize() {
+    try {
+      if (typeof VocabularyBuilder === 'undefined') {
+        this.scope.importScripts(...VOCABULARY_WORKER_DEPENDENCIES);
+      }
+
+      // Fixed parameters: the pool only runs extraction/assignment jobs
+      this.builder = new VocabularyBuilder({ adaptiveVocabulary: false });
+      this.post({ type: 'ready' });
+    } catch (error) {
+      console.error('[VocabularyWorker] Initialization failed:', error);
+      this.post({ type: 'error', message: error.message || String(error) });
+    }
+  }
+
+  /**
+   * Load OpenCV once, on first use
+   * @returns {Promise<void>}
+   */
+  ensureOpenCV() {
+    if (this.opencvReady) return this.opencvReady;
+
+    this.opencvReady = (async () => {
+      this.scope.importScripts(
+        '../../opencv_builds/wasm-feature-detect.js',
+        '../../opencv_builds/loader.js'
+      );
+
+      await new Promise((resolve, reject) => {
+        loadOpenCV(OPENCV_WORKER_PATHS, resolve).catch(reject);
+      });
+
+      // Loader defines cv as a factory function or promise - resolve it
+      this.scope.cv = await (typeof cv === 'function' ? cv() : cv);
+    })();
+
+    return this.opencvReady;
+  }
+
+  async handleMessage(message) {
+    await this.ready;
+
+    try {
+      switch (message.type) {
+        case 'extract':
+          await this.extract(message);
+          break;
+        case 'dataset':
+          this.registerDataset(message);
+          this.post({ type: 'result', jobId: message.jobId });
+          break;
+        case 'assign':
+          this.assign(message);
+          break;
+        case 'releaseDataset':
+          this.datasets.delete(message.datasetId);
+          break;
+        default:
+          console.warn('[VocabularyWorker] Unknown message type:', message.type);
+      }
+    } catch (error) {
+      this.post({ type: 'error', jobId: message.jobId, message: error.message || String(error) });
+    }
+  }
+
+  /**
+   * Extract features from one transferred grayscale image
+   */
+  async extract({ jobId, targetId, pixels, width, height }) {
+    await this.ensureOpenCV();
+
+    const imageMat = new cv.Mat(height, width, cv.CV_8UC1);
+    try {
+      imageMat.data.set(new Uint8Array(pixels));
+      const features = this.builder.extractFeatures(imageMat, targetId);
+      const transfer = features ? [features.descriptors.buffer, features.keypoints.buffer] : [];
+      this.post({ type: 'result', jobId, features }, transfer);
+    } finally {
+      imageMat.delete();
+    }
+  }
+
+  /**
+   * Keep a descriptor dataset for the assignment iterations of one k-means run
+   */
+  registerDataset({ datasetId, descriptors, descriptorSize, assignments }) {
+    const shared = typeof SharedArrayBuffer !== 'undefined' &&
+                   descriptors instanceof SharedArrayBuffer;
+    const data = new Uint8Array(descriptors);
+
+    this.datasets.set(datasetId, {
+      descriptors: data,
+      descriptorSize,
+      shared,
+      // Shared: the pool's assignment array. Otherwise a private copy that
+      // only this worker's slice is kept current in.
+      assignments: shared ? new Int32Array(assignments) : new Int32Array(data.length / descriptorSize)
+    });
+  }
+
+  /**
+   * Assignment step over [start, end)
+   */
+  assign({ jobId, datasetId, centers, k, start, end }) {
+    const dataset = this.datasets.get(datasetId);
+    if (!dataset) {
+      throw new Error(`Unknown dataset ${datasetId}`);
+    }
+
+    const changedCount = VocabularyBuilder.assignRange(
+      dataset.descriptors,
+      dataset.descriptorSize,
+      new Uint8Array(centers),
+      k,
+      dataset.assignments,
+      start,
+      end
+    );
+
+    if (dataset.shared) {
+      this.post({ type: 'result', jobId, changedCount });
+      return;
+    }
+
+    const slice = dataset.assignments.slice(start, end);
+    this.post({ type: 'result', jobId, changedCount, assignments: slice.buffer }, [slice.buffer]);
+  }
+
+  post(message, transfer = []) {
+    this.scope.postMessage(message, transfer);
+  }
+}
+
+// Worker entry point
+if (typeof WorkerGlobalScope !== 'undefined' && self instanceof WorkerGlobalScope) {
+  self.vocabularyWorker = new VocabularyWorker(self);
+}
@@ -0,0 +1,298 @@
+/**
+ * VocabularyWorkerPool - Main-thread pool of VocabularyWorker instances
+ *
+ * Used by VocabularyBuilder to build an album's vocabulary in parallel:
+ * target images are extracted one per worker, and each k-means assignment
+ * step is partitioned into contiguous descriptor ranges, one per worker.
+ * When the page is cross-origin isolated the descriptors and assignments
+ * are SharedArrayBuffers; otherwise each worker gets one copy of the
+ * dataset and returns its assignment range per iteration.
+ */
+class VocabularyWorkerPool {
+  constructor(options = {}) {
+    this.scriptUrl = options.scriptUrl || AppConfig.worker.vocabularyScriptUrl;
+    this.initTimeout = options.initTimeout || AppConfig.worker.initTimeout;
+    this.size = options.size || VocabularyWorkerPool.defaultSize();
+
+    this.workers = []; // [{worker, pending}]
+    this.jobs = new Map(); // jobId -> {resolve, reject, slot}
+    this.nextJobId = 1;
+    this.nextDatasetId = 1;
+    this.startPromise = null;
+  }
+
+  /**
+   * Check browser support for the pool
+   * @returns {boolean}
+   */
+  static isSupported() {
+    return typeof Worker !== 'undefined';
+  }
+
+  /**
+   * Whether descriptor buffers can be shared instead of copied
+   * @returns {boolean}
+   */
+  static canShareMemory() {
+    return typeof SharedArrayBuffer !== 'undefined' &&
+           typeof crossOriginIsolated !== 'undefined' && crossOriginIsolated === true;
+  }
+
+  /**
+   * Pool size from config, or one worker per spare core (capped)
+   * @returns {number}
+   */
+  static defaultSize() {
+    const configured = AppConfig.worker.vocabularyPoolSize;
+    if (configured > 0) return configured;
+
+    const cores = (typeof navigator !== 'undefined' && navigator.hardwareConcurrency) || 2;
+    return Math.max(1, Math.min(4, cores - 1));
+  }
+
+  /**
+   * Spawn the workers and wait until all of them are ready
+   * @returns {Promise<void>}
+   */
+  start() {
+    if (this.startPromise) return this.startPromise;
+
+    this.startPromise = Promise.all(
+      Array.from({ length: this.size }, () => this.spawnWorker())
+    ).then(() => {
+      console.log(`[VocabularyWorkerPool] ${this.size} workers ready` +
+        ` (shared memory: ${VocabularyWorkerPool.canShareMemory()})`);
+    });
+
+    return this.startPromise;
+  }
+
+  /**
+   * @private
+   */
+  spawnWorker() {
+    return new Promise((resolve, reject) => {
+      const timer = setTimeout(() => {
+        reject(new Error('Vocabulary worker initialization timeout'));
+      }, this.initTimeout);
+
+      let worker;
+      try {
+        worker = new Worker(this.scriptUrl);
+      } catch (error) {
+        clearTimeout(timer);
+        reject(error);
+        return;
+      }
+
+      const slot = { worker, pending: 0, ready: false };
+      this.workers.push(slot);
+
+      worker.onmessage = (event) => {
+        const message = event.data;
+        if (message.type === 'ready') {
+          clearTimeout(timer);
+          slot.ready = true;
+          resolve();
+          return;
+        }
+        if (!slot.ready && message.type === 'error') {
+          clearTimeout(timer);
+          reject(new Error(message.message));
+          return;
+        }
+        this.handleMessage(message);
+      };
+
+      worker.onerror = (event) => {
+        clearTimeout(timer);
+        const error = new Error(event.message || 'Vocabulary worker error');
+        this.failJobs(slot, error);
+        reject(error);
+      };
+    });
+  }
+
+  /**
+   * Resolve or reject the job a worker message belongs to
+   * @private
+   */
+  handleMessage(message) {
+    const job = this.jobs.get(message.jobId);
+    if (!job) return;
+
+    this.jobs.delete(message.jobId);
+    job.slot.pending--;
+
+    if (message.type === 'error') {
+      job.reject(new Error(message.message));
+    } else {
+      job.resolve(message);
+    }
+  }
+
+  /**
+   * Post a job to a worker and wait for its result
+   * @private
+   */
+  request(slot, message, transfer = []) {
+    const jobId = this.nextJobId++;
+    slot.pending++;
+
+    return new Promise((resolve, reject) => {
+      this.jobs.set(jobId, { resolve, reject, slot });
+      slot.worker.postMessage({ ...message, jobId }, transfer);
+    });
+  }
+
+  /**
+   * Least loaded worker
+   * @private
+   */
+  pickWorker() {
+    let best = this.workers[0];
+    for (const slot of this.workers) {
+      if (slot.pending < best.pending) best = slot;
+    }
+    return best;
+  }
+
+  /**
+   * Extract features for one target on a pool worker
+   * @param {cv.Mat} imageMat - Grayscale target image (not modified)
+   * @param {string} targetId
+   * @returns {Promise<Object|null>} Same shape as VocabularyBuilder.extractFeatures
+   */
+  async extractFeatures(imageMat, targetId) {
+    await this.start();
+
+    const pixels = imageMat.data.slice(0, imageMat.rows * imageMat.cols).buffer;
+    const reply = await this.request(this.pickWorker(), {
+      type: 'extract',
+      targetId,
+      pixels,
+      width: imageMat.cols,
+      height: imageMat.rows
+    }, [pixels]);
+
+    return reply.features || null;
+  }
+
+  /**
+   * Register a k-means descriptor dataset with every worker
+   * @param {Uint8Array} descriptorsFlat - Descriptors of one tree node
+   * @param {number} descriptorSize - Bytes per descriptor
+   * @returns {Promise<Object>} Dataset handle ({assignments} is kept current)
+   */
+  async createDataset(descriptorsFlat, descriptorSize) {
+    await this.start();
+
+    const n = descriptorsFlat.length / descriptorSize;
+    const shared = VocabularyWorkerPool.canShareMemory();
+
+    let descriptors = null;
+    let assignments;
+    if (shared) {
+      descriptors = new SharedArrayBuffer(descriptorsFlat.length);
+      new Uint8Array(descriptors).set(descriptorsFlat);
+      assignments = new Int32Array(new SharedArrayBuffer(n * 4));
+    } else {
+      assignments = new Int32Array(n);
+    }
+
+    // Fixed contiguous ranges: each worker owns the same slice every iteration
+    const ranges = [];
+    const chunk = Math.ceil(n / this.workers.length);
+    for (let w = 0; w < this.workers.length; w++) {
+      const start = w * chunk;
+      const end = Math.min(n, start + chunk);
+      if (start < end) ranges.push({ slot: this.workers[w], start, end });
+    }
+
+    const dataset = { id: this.nextDatasetId++, n, descriptorSize, shared, assignments, ranges };
+
+    await Promise.all(ranges.map(({ slot }) => this.request(slot, {
+      type: 'dataset',
+      datasetId: dataset.id,
+      // Non-shared: structured clone gives each worker its own copy
+      descriptors: shared ? descriptors : descriptorsFlat.buffer.slice(
+        descriptorsFlat.byteOffset, descriptorsFlat.byteOffset + descriptorsFlat.length
+      ),
+      descriptorSize,
+      assignments: shared ? assignments.buffer : null
+    })));
+
+    return dataset;
+  }
+
+  /**
+   * Run one assignment step across the pool
+   * @param {Object} dataset - From createDataset
+   * @param {Uint8Array} centersFlat - k packed centers
+   * @returns {Promise<number>} Number of changed assignments
+   */
+  async assign(dataset, centersFlat) {
+    const k = centersFlat.length / dataset.descriptorSize;
+    const replies = await Promise.all(dataset.ranges.map(({ slot, start, end }) => {
+      const centers = centersFlat.slice().buffer;
+      return this.request(slot, {
+        type: 'assign',
+        datasetId: dataset.id,
+        centers,
+        k,
+        start,
+        end
+      }, [centers]);
+    }));
+
+    let changedCount = 0;
+    replies.forEach((reply, i) => {
+      changedCount += reply.changedCount;
+      if (!dataset.shared) {
+        dataset.assignments.set(new Int32Array(reply.assignments), dataset.ranges[i].start);
+      }
+    });
+    return changedCount;
+  }
+
+  /**
+   * Let the workers drop a dataset
+   * @param {Object} dataset
+   */
+  releaseDataset(dataset) {
+    for (const { slot } of dataset.ranges) {
+      slot.worker.postMessage({ type: 'releaseDataset', datasetId: dataset.id });
+    }
+  }
+
+  /**
+   * Reject every job outstanding on a worker
+   * @private
+   */
+  failJobs(slot, error) {
+    for (const [jobId, job] of this.jobs) {
+      if (job.slot === slot) {
+        this.jobs.delete(jobId);
+        job.reject(error);
+      }
+    }
+    slot.pending = 0;
+  }
+
+  /**
+   * Terminate all workers
+   */
+  terminate() {
+    for (const slot of this.workers) {
+      this.failJobs(slot, new Error('Vocabulary worker pool terminated'));
+      slot.worker.terminate();
+    }
+    this.workers = [];
+    this.startPromise = null;
+  }
+}
+
+// Make available globally
+if (typeof window !== 'undefined') {
+  window.VocabularyWorkerPool = VocabularyWorkerPool;
+}
@@ -0,0 +1,68 @@
+#!/bin/bash
+# Reproducible minimal OpenCV.js build (SIMD, separate .wasm)
+#
+# Builds only the modules and bindings the tracker uses
+# (minimal/opencv_js.config.py) inside the emscripten/emsdk image, then
+# writes opencv_builds/minimal/{opencv.<hash>.js, opencv_js.<hash>.wasm,
+# manifest.json}. The glue and the wasm must match, so both carry the hash
+# and only the manifest is fetched uncached.
+# loader.js prefers this build when the manifest is present, compiles the
+# wasm with WebAssembly.compileStreaming and keeps it in Cache Storage.
+#
+# Usage: opencv_builds/build-minimal.sh   (needs docker and git)
+#        THREADS=1 opencv_builds/build-minimal.sh   (pthreads, needs cross-origin isolation)
+set -e
+
+OPENCV_VERSION="${OPENCV_VERSION:-4.12.0}"
+EMSDK_VERSION="${EMSDK_VERSION:-3.1.64}"
+THREADS="${THREADS:-0}"
+
+ROOT="$(cd "$(dirname "$0")" && pwd)"
+WORK="${WORK:-$ROOT/.minimal-build}"
+OUT="$ROOT/minimal"
+
+mkdir -p "$WORK"
+
+echo "Fetching OpenCV $OPENCV_VERSION..."
+for repo in opencv opencv_contrib; do
+  if [ ! -d "$WORK/$repo" ]; then
+    git clone --depth 1 --branch "$OPENCV_VERSION" "https://github.com/opencv/$repo.git" "$WORK/$repo"
+  fi
+done
+
+echo "Building with emsdk $EMSDK_VERSION..."
+cp "$OUT/opencv_js.config.py" "$WORK/opencv_js.config.py"
+BUILD_ARGS=(--build_wasm --simd --disable_single_file)
+THREADS_JSON=false
+if [ "$THREADS" = "1" ]; then
+  BUILD_ARGS+=(--threads) # PTHREAD_POOL_SIZE=4, matching loader.js
+  THREADS_JSON=true
+fi
+docker run --rm -u "$(id -u):$(id -g)" -v "$WORK":/src -w /src/opencv "emscripten/emsdk:$EMSDK_VERSION" \
+  emcmake python3 ./platforms/js/build_js.py /src/build \
+    "${BUILD_ARGS[@]}" \
+    --config /src/opencv_js.config.py \
+    --cmake_option="-DOPENCV_EXTRA_MODULES_PATH=/src/opencv_contrib/modules" \
+    --cmake_option="-DBUILD_LIST=core,imgproc,features2d,flann,calib3d,video,xfeatures2d,js" \
+    --build_flags="-s ENVIRONMENT=web,worker -s ALLOW_MEMORY_GROWTH=1"
+
+echo "Writing $OUT..."
+HASH="$(sha256sum "$WORK/build/bin/opencv_js.wasm" | cut -c1-12)"
+rm -f "$OUT"/opencv.*.js "$OUT"/opencv_js.*.wasm
+cp "$WORK/build/bin/opencv.js" "$OUT/opencv.$HASH.js"
+cp "$WORK/build/bin/opencv_js.wasm" "$OUT/opencv_js.$HASH.wasm"
+
+cat > "$OUT/manifest.json" <<EOF
+{
+  "opencv": "$OPENCV_VERSION",
+  "emsdk": "$EMSDK_VERSION",
+  "simd": true,
+  "threads": $THREADS_JSON,
+  "js": "opencv.$HASH.js",
+  "wasm": "opencv_js.$HASH.wasm",
+  "wasmBytes": $(stat -c %s "$WORK/build/bin/opencv_js.wasm")
+}
+EOF
+
+ls -l "$OUT"
+echo "✓ Done"
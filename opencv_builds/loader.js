@@ -1,3 +1,90 @@
+// Cache Storage bucket for the minimal build's wasm (keyed by hashed URL)
+const OPENCV_WASM_CACHE = 'opencv-wasm';
+
+/**
+ * Compile a wasm binary, keeping the bytes in Cache Storage
+ *
+ * Compiling with compileStreaming from a cached Response lets the engine
+ * reuse its own compiled-code cache on later starts (a WebAssembly.Module
+ * can no longer be stored in IndexedDB). Old builds are dropped from the
+ * cache when the hashed file name changes.
+ */
+async function compileCachedWasm(url) {
+    let cache = null;
+    try {
+        cache = typeof caches !== 'undefined' ? await caches.open(OPENCV_WASM_CACHE) : null;
+    } catch (error) {
+        cache = null; // Opaque origins / private mode
+    }
+
+    let response = cache ? await cache.match(url) : undefined;
+    let stored = Promise.resolve();
+    if (!response) {
+        response = await fetch(url);
+        if (!response.ok) {
+            throw new Error(`Failed to fetch ${url} (${response.status})`);
+        }
+        if (cache) {
+            stored = cache.keys()
+                .then(keys => Promise.all(keys.filter(key => key.url !== url).map(key => cache.delete(key))))
+                .then(() => cache.put(url, response.clone()))
+                .catch(error => console.warn('[OpenCV] Could not cache wasm:', error));
+        }
+    }
+
+    let wasmModule;
+    const isWasmType = (response.headers.get('content-type') || '').startsWith('application/wasm');
+    if (WebAssembly.compileStreaming && isWasmType) {
+        wasmModule = await WebAssembly.compileStreaming(response);
+    } else {
+        wasmModule = await WebAssembly.compile(await response.arrayBuffer());
+    }
+    await stored;
+    return wasmModule;
+}
+
+/**
+ * Prepare the minimal build described by its manifest
+ *
+ * Installs Module.instantiateWasm so opencv.js instantiates the module
+ * compiled here instead of fetching and compiling the wasm itself.
+ * @returns {Promise<Object|null>} {url, manifest}, or null when the build is
+ *   missing or unusable in this browser
+ */
+async function prepareMinimalOpenCV(manifestUrl, simdSupported, threadsSupported) {
+    const base = new URL(manifestUrl, typeof location !== 'undefined' ? location.href : undefined);
+
+    let manifest;
+    try {
+        const response = await fetch(base.href, { cache: 'no-cache' });
+        if (!response.ok) return null;
+        manifest = await response.json();
+    } catch (error) {
+        return null;
+    }
+
+    if ((manifest.simd && !simdSupported) || (manifest.threads && !threadsSupported)) {
+        return null;
+    }
+
+    const wasmUrl = new URL(manifest.wasm, base).href;
+    const startedAt = performance.now();
+    const wasmModule = await compileCachedWasm(wasmUrl);
+    console.log(`[OpenCV] Minimal build compiled in ${(performance.now() - startedAt).toFixed(0)}ms`);
+
+    const globalScope = typeof window !== 'undefined' ? window : globalThis;
+    globalScope.Module = Object.assign(globalScope.Module || {}, {
+        instantiateWasm(imports, receiveInstance) {
+            WebAssembly.instantiate(wasmModule, imports)
+                .then(instance => receiveInstance(instance, wasmModule))
+                .catch(error => console.error('[OpenCV] Minimal build instantiation failed:', error));
+            return {}; // Exports arrive asynchronously through receiveInstance
+        }
+    });
+
+    return { url: new URL(manifest.js, base).href, manifest };
+}
+
 async function loadOpenCV(paths, onloadCallback) {
     let OPENCV_URL = "";
     let selectedVariant = "unknown";
@@ -45,7 +132,22 @@ async function loadOpenCV(paths, onloadCallback) {
     let simdSupported = wasmSupported ? await wasmFeatureDetect.simd() : false;
     let threadsSupported = wasmSupported ? await wasmFeatureDetect.threads() : false;
 
-    if (simdSupported && threadsSupported && threadsSimdPath != "") {
+    // Trimmed build from build-minimal.sh, when deployed
+    let minimalBuild = null;
+    if (wasmSupported && paths.minimal) {
+        try {
+            minimalBuild = await prepareMinimalOpenCV(paths.minimal, simdSupported, threadsSupported);
+        } catch (error) {
+            console.warn('[OpenCV] Minimal build unavailable, using full builds:', error);
+        }
+    }
+
+    if (minimalBuild) {
+        OPENCV_URL = minimalBuild.url;
+        selectedVariant = minimalBuild.manifest.threads ? "minimal-threads+simd" : "minimal-simd";
+        selectedPathKey = "minimal";
+        console.log("The minimal OpenCV.js build is loaded now");
+    } else if (simdSupported && threadsSupported && threadsSimdPath != "") {
         OPENCV_URL = threadsSimdPath;
         selectedVariant = "threads+simd";
         selectedPathKey = "threadsSimd";
@@ -99,6 +201,7 @@ async function loadOpenCV(paths, onloadCallback) {
     }
 
     const buildsAvailable = {
+        minimal: !!minimalBuild,
         asm: asmPath !== "",
         wasm: wasmPath !== "",
         simd: simdPath !== "",
@@ -122,6 +225,25 @@ async function loadOpenCV(paths, onloadCallback) {
         globalScope.__opencvBuildInfo = buildDetails;
     }
 
+    // Inside a Web Worker there is no DOM: load the build synchronously
+    if (typeof document === 'undefined' && typeof importScripts === 'function') {
+        // pthreads are started from the page's script by default, which in a
+        // worker is the worker's own script - point them at opencv.js instead
+        if (selectedVariant.indexOf('threads') !== -1) {
+            globalScope.Module = Object.assign(globalScope.Module || {}, {
+                mainScriptUrlOrBlob: new URL(OPENCV_URL, location.href).href
+            });
+        }
+        try {
+            importScripts(OPENCV_URL);
+        } catch (error) {
+            console.log('Failed to load opencv.js');
+            throw error;
+        }
+        onloadCallback();
+        return;
+    }
+
     let script = document.createElement('script');
     script.setAttribute('async', '');
     script.setAttribute('type', 'text/javascript');
@@ -136,4 +258,41 @@ async function loadOpenCV(paths, onloadCallback) {
     if (node.src != OPENCV_URL) {
         node.parentNode.insertBefore(script, node);
     }
-}
\ No newline at end of file
+}
+
+// pthread pool size the threaded builds are compiled with (PTHREAD_POOL_SIZE)
+const OPENCV_PTHREAD_POOL_SIZE = 4;
+
+/**
+ * Thread count for OpenCV's parallel_for_ on a threaded build
+ *
+ * requested > 0 is used as is (capped at the pool size); 0 picks one thread
+ * per core, leaving one core for the page. Builds that bind setNumThreads
+ * (the minimal build) apply it; the prebuilt ones run on their fixed pool.
+ * @returns {number} Threads OpenCV will use
+ */
+function configureOpenCVThreads(cvModule, requested = 0) {
+    const globalScope = typeof window !== 'undefined' ? window : globalThis;
+    const buildInfo = globalScope.__opencvBuildInfo || {};
+    const threaded = (buildInfo.variant || '').indexOf('threads') !== -1;
+
+    let threads = 1;
+    let applied = false;
+    if (threaded) {
+        const cores = (typeof navigator !== 'undefined' && navigator.hardwareConcurrency) || OPENCV_PTHREAD_POOL_SIZE;
+        threads = requested > 0 ? requested : Math.max(1, cores - 1);
+        threads = Math.min(threads, OPENCV_PTHREAD_POOL_SIZE);
+
+        if (typeof cvModule.setNumThreads === 'function') {
+            cvModule.setNumThreads(threads);
+            applied = true;
+        } else {
+            // OpenCV defaults to one stripe per core, run on the fixed pool
+            threads = Math.min(cores, OPENCV_PTHREAD_POOL_SIZE);
+        }
+    }
+
+    buildInfo.threads = { count: threads, applied, poolSize: threaded ? OPENCV_PTHREAD_POOL_SIZE : 0 };
+    console.log(`[OpenCV] ${threads} thread(s)` + (threaded && !applied ? ' (fixed by the build)' : ''));
+    return threads;
+}
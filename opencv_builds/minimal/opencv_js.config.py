@@ -0,0 +1,65 @@
+# Binding whitelist for the minimal OpenCV.js build (see ../build-minimal.sh)
+#
+# Only what the tracker calls. Mat / MatVector / KeyPointVector / DMatch*
+# helpers, Size, Point, Scalar, TermCriteria and imshow/matFromArray come
+# from core_bindings.cpp and helpers.js and are always present.
+#
+# Adding a cv.* call to the app means adding it here and rebuilding.
+
+core = {
+    '': [
+        'getNumThreads',
+        'mean',
+        'perspectiveTransform',
+        'setNumThreads',
+        'vconcat',
+    ],
+}
+
+imgproc = {
+    '': [
+        'GaussianBlur',
+        'circle',
+        'cvtColor',
+        'drawContours',
+        'fillPoly',
+        'getPerspectiveTransform',
+        'goodFeaturesToTrack',
+        'putText',
+        'resize',
+    ],
+    'CLAHE': ['apply', 'setClipLimit', 'setTilesGridSize', 'collectGarbage'],
+}
+
+features2d = {
+    'Feature2D': ['detect', 'compute', 'detectAndCompute', 'descriptorSize', 'descriptorType', 'defaultNorm', 'empty'],
+    'ORB': [
+        'create',
+        'setMaxFeatures',
+        'setNLevels',
+        'setFastThreshold',
+        'setScaleFactor',
+        'setEdgeThreshold',
+        'setFirstLevel',
+        'setWTA_K',
+        'setScoreType',
+        'setPatchSize',
+        'getDefaultName',
+    ],
+    'DescriptorMatcher': ['add', 'clear', 'empty', 'isMaskSupported', 'train', 'match', 'knnMatch', 'radiusMatch'],
+    'BFMatcher': ['isMaskSupported', 'create'],
+}
+
+calib3d = {
+    '': ['findHomography'],
+}
+
+video = {
+    '': ['calcOpticalFlowPyrLK'],
+}
+
+xfeatures2d = {
+    'TEBLID': ['create', 'getDefaultName'],
+}
+
+white_list = makeWhiteList([core, imgproc, features2d, calib3d, video, xfeatures2d])
@@ -0,0 +1,102 @@
+/**
+ * Service worker - serves cached album files from Cache Storage
+ *
+ * AlbumContentCache stores every album file under album-cache/<key>/<name>
+ * in the cache "webar-album-<key>". Requests for those URLs are answered
+ * here, with 206 partial responses for Range requests, so a <video> element
+ * streams a cached video from disk the same way it would from a server.
+ * Every other request goes to the network untouched.
+ */
+
+const ALBUM_CACHE_PREFIX = 'webar-album-'; // AlbumContentCache.CACHE_PREFIX
+const ALBUM_PATH = new URL('album-cache/', self.registration.scope).pathname; // AlbumContentCache.PATH
+
+self.addEventListener('install', () => {
+  self.skipWaiting();
+});
+
+self.addEventListener('activate', (event) => {
+  // Control the page that registered us, so this visit can stream already
+  event.waitUntil(self.clients.claim());
+});
+
+self.addEventListener('fetch', (event) => {
+  const url = new URL(event.request.url);
+  if (event.request.method !== 'GET' || url.origin !== self.location.origin ||
+      !url.pathname.startsWith(ALBUM_PATH)) {
+    return;
+  }
+  event.respondWith(serveAlbumEntry(event.request, url));
+});
+
+/**
+ * @param {Request} request
+ * @param {URL} url
+ * @returns {Promise<Response>}
+ */
+async function serveAlbumEntry(request, url) {
+  const key = url.pathname.slice(ALBUM_PATH.length).split('/')[0];
+  const cache = await caches.open(ALBUM_CACHE_PREFIX + key);
+  const cached = await cache.match(url.origin + url.pathname);
+  if (!cached) {
+    return new Response('Not in album cache', { status: 404 });
+  }
+
+  const type = cached.headers.get('Content-Type') || 'application/octet-stream';
+  const blob = await cached.blob(); // Disk-backed; slices are not read yet
+  const range = parseRange(request.headers.get('Range'), blob.size);
+
+  if (range === null) {
+    return new Response(blob, {
+      status: 200,
+      headers: {
+        'Content-Type': type,
+        'Content-Length': String(blob.size),
+        'Accept-Ranges': 'bytes'
+      }
+    });
+  }
+  if (!range) {
+    return new Response(null, {
+      status: 416,
+      headers: { 'Content-Range': `bytes */${blob.size}` }
+    });
+  }
+
+  const [start, end] = range;
+  return new Response(blob.slice(start, end + 1), {
+    status: 206,
+    headers: {
+      'Content-Type': type,
+      'Content-Length': String(end - start + 1),
+      'Content-Range': `bytes ${start}-${end}/${blob.size}`,
+      'Accept-Ranges': 'bytes'
+    }
+  });
+}
+
+/**
+ * Single byte range of a Range header
+ * @param {string|null} header - e.g. "bytes=0-", "bytes=100-199", "bytes=-500"
+ * @param {number} size
+ * @returns {Array<number>|null|false} [start, end] inclusive; null without a
+ *   usable header (full response), false when unsatisfiable
+ */
+function parseRange(header, size) {
+  const match = header && /^bytes=(\d*)-(\d*)$/.exec(header.trim());
+  if (!match || (match[1] === '' && match[2] === '')) return null;
+
+  let start;
+  let end;
+  if (match[1] === '') {
+    // Suffix range: the last N bytes
+    start = Math.max(0, size - parseInt(match[2], 10));
+    end = size - 1;
+  } else {
+    start = parseInt(match[1], 10);
+    end = match[2] === '' ? size - 1 : Math.min(parseInt(match[2], 10), size - 1);
+  }
+
+  if (start >= size || start > end) return false;
+  return [start, end];
+}